@@ -0,0 +1,206 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "benchmark.h"
+
+/* Compara dois tempos para o qsort. */
+static int compareDurations(const void *first, const void *second) {
+    double a = *(const double *)first, b = *(const double *)second;
+    return (a > b) - (a < b);
+}//compareDurations()
+
+/* Executa o caso 'benchmark' no pool 'pool', com benchmark->config.numberOfThreads workers, e preenche as suas medidas.
+   'samples' tem espaço para benchmark->config.repetitions tempos.
+*/
+static void runBenchmarkCase(BenchmarkCase *benchmark, ThreadPool *pool, double *samples) {
+    const Config *config = &benchmark->config;
+    TermRange chunks = {0, countChunks(config)};
+    for (unsigned int i = 0; i < config->warmup; i++) {
+        sumSeries(config, pool, chunks, NULL);
+    }
+    PiResult result = {0};
+    for (unsigned int i = 0; i < config->repetitions; i++) {
+        struct timespec startTime, endTime;
+        clock_gettime(DURATION_CLOCK, &startTime);
+        result = seriesResult(config, sumSeries(config, pool, chunks, NULL));
+        clock_gettime(DURATION_CLOCK, &endTime);
+        samples[i] = calculateDuration(startTime, endTime);
+    }
+    qsort(samples, config->repetitions, sizeof(double), compareDurations);
+
+    unsigned int middle = config->repetitions / 2;
+    benchmark->median = config->repetitions % 2 == 1 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2.0;
+    // Percentil pelo posto mais próximo: o menor tempo que cobre BENCHMARK_PERCENTILE das repetições.
+    unsigned int rank = (unsigned int)ceil(BENCHMARK_PERCENTILE * config->repetitions);
+    benchmark->percentile = samples[rank > 0 ? rank - 1 : 0];
+    benchmark->throughput = benchmark->median > 0.0 ? config->numberOfTerms / (benchmark->median * config->numberOfThreads) : 0.0;
+    benchmark->efficiency = -1.0;
+    benchmark->error = fabs(result.pi - M_PI);
+    benchmark->estimate = result.pi;
+}//runBenchmarkCase()
+
+/* Escreve a linha do caso 'benchmark' na saída padrão e, se 'writer' não for NULL, o seu registro no relatório estruturado. */
+static void reportBenchmarkCase(const BenchmarkCase *benchmark, Writer *writer) {
+    const Config *config = &benchmark->config;
+    char efficiency[BENCHMARK_EFFICIENCY_SIZE];
+    if (benchmark->efficiency < 0.0) {
+        snprintf(efficiency, sizeof(efficiency), BENCHMARK_NO_EFFICIENCY);
+    }
+    else {
+        snprintf(efficiency, sizeof(efficiency), BENCHMARK_EFFICIENCY, 100.0 * benchmark->efficiency);
+    }
+    printf(BENCHMARK_SUITE_ROW, config->numberOfThreads, kernelName(config->kernel), summationName(config->summation),
+           accelerationName(config->acceleration), config->numberOfTerms, benchmark->median, benchmark->percentile,
+           benchmark->throughput, efficiency, benchmark->error);
+    if (writer != NULL) {
+        writerPrintf(writer, writer->format == REPORT_CSV ? CSV_BENCHMARK : JSON_BENCHMARK, benchmark->section,
+                     seriesName(config->series), config->numberOfThreads, kernelName(config->kernel), summationName(config->summation),
+                     accelerationName(config->acceleration), config->numberOfTerms, config->repetitions, benchmark->median,
+                     benchmark->percentile, benchmark->throughput, benchmark->efficiency, benchmark->error);
+    }
+}//reportBenchmarkCase()
+
+/* Prepara em 'benchmark' o caso da seção 'section' a partir da configuração 'config'. */
+static void initBenchmarkCase(BenchmarkCase *benchmark, const char *section, const Config *config) {
+    benchmark->section = section;
+    benchmark->config = *config;
+    // Os casos medem o cálculo: nada é lido de um checkpoint ou de um cache.
+    benchmark->config.checkpoint = NULL;
+    benchmark->config.cache = NULL;
+    benchmark->config.stream = NULL;
+}//initBenchmarkCase()
+
+/* Executa a bateria de benchmarks com a configuração 'config': varre o número de threads (1, 2, 4, ... até config->numberOfThreads),
+   os kernels suportados e as acelerações, as estratégias de soma e o número de termos (n/100, n/10 e n). Cada caso é executado
+   config->warmup vezes sem medição e config->repetitions vezes medidas; escreve a mediana e o p95 do tempo, a vazão por núcleo,
+   a eficiência paralela e o erro, e grava um registro por caso em config->reportFile, se houver. Na série de Leibniz, valida
+   a estimativa de cada kernel contra a do kernel escalar com a tolerância BENCHMARK_TOLERANCE e compara as vazões.
+   Retorna TRUE se a bateria terminou e todos os kernels conferem, ou FALSE se algum kernel diverge ou o relatório
+   estruturado não pôde ser gravado.
+*/
+int benchmarkSuite(const Config *config) {
+    Writer *writer = NULL;
+    if (config->reportFile != NULL) {
+        writer = openWriter(config->reportFile, config->reportFormat, CSV_BENCHMARK_HEADER);
+        if (writer == NULL) {
+            return FALSE;
+        }
+    }
+    double *samples = (double *)malloc(config->repetitions * sizeof(double));
+    int *placement = createPlacement(config, 1, 0);
+    if (placement == NULL && config->affinity != AFFINITY_NONE) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    if (samples == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    unsigned int maximum = config->numberOfThreads;
+    BenchmarkCase benchmark;
+
+    printf(BENCHMARK_SUITE_TITLE, seriesName(config->series), maximum, config->repetitions, config->warmup);
+    printf(BENCHMARK_SECTION_THREADS, config->numberOfTerms);
+    printf(BENCHMARK_SUITE_HEADER, BENCHMARK_SUITE_COLUMNS);
+    double single = 0.0;
+    for (unsigned int threads = 1; ; threads = threads * 2 < maximum ? threads * 2 : maximum) {
+        ThreadPool *pool = createThreadPool(threads, placement);
+        if (pool == NULL) {
+            perror(ERROR_THREAD_POOL);
+            exit(EXIT_FAILURE);
+        }
+        initBenchmarkCase(&benchmark, BENCHMARK_THREADS, config);
+        benchmark.config.numberOfThreads = threads;
+        runBenchmarkCase(&benchmark, pool, samples);
+        destroyThreadPool(pool);
+        // Eficiência paralela: o tempo de 1 thread dividido pelo trabalho total das 'threads' threads.
+        if (threads == 1) {
+            single = benchmark.median;
+        }
+        benchmark.efficiency = benchmark.median > 0.0 ? single / (threads * benchmark.median) : 0.0;
+        reportBenchmarkCase(&benchmark, writer);
+        if (threads == maximum) {
+            break;
+        }
+    }
+
+    // As demais seções usam todas as threads.
+    ThreadPool *pool = createThreadPool(maximum, placement);
+    if (pool == NULL) {
+        perror(ERROR_THREAD_POOL);
+        exit(EXIT_FAILURE);
+    }
+    printf(BENCHMARK_SECTION_KERNELS, config->numberOfTerms, maximum);
+    printf(BENCHMARK_SUITE_HEADER, BENCHMARK_SUITE_COLUMNS);
+    // Só a série de Leibniz tem kernels vetoriais e aceleração; as outras usam o kernel escalar.
+    BenchmarkCase kernels[NUMBER_OF_KERNELS];
+    int measured[NUMBER_OF_KERNELS] = {FALSE};
+    for (KernelType kernel = KERNEL_SCALAR; kernel < NUMBER_OF_KERNELS; kernel++) {
+        if (!kernelSupported(kernel) || (config->series != SERIES_LEIBNIZ && kernel != KERNEL_SCALAR)) {
+            continue;
+        }
+        initBenchmarkCase(&benchmark, BENCHMARK_KERNELS, config);
+        benchmark.config.kernel = kernel;
+        benchmark.config.acceleration = ACCELERATION_NONE;
+        runBenchmarkCase(&benchmark, pool, samples);
+        reportBenchmarkCase(&benchmark, writer);
+        kernels[kernel] = benchmark;
+        measured[kernel] = TRUE;
+    }
+    for (AccelerationMode acceleration = ACCELERATION_TAIL; config->series == SERIES_LEIBNIZ && acceleration < NUMBER_OF_ACCELERATIONS; acceleration++) {
+        initBenchmarkCase(&benchmark, BENCHMARK_KERNELS, config);
+        benchmark.config.acceleration = acceleration;
+        runBenchmarkCase(&benchmark, pool, samples);
+        reportBenchmarkCase(&benchmark, writer);
+    }
+
+    // Um kernel confere se a sua estimativa difere da do kernel escalar em até BENCHMARK_TOLERANCE. Comparar as estimativas
+    // arredondadas para texto falharia quando as duas ficam em lados opostos de um limite de arredondamento.
+    int valid = TRUE;
+    if (config->series == SERIES_LEIBNIZ) {
+        double tolerance = BENCHMARK_TOLERANCE;
+        printf(BENCHMARK_SECTION_VALIDATION, tolerance, DECIMAL_PLACES);
+        printf(BENCHMARK_VALIDATION_HEADER, BENCHMARK_VALIDATION_COLUMNS);
+        for (KernelType kernel = KERNEL_SCALAR; kernel < NUMBER_OF_KERNELS; kernel++) {
+            if (!measured[kernel]) {
+                continue;
+            }
+            char estimate[BENCHMARK_ESTIMATE_SIZE];
+            snprintf(estimate, sizeof(estimate), "%.*lf", DECIMAL_PLACES, kernels[kernel].estimate);
+            int matches = fabs(kernels[kernel].estimate - kernels[KERNEL_SCALAR].estimate) <= tolerance;
+            valid = valid && matches;
+            double ratio = kernels[KERNEL_SCALAR].throughput > 0.0 ? kernels[kernel].throughput / kernels[KERNEL_SCALAR].throughput : 0.0;
+            printf(BENCHMARK_VALIDATION_ROW, kernelName(kernel), estimate, matches ? BENCHMARK_VALID : BENCHMARK_INVALID,
+                   kernels[kernel].throughput, ratio);
+        }
+    }
+
+    printf(BENCHMARK_SECTION_SUMMATIONS, config->numberOfTerms, maximum);
+    printf(BENCHMARK_SUITE_HEADER, BENCHMARK_SUITE_COLUMNS);
+    for (SummationMode summation = 0; summation < NUMBER_OF_SUMMATIONS; summation++) {
+        initBenchmarkCase(&benchmark, BENCHMARK_SUMMATIONS, config);
+        benchmark.config.summation = summation;
+        runBenchmarkCase(&benchmark, pool, samples);
+        reportBenchmarkCase(&benchmark, writer);
+    }
+
+    printf(BENCHMARK_SECTION_TERMS, maximum);
+    printf(BENCHMARK_SUITE_HEADER, BENCHMARK_SUITE_COLUMNS);
+    static const unsigned long long divisors[NUMBER_OF_BENCHMARK_TERM_DIVISORS] = BENCHMARK_TERM_DIVISORS;
+    for (unsigned int i = 0; i < NUMBER_OF_BENCHMARK_TERM_DIVISORS; i++) {
+        if (config->numberOfTerms / divisors[i] == 0) {
+            continue;
+        }
+        initBenchmarkCase(&benchmark, BENCHMARK_TERMS, config);
+        benchmark.config.numberOfTerms = config->numberOfTerms / divisors[i];
+        runBenchmarkCase(&benchmark, pool, samples);
+        reportBenchmarkCase(&benchmark, writer);
+    }
+
+    destroyThreadPool(pool);
+    free(placement);
+    free(samples);
+    int written = writer == NULL || closeWriter(writer);
+    return written && valid;
+}//benchmarkSuite()
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "pi.h"
+#include "writer.h"
+
+// Repetições medidas e de aquecimento padrão de cada caso da bateria de benchmarks.
+#define BENCHMARK_REPETITIONS 5
+#define BENCHMARK_WARMUP 1
+
+// Número máximo de repetições medidas de um caso.
+#define MAXIMUM_BENCHMARK_REPETITIONS 1000
+
+// Percentil da cauda reportado junto com a mediana.
+#define BENCHMARK_PERCENTILE 0.95
+
+// Divisores de -n da varredura de termos: n/100, n/10 e n.
+#define BENCHMARK_TERM_DIVISORS { 100, 10, 1 }
+#define NUMBER_OF_BENCHMARK_TERM_DIVISORS 3
+
+// Formatações da bateria de benchmarks.
+#define BENCHMARK_SUITE_TITLE "Bateria de benchmarks (série %s, até %u threads, %u repetições após %u de aquecimento)\n"
+#define BENCHMARK_SECTION_THREADS "\nEscalabilidade com o número de threads (%llu termos)\n\n"
+#define BENCHMARK_SECTION_KERNELS "\nKernels e acelerações (%llu termos, %u threads)\n\n"
+#define BENCHMARK_SECTION_SUMMATIONS "\nEstratégias de soma (%llu termos, %u threads)\n\n"
+#define BENCHMARK_SECTION_TERMS "\nNúmero de termos (%u threads)\n\n"
+#define BENCHMARK_SUITE_HEADER "%-8s %-8s %-14s %-6s %12s %12s %12s %16s %11s %11s\n"
+#define BENCHMARK_SUITE_COLUMNS "Threads", "Kernel", "Soma", "Acel.", "Termos", "Mediana (s)", "p95 (s)", "Termos/s/núcleo", "Eficiência", "Erro"
+#define BENCHMARK_SUITE_ROW "%-8u %-8s %-14s %-6s %12llu %12.6lf %12.6lf %16.4e %11s %11.3e\n"
+#define BENCHMARK_EFFICIENCY "%.1lf%%"
+#define BENCHMARK_NO_EFFICIENCY "-"
+#define BENCHMARK_EFFICIENCY_SIZE 16
+
+// Validação de cada kernel contra o kernel escalar (a divisão exata em double): as estimativas podem diferir em até
+// meia unidade da última das casas decimais do relatório.
+#define BENCHMARK_TOLERANCE (0.5 * pow(10.0, -DECIMAL_PLACES))
+#define BENCHMARK_SECTION_VALIDATION "\nValidação dos kernels contra o kernel escalar (tolerância de %.1e, %u casas decimais)\n\n"
+#define BENCHMARK_VALIDATION_HEADER "%-8s %-16s %-10s %16s %16s\n"
+#define BENCHMARK_VALIDATION_COLUMNS "Kernel", "Estimativa", "Resultado", "Termos/s/núcleo", "Vazão relativa"
+#define BENCHMARK_VALIDATION_ROW "%-8s %-16s %-10s %16.4e %15.2fx\n"
+#define BENCHMARK_ESTIMATE_SIZE 32
+#define BENCHMARK_VALID "confere"
+#define BENCHMARK_INVALID "DIVERGE"
+
+// Registros da bateria no relatório estruturado (--report).
+#define JSON_BENCHMARK "{\"record\":\"benchmark\",\"section\":\"%s\",\"series\":\"%s\",\"threads\":%u,\"kernel\":\"%s\",\"summation\":\"%s\"," \
+                       "\"acceleration\":\"%s\",\"terms\":%llu,\"repetitions\":%u,\"median_s\":%.9f,\"p95_s\":%.9f," \
+                       "\"terms_per_s_per_core\":%.6e,\"efficiency\":%.6f,\"error\":%.17g}\n"
+#define CSV_BENCHMARK_HEADER "section,series,threads,kernel,summation,acceleration,terms,repetitions,median_s,p95_s,terms_per_s_per_core,efficiency,error\n"
+#define CSV_BENCHMARK "%s,%s,%u,%s,%s,%s,%llu,%u,%.9f,%.9f,%.6e,%.6f,%.17g\n"
+
+// Seções da bateria, usadas nos registros do relatório estruturado.
+#define BENCHMARK_THREADS "threads"
+#define BENCHMARK_KERNELS "kernels"
+#define BENCHMARK_SUMMATIONS "summation"
+#define BENCHMARK_TERMS "terms"
+
+// Medidas de um caso da bateria de benchmarks.
+typedef struct {
+   const char *section;            // Seção da bateria (BENCHMARK_THREADS, ...).
+   Config config;                  // Threads, kernel, soma, aceleração e termos do caso.
+   double median, percentile;      // Mediana e percentil BENCHMARK_PERCENTILE do tempo de parede, em segundos.
+   double throughput;              // Termos por segundo por núcleo na mediana.
+   double efficiency;              // Eficiência paralela em relação a 1 thread (negativa se não se aplica).
+   double error;                   // |estimativa - M_PI|.
+   double estimate;                // Estimativa de pi da última repetição.
+} BenchmarkCase;
+
+/* Executa a bateria de benchmarks com a configuração 'config': varre o número de threads (1, 2, 4, ... até config->numberOfThreads),
+   os kernels suportados e as acelerações, as estratégias de soma e o número de termos (n/100, n/10 e n). Cada caso é executado
+   config->warmup vezes sem medição e config->repetitions vezes medidas; escreve a mediana e o p95 do tempo, a vazão por núcleo,
+   a eficiência paralela e o erro, e grava um registro por caso em config->reportFile, se houver. Na série de Leibniz, valida
+   a estimativa de cada kernel contra a do kernel escalar com a tolerância BENCHMARK_TOLERANCE e compara as vazões.
+   Retorna TRUE se a bateria terminou e todos os kernels conferem, ou FALSE se algum kernel diverge ou o relatório
+   estruturado não pôde ser gravado.
+*/
+int benchmarkSuite(const Config *config);
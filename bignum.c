@@ -0,0 +1,266 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bignum.h"
+#include "writer.h"
+
+/* Calcula P, Q e T do intervalo de termos [a, b) da série de Chudnovsky por divisão binária recursiva em 'node'
+   (já inicializado). Retorna em 'node' os valores com T já com o sinal alternado da série.
+*/
+void binarySplit(unsigned long long a, unsigned long long b, SplitTerm *node) {
+    if (b - a == 1) {
+        if (a == 0) {
+            mpz_set_ui(node->P, 1);
+            mpz_set_ui(node->Q, 1);
+        }
+        else {
+            // P = (6a - 5)(2a - 1)(6a - 1) e Q = a^3 C^3 / 24.
+            mpz_set_ui(node->P, 6 * a - 5);
+            mpz_mul_ui(node->P, node->P, 2 * a - 1);
+            mpz_mul_ui(node->P, node->P, 6 * a - 1);
+            mpz_set_ui(node->Q, a);
+            mpz_pow_ui(node->Q, node->Q, 3);
+            mpz_t c3;
+            mpz_init_set_str(c3, BIG_CHUDNOVSKY_C3_24, 10);
+            mpz_mul(node->Q, node->Q, c3);
+            mpz_clear(c3);
+        }
+        // T = P (A + B a), com o sinal (-1)^a.
+        mpz_set_ui(node->T, (unsigned long)CHUDNOVSKY_B);
+        mpz_mul_ui(node->T, node->T, a);
+        mpz_add_ui(node->T, node->T, (unsigned long)CHUDNOVSKY_A);
+        mpz_mul(node->T, node->T, node->P);
+        if (a % 2 == 1) {
+            mpz_neg(node->T, node->T);
+        }
+        return;
+    }
+
+    unsigned long long m = a + (b - a) / 2;
+    SplitTerm right;
+    mpz_inits(right.P, right.Q, right.T, NULL);
+    binarySplit(a, m, node);
+    binarySplit(m, b, &right);
+
+    // T = T1 Q2 + P1 T2, P = P1 P2 e Q = Q1 Q2.
+    mpz_mul(node->T, node->T, right.Q);
+    mpz_mul(right.T, right.T, node->P);
+    mpz_add(node->T, node->T, right.T);
+    mpz_mul(node->P, node->P, right.P);
+    mpz_mul(node->Q, node->Q, right.Q);
+    mpz_clears(right.P, right.Q, right.T, NULL);
+}//binarySplit()
+
+/* Trabalho do pool que calcula as folhas da árvore: cada worker retira intervalos de BigSplit e os divide
+   recursivamente; a tarefa 0 calcula a raiz quadrada inteira usada na divisão final.
+*/
+void bigLeaves(void *argument, unsigned int worker, ThreadResult *result) {
+    BigSplit *split = (BigSplit *)argument;
+    (void)worker;
+    (void)result;
+
+    unsigned int task;
+    while ((task = __atomic_fetch_add(&split->next, 1, __ATOMIC_RELAXED)) < split->numberOfTasks) {
+        if (task == 0) {
+            // sqrt(10005) 10^digits = isqrt(10005 10^(2 digits)).
+            mpz_ui_pow_ui(*split->root10005, 10, 2 * split->digits);
+            mpz_mul_ui(*split->root10005, *split->root10005, BIG_CHUDNOVSKY_RADICAND);
+            mpz_sqrt(*split->root10005, *split->root10005);
+            continue;
+        }
+        TermRange range;
+        partitionTerms(split->numberOfTerms, split->numberOfPieces, task - 1, &range);
+        binarySplit(range.start, range.start + range.count, &split->nodes[task - 1]);
+    }
+}//bigLeaves()
+
+/* Trabalho do pool que junta os nós de um nível da árvore dois a dois: cada multiplicação (P1 P2, Q1 Q2, T1 Q2 e P1 T2)
+   é uma tarefa independente.
+*/
+void bigMerge(void *argument, unsigned int worker, ThreadResult *result) {
+    BigSplit *split = (BigSplit *)argument;
+    (void)worker;
+    (void)result;
+
+    unsigned int task;
+    while ((task = __atomic_fetch_add(&split->next, 1, __ATOMIC_RELAXED)) < split->numberOfTasks) {
+        unsigned int merge = task / 4;
+        SplitTerm *left = &split->nodes[2 * merge], *right = &split->nodes[2 * merge + 1];
+        switch (task % 4) {
+            case 0:
+                if (!split->root) {
+                    mpz_mul(split->merged[merge].P, left->P, right->P);
+                }
+                break;
+            case 1:
+                mpz_mul(split->merged[merge].Q, left->Q, right->Q);
+                break;
+            case 2:
+                mpz_mul(split->products[2 * merge], left->T, right->Q);
+                break;
+            default:
+                mpz_mul(split->products[2 * merge + 1], left->P, right->T);
+                break;
+        }
+    }
+}//bigMerge()
+
+/* Calcula floor(pi 10^digits) em 'pi' com a série de Chudnovsky, distribuindo a divisão binária e a raiz quadrada
+   pelos workers do pool 'pool'.
+   Retorna o número de termos da série usados.
+*/
+unsigned long long calculateBigPi(mpz_t pi, unsigned long long digits, ThreadPool *pool) {
+    unsigned long long workingDigits = digits + BIG_GUARD_DIGITS;
+    unsigned long long numberOfTerms = (unsigned long long)(workingDigits / BIG_DIGITS_PER_TERM) + 2;
+    unsigned long long pieces = (unsigned long long)pool->numberOfWorkers * BIG_PIECES_PER_WORKER;
+    unsigned int numberOfPieces = (unsigned int)(pieces < numberOfTerms ? pieces : numberOfTerms);
+
+    mpz_t root10005;
+    mpz_init(root10005);
+    SplitTerm *nodes = (SplitTerm *)malloc(numberOfPieces * sizeof(SplitTerm));
+    SplitTerm *merged = (SplitTerm *)malloc(numberOfPieces * sizeof(SplitTerm));
+    mpz_t *products = (mpz_t *)malloc(numberOfPieces * sizeof(mpz_t));
+    if (nodes == NULL || merged == NULL || products == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    for (unsigned int i = 0; i < numberOfPieces; i++) {
+        mpz_inits(nodes[i].P, nodes[i].Q, nodes[i].T, merged[i].P, merged[i].Q, merged[i].T, products[i], NULL);
+    }
+
+    // Folhas: um intervalo contíguo de termos por tarefa, mais a raiz quadrada em paralelo.
+    BigSplit split = {
+        .next = 0,
+        .numberOfTasks = numberOfPieces + 1,
+        .numberOfTerms = numberOfTerms,
+        .numberOfPieces = numberOfPieces,
+        .nodes = nodes,
+        .merged = merged,
+        .products = products,
+        .root = FALSE,
+        .root10005 = &root10005,
+        .digits = workingDigits
+    };
+    threadPoolSubmit(pool, bigLeaves, &split);
+    threadPoolWait(pool);
+
+    // Junções nível a nível até restar a raiz; um nó ímpar no fim do nível sobe sem alteração.
+    for (unsigned int count = numberOfPieces; count > 1; count = (count + 1) / 2) {
+        unsigned int merges = count / 2;
+        split.next = 0;
+        split.numberOfTasks = 4 * merges;
+        split.root = (count == 2);
+        threadPoolSubmit(pool, bigMerge, &split);
+        threadPoolWait(pool);
+
+        for (unsigned int j = 0; j < merges; j++) {
+            mpz_add(split.merged[j].T, split.products[2 * j], split.products[2 * j + 1]);
+        }
+        if (count % 2 == 1) {
+            SplitTerm *last = &split.nodes[count - 1], *target = &split.merged[merges];
+            mpz_swap(last->P, target->P);
+            mpz_swap(last->Q, target->Q);
+            mpz_swap(last->T, target->T);
+        }
+        SplitTerm *swap = split.nodes;
+        split.nodes = split.merged;
+        split.merged = swap;
+    }
+
+    // pi 10^working = 426880 sqrt(10005) 10^working Q / T; as casas de guarda são descartadas por truncamento.
+    mpz_mul(pi, split.nodes[0].Q, root10005);
+    mpz_mul_ui(pi, pi, BIG_CHUDNOVSKY_FACTOR);
+    mpz_tdiv_q(pi, pi, split.nodes[0].T);
+    mpz_t guard;
+    mpz_init(guard);
+    mpz_ui_pow_ui(guard, 10, BIG_GUARD_DIGITS);
+    mpz_tdiv_q(pi, pi, guard);
+    mpz_clear(guard);
+
+    for (unsigned int i = 0; i < numberOfPieces; i++) {
+        mpz_clears(nodes[i].P, nodes[i].Q, nodes[i].T, merged[i].P, merged[i].Q, merged[i].T, products[i], NULL);
+    }
+    free(products);
+    free(merged);
+    free(nodes);
+    mpz_clear(root10005);
+    return numberOfTerms;
+}//calculateBigPi()
+
+/* Grava 'pi' (floor(pi 10^digits)) no arquivo 'fileName' como "3." seguido das casas decimais, em blocos de BIG_WRITE_BLOCK.
+   Copia até BIG_PREVIEW_DIGITS casas para 'preview', com o separador decimal dos relatórios em texto.
+   Retorna TRUE se o arquivo foi gravado ou FALSE se ocorreu algum erro.
+*/
+int writeBigPi(const char *fileName, mpz_t pi, String preview) {
+    char *digits = mpz_get_str(NULL, 10, pi);
+    if (digits == NULL) {
+        perror(ERROR_BIG_DIGITS);
+        return FALSE;
+    }
+    size_t length = strlen(digits);
+    snprintf(preview, STRING_DEFAULT_SIZE, "%c%c%.*s", digits[0], reportDecimalPoint(), BIG_PREVIEW_DIGITS, digits + 1);
+
+    FILE *file = fopen(fileName, FILE_OPENING_OPTION);
+    if (file == NULL) {
+        perror(ERROR_FILE);
+        free(digits);
+        return FALSE;
+    }
+    int written = fwrite(digits, 1, 1, file) == 1 && fputs(BIG_INTEGER_SEPARATOR, file) >= 0;
+    for (size_t offset = 1; written && offset < length; offset += BIG_WRITE_BLOCK) {
+        size_t block = length - offset < BIG_WRITE_BLOCK ? length - offset : BIG_WRITE_BLOCK;
+        written = fwrite(digits + offset, 1, block, file) == block;
+    }
+    written = written && fputc(NEW_LINE, file) != EOF;
+    written = (fclose(file) == 0) && written;
+    free(digits);
+    if (!written) {
+        perror(ERROR_FILE);
+    }
+    return written ? TRUE : FALSE;
+}//writeBigPi()
+
+/* Executa o modo de precisão arbitrária: calcula pi com config->precision casas, grava os dígitos em config->outputFile
+   e escreve um relatório na saída padrão.
+   Retorna TRUE se os dígitos foram gravados ou FALSE caso contrário.
+*/
+int bigPi(const Config *config) {
+    int *placement = createPlacement(config, 1, 0);
+    if (placement == NULL && config->affinity != AFFINITY_NONE) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    ThreadPool *pool = createThreadPool(config->numberOfThreads, placement);
+    if (pool == NULL) {
+        perror(ERROR_THREAD_POOL);
+        exit(EXIT_FAILURE);
+    }
+    struct timespec startTime, endTime;
+    mpz_t pi;
+    mpz_init(pi);
+
+    clock_gettime(DURATION_CLOCK, &startTime);
+    unsigned long long terms = calculateBigPi(pi, config->precision, pool);
+    clock_gettime(DURATION_CLOCK, &endTime);
+    destroyThreadPool(pool);
+    free(placement);
+
+    String preview;
+    int written = writeBigPi(config->outputFile, pi, preview);
+    mpz_clear(pi);
+
+    // O relatório vai à saída padrão em um único write(), com a vírgula decimal já na formatação.
+    Writer *writer = openTextWriter(NULL, REPORT_TEXT_SIZE(1));
+    if (writer == NULL) {
+        return FALSE;
+    }
+    writerPrintf(writer, "%s%s%s", EMPTY_LINE, BIG_REPORT_TITLE, EMPTY_LINE);
+    writerPrintf(writer, "%c" BIG_REPORT_DIGITS "%c", TAB, config->precision, NEW_LINE);
+    writerPrintf(writer, "%c" BIG_REPORT_TERMS "%c", TAB, terms, NEW_LINE);
+    writerPrintf(writer, "%c" PROCESS_REPORT_NUMBER_OF_THREADS "%s", TAB, config->numberOfThreads, EMPTY_LINE);
+    writerPrintf(writer, "%c" BIG_REPORT_DURATION "%s", TAB, calculateDuration(startTime, endTime), EMPTY_LINE);
+    writerPrintf(writer, "%c" BIG_REPORT_PREVIEW "%c", TAB, (int)strlen(preview), preview, NEW_LINE);
+    writerPrintf(writer, "%c" BIG_REPORT_FILE "%s", TAB, config->outputFile, EMPTY_LINE);
+    return closeWriter(writer) && written;
+}//bigPi()
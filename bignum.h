@@ -0,0 +1,90 @@
+#pragma once
+
+#include <gmp.h>     // Requerido pela aritmética de precisão arbitrária (GNU MP).
+#include "pi.h"
+
+// Dígitos acrescentados ao cálculo para absorver os erros de truncamento antes de cortar o resultado.
+#define BIG_GUARD_DIGITS 16
+
+// Dígitos decimais obtidos por termo da série de Chudnovsky (log10(C^3 / 1728)).
+#define BIG_DIGITS_PER_TERM 14.181647462725477
+
+// Intervalos da divisão binária por worker, para equilibrar a carga (os intervalos finais são mais caros).
+#define BIG_PIECES_PER_WORKER 4
+
+// Constante de 1/pi = 12 sum(...) na forma 426880 sqrt(10005) Q / T.
+#define BIG_CHUDNOVSKY_FACTOR 426880
+#define BIG_CHUDNOVSKY_RADICAND 10005
+
+// C^3 / 24 da série de Chudnovsky.
+#define BIG_CHUDNOVSKY_C3_24 "10939058860032000"
+
+// Tamanho do bloco de escrita dos dígitos no arquivo.
+#define BIG_WRITE_BLOCK 65536
+
+// Dígitos de pi exibidos no relatório (o restante fica apenas no arquivo).
+#define BIG_PREVIEW_DIGITS 50
+
+// Formatações do relatório do modo de precisão arbitrária.
+#define BIG_REPORT_TITLE "Cálculo do Número π com precisão arbitrária (Chudnovsky, divisão binária)"
+#define BIG_REPORT_DIGITS "Casas decimais: %llu"
+#define BIG_REPORT_TERMS "Termos da série: %llu"
+#define BIG_REPORT_DURATION "Duração: %.2lf s"
+#define BIG_REPORT_FILE "Arquivo: %s"
+#define BIG_REPORT_PREVIEW "Pi = %.*s..."
+#define BIG_INTEGER_SEPARATOR "."
+
+// Mensagens de erros.
+#define ERROR_BIG_DIGITS "Erro ao converter os dígitos de pi"
+
+// Nó da divisão binária: P, Q e T do intervalo de termos [a, b) da série de Chudnovsky.
+typedef struct {
+   mpz_t P, Q, T;
+} SplitTerm;
+
+// Estado de um passo paralelo da divisão binária, compartilhado pelos workers do pool.
+typedef struct {
+   unsigned int next;              // Próxima tarefa livre (incrementada atomicamente).
+   unsigned int numberOfTasks;
+   unsigned long long numberOfTerms;
+   unsigned int numberOfPieces;
+   SplitTerm *nodes;               // Nós do nível atual.
+   SplitTerm *merged;              // Nós do nível seguinte.
+   mpz_t *products;                // T1 Q2 e P1 T2 de cada junção, somados depois da espera.
+   int root;                       // TRUE se a junção do nível é a raiz (P não é mais necessário).
+   mpz_t *root10005;               // Destino de isqrt(10005 10^(2 digits)), calculada junto com as folhas.
+   unsigned long long digits;
+} BigSplit;
+
+/* Calcula P, Q e T do intervalo de termos [a, b) da série de Chudnovsky por divisão binária recursiva em 'node'
+   (já inicializado). Retorna em 'node' os valores com T já com o sinal alternado da série.
+*/
+void binarySplit(unsigned long long a, unsigned long long b, SplitTerm *node);
+
+/* Trabalho do pool que calcula as folhas da árvore: cada worker retira intervalos de BigSplit e os divide
+   recursivamente; a tarefa 0 calcula a raiz quadrada inteira usada na divisão final.
+*/
+void bigLeaves(void *argument, unsigned int worker, ThreadResult *result);
+
+/* Trabalho do pool que junta os nós de um nível da árvore dois a dois: cada multiplicação (P1 P2, Q1 Q2, T1 Q2 e P1 T2)
+   é uma tarefa independente.
+*/
+void bigMerge(void *argument, unsigned int worker, ThreadResult *result);
+
+/* Calcula floor(pi 10^digits) em 'pi' com a série de Chudnovsky, distribuindo a divisão binária e a raiz quadrada
+   pelos workers do pool 'pool'.
+   Retorna o número de termos da série usados.
+*/
+unsigned long long calculateBigPi(mpz_t pi, unsigned long long digits, ThreadPool *pool);
+
+/* Grava 'pi' (floor(pi 10^digits)) no arquivo 'fileName' como "3." seguido das casas decimais, em blocos de BIG_WRITE_BLOCK.
+   Copia até BIG_PREVIEW_DIGITS casas para 'preview', com o separador decimal dos relatórios em texto.
+   Retorna TRUE se o arquivo foi gravado ou FALSE se ocorreu algum erro.
+*/
+int writeBigPi(const char *fileName, mpz_t pi, String preview);
+
+/* Executa o modo de precisão arbitrária: calcula pi com config->precision casas, grava os dígitos em config->outputFile
+   e escreve um relatório na saída padrão.
+   Retorna TRUE se os dígitos foram gravados ou FALSE caso contrário.
+*/
+int bigPi(const Config *config);
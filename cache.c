@@ -0,0 +1,122 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "cache.h"
+
+/* Abre, no diretório config->cacheDirectory, o arquivo de cache da chave de 'config' (série, soma, kernel e tamanho
+   do chunk), criando-o ou aumentando-o sob uma trava exclusiva até cobrir os chunks completos da execução.
+   Retorna o cache mapeado ou NULL se ocorreu algum erro.
+*/
+ChunkCache* openChunkCache(const Config *config) {
+    // Só os chunks completos entram no cache: um último chunk parcial tem outra chave (início e tamanho).
+    unsigned long long numberOfChunks = config->numberOfTerms / config->chunkSize;
+    char fileName[PATH_MAX];
+    snprintf(fileName, sizeof(fileName), CACHE_FILE_NAME, config->cacheDirectory, seriesName(config->series),
+             summationName(config->summation), kernelName(config->kernel), config->chunkSize);
+
+    int fd = open(fileName, O_RDWR | O_CREAT, CACHE_MODE);
+    if (fd < 0 || flock(fd, LOCK_EX) != 0) {
+        perror(ERROR_CACHE);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return NULL;
+    }
+    // Sob a trava, lê ou cria o cabeçalho e aumenta o arquivo se esta execução precisa de mais chunks.
+    CacheHeader header;
+    int valid = TRUE;
+    ssize_t bytes = pread(fd, &header, sizeof(header), 0);
+    if (bytes == 0) {
+        header.magic = CACHE_MAGIC;
+        header.version = CACHE_VERSION;
+        header.series = config->series;
+        header.summation = config->summation;
+        header.kernel = config->kernel;
+        header.chunkSize = config->chunkSize;
+        header.numberOfChunks = 0;
+    }
+    else {
+        valid = bytes == (ssize_t)sizeof(header) && header.magic == CACHE_MAGIC && header.version == CACHE_VERSION
+            && header.series == (uint32_t)config->series && header.summation == (uint32_t)config->summation
+            && header.kernel == (uint32_t)config->kernel && header.chunkSize == config->chunkSize;
+    }
+    if (valid && header.numberOfChunks < numberOfChunks) {
+        header.numberOfChunks = numberOfChunks;
+        size_t grown = sizeof(CacheHeader) + numberOfChunks * sizeof(CacheEntry);
+        valid = ftruncate(fd, (off_t)grown) == 0 && pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header);
+        if (!valid) {
+            perror(ERROR_CACHE);
+        }
+    }
+    else if (!valid) {
+        fprintf(stderr, ERROR_CACHE_MISMATCH, fileName);
+    }
+    // O mapeamento cobre só o que esta execução usa; o arquivo pode ter mais chunks de execuções anteriores.
+    size_t size = sizeof(CacheHeader) + numberOfChunks * sizeof(CacheEntry);
+    void *mapping = valid ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    flock(fd, LOCK_UN);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        if (valid) {
+            perror(ERROR_CACHE);
+        }
+        return NULL;
+    }
+
+    ChunkCache *cache = (ChunkCache *)malloc(sizeof(ChunkCache));
+    if (cache == NULL || (cache->fileName = strdup(fileName)) == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    cache->header = (CacheHeader *)mapping;
+    cache->entries = (CacheEntry *)(cache->header + 1);
+    cache->numberOfChunks = numberOfChunks;
+    cache->chunkSize = config->chunkSize;
+    cache->size = size;
+    return cache;
+}//openChunkCache()
+
+/* Retorna TRUE e copia em 'sum' a soma do chunk 'chunk' com 'count' termos se ela está no cache, ou FALSE caso contrário.
+   Apenas chunks completos (com chunkSize termos) são guardados.
+*/
+int cacheLoad(const ChunkCache *cache, unsigned long long chunk, unsigned long long count, CompensatedSum *sum) {
+    if (chunk >= cache->numberOfChunks || count != cache->chunkSize
+        || !__atomic_load_n(&cache->entries[chunk].done, __ATOMIC_ACQUIRE)) {
+        return FALSE;
+    }
+    *sum = cache->entries[chunk].sum;
+    return TRUE;
+}//cacheLoad()
+
+/* Grava no cache a soma 'sum' do chunk 'chunk' com 'count' termos, se ele é completo. */
+void cacheStore(ChunkCache *cache, unsigned long long chunk, unsigned long long count, CompensatedSum sum) {
+    if (chunk >= cache->numberOfChunks || count != cache->chunkSize) {
+        return;
+    }
+    // Execuções concorrentes gravam o mesmo valor; a marca vem depois da soma, como no checkpoint.
+    cache->entries[chunk].sum = sum;
+    __atomic_store_n(&cache->entries[chunk].done, 1, __ATOMIC_RELEASE);
+}//cacheStore()
+
+/* Retorna quantos dos primeiros 'numberOfChunks' chunks já estão no cache. */
+unsigned long long cacheHits(const ChunkCache *cache, unsigned long long numberOfChunks) {
+    unsigned long long hits = 0;
+    for (unsigned long long chunk = 0; chunk < numberOfChunks && chunk < cache->numberOfChunks; chunk++) {
+        hits += cache->entries[chunk].done != 0;
+    }
+    return hits;
+}//cacheHits()
+
+/* Desfaz o mapeamento do cache. As somas gravadas chegam ao disco pelo cache de páginas do núcleo. */
+void closeChunkCache(ChunkCache *cache) {
+    munmap(cache->header, cache->size);
+    free(cache->fileName);
+    free(cache);
+}//closeChunkCache()
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>    // Requerido pelos campos de largura fixa do arquivo.
+#include "pi.h"
+
+// Identificação do arquivo de cache ("PICACHE1") e versão do formato.
+#define CACHE_MAGIC 0x5049434143484531ULL
+#define CACHE_VERSION 2
+
+// Nome do arquivo de cache de uma chave dentro do diretório: série, soma, kernel e tamanho do chunk.
+#define CACHE_FILE_NAME "%s/pi-%s-%s-%s-%llu.cache"
+
+// Permissões do arquivo de cache criado.
+#define CACHE_MODE 0644
+
+// Formatações do cache de chunks.
+#define CACHE_HITS "Cache %s: %llu de %llu chunks já somados serão reaproveitados.\n"
+
+// Mensagens de erros.
+#define ERROR_CACHE "Erro no arquivo de cache"
+#define ERROR_CACHE_MISMATCH "ERRO: o arquivo de cache %s não corresponde à sua chave.\n"
+
+// Cabeçalho do arquivo de cache de uma chave (série, soma, kernel, tamanho do chunk), seguido de 'numberOfChunks' CacheEntry.
+// O arquivo cresce quando uma execução precisa de mais chunks; os campos ficam na ordem de bytes da máquina.
+typedef struct {
+   uint64_t magic;
+   uint32_t version;
+   uint32_t series;
+   uint32_t summation;
+   uint32_t kernel;
+   uint64_t chunkSize;
+   uint64_t numberOfChunks;        // Capacidade do arquivo em chunks.
+} CacheHeader;
+
+// Soma de um chunk completo no cache; a entrada c cobre os termos [c chunkSize, (c + 1) chunkSize).
+typedef struct {
+   CompensatedSum sum;
+   uint64_t done;                  // 1 depois que a soma foi gravada; é escrito por último.
+} CacheEntry;
+
+// Cache de somas de chunks mapeado em memória com MAP_SHARED, compartilhado por execuções sucessivas e concorrentes.
+typedef struct ChunkCache {
+   CacheHeader *header;            // Início do mapeamento.
+   CacheEntry *entries;
+   unsigned long long numberOfChunks; // Chunks cobertos pelo mapeamento desta execução.
+   unsigned long long chunkSize;
+   size_t size;                    // Tamanho do mapeamento.
+   char *fileName;
+} ChunkCache;
+
+/* Abre, no diretório config->cacheDirectory, o arquivo de cache da chave de 'config' (série, soma, kernel e tamanho
+   do chunk), criando-o ou aumentando-o sob uma trava exclusiva até cobrir os chunks completos da execução.
+   Retorna o cache mapeado ou NULL se ocorreu algum erro.
+*/
+ChunkCache* openChunkCache(const Config *config);
+
+/* Retorna TRUE e copia em 'sum' a soma do chunk 'chunk' com 'count' termos se ela está no cache, ou FALSE caso contrário.
+   Apenas chunks completos (com chunkSize termos) são guardados.
+*/
+int cacheLoad(const ChunkCache *cache, unsigned long long chunk, unsigned long long count, CompensatedSum *sum);
+
+/* Grava no cache a soma 'sum' do chunk 'chunk' com 'count' termos, se ele é completo. */
+void cacheStore(ChunkCache *cache, unsigned long long chunk, unsigned long long count, CompensatedSum sum);
+
+/* Retorna quantos dos primeiros 'numberOfChunks' chunks já estão no cache. */
+unsigned long long cacheHits(const ChunkCache *cache, unsigned long long numberOfChunks);
+
+/* Desfaz o mapeamento do cache. As somas gravadas chegam ao disco pelo cache de páginas do núcleo. */
+void closeChunkCache(ChunkCache *cache);
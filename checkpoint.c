@@ -0,0 +1,129 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "checkpoint.h"
+
+/* Retorna o deslocamento das somas no arquivo de um checkpoint com 'numberOfChunks' chunks. */
+static size_t checkpointSumsOffset(unsigned long long numberOfChunks) {
+    size_t offset = sizeof(CheckpointHeader) + numberOfChunks;
+    return (offset + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+}//checkpointSumsOffset()
+
+/* Abre o checkpoint config->checkpointFile da execução 'config'. Com config->resume e um arquivo existente, valida o cabeçalho
+   e reaproveita os chunks já somados; caso contrário, cria o arquivo vazio (sobrescrevendo um anterior).
+   Retorna o checkpoint mapeado ou NULL se ocorreu algum erro.
+*/
+Checkpoint* openCheckpoint(const Config *config) {
+    unsigned long long numberOfChunks = countChunks(config);
+    size_t offset = checkpointSumsOffset(numberOfChunks);
+    size_t size = offset + numberOfChunks * sizeof(CompensatedSum);
+
+    int fd = open(config->checkpointFile, O_RDWR | O_CREAT | (config->resume ? 0 : O_TRUNC), CHECKPOINT_MODE);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) != 0) {
+        perror(ERROR_CHECKPOINT);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return NULL;
+    }
+    // Um arquivo vazio é um checkpoint novo; qualquer outro tamanho precisa ser o desta execução.
+    int created = status.st_size == 0;
+    if (!created && (size_t)status.st_size != size) {
+        fprintf(stderr, ERROR_CHECKPOINT_MISMATCH, config->checkpointFile);
+        close(fd);
+        return NULL;
+    }
+    if (created && ftruncate(fd, (off_t)size) != 0) {
+        perror(ERROR_CHECKPOINT);
+        close(fd);
+        return NULL;
+    }
+    void *mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        perror(ERROR_CHECKPOINT);
+        return NULL;
+    }
+
+    CheckpointHeader *header = (CheckpointHeader *)mapping;
+    if (created) {
+        header->magic = CHECKPOINT_MAGIC;
+        header->version = CHECKPOINT_VERSION;
+        header->series = config->series;
+        header->summation = config->summation;
+        header->kernel = config->kernel;
+        header->numberOfTerms = config->numberOfTerms;
+        header->chunkSize = config->chunkSize;
+        header->numberOfChunks = numberOfChunks;
+        msync(mapping, size, MS_SYNC);
+    }
+    // O kernel entra na chave porque kernels diferentes arredondam as somas dos chunks de formas diferentes.
+    else if (header->magic != CHECKPOINT_MAGIC || header->version != CHECKPOINT_VERSION || header->series != (uint32_t)config->series
+             || header->summation != (uint32_t)config->summation || header->kernel != (uint32_t)config->kernel
+             || header->numberOfTerms != config->numberOfTerms || header->chunkSize != config->chunkSize
+             || header->numberOfChunks != numberOfChunks) {
+        fprintf(stderr, ERROR_CHECKPOINT_MISMATCH, config->checkpointFile);
+        munmap(mapping, size);
+        return NULL;
+    }
+
+    Checkpoint *checkpoint = (Checkpoint *)malloc(sizeof(Checkpoint));
+    if (checkpoint == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    checkpoint->header = header;
+    checkpoint->done = (unsigned char *)(header + 1);
+    checkpoint->sums = (CompensatedSum *)((char *)mapping + offset);
+    checkpoint->size = size;
+    clock_gettime(DURATION_CLOCK, &checkpoint->lastSync);
+    return checkpoint;
+}//openCheckpoint()
+
+/* Retorna TRUE e copia em 'sum' a soma do chunk 'chunk' se ele já está no checkpoint, ou FALSE caso contrário. */
+int checkpointLoad(const Checkpoint *checkpoint, unsigned long long chunk, CompensatedSum *sum) {
+    if (!__atomic_load_n(&checkpoint->done[chunk], __ATOMIC_ACQUIRE)) {
+        return FALSE;
+    }
+    *sum = checkpoint->sums[chunk];
+    return TRUE;
+}//checkpointLoad()
+
+/* Grava no checkpoint a soma 'sum' do chunk 'chunk' e o marca como somado. */
+void checkpointStore(Checkpoint *checkpoint, unsigned long long chunk, CompensatedSum sum) {
+    // A marca é escrita depois da soma, de modo que um chunk marcado nunca tem a soma incompleta.
+    checkpoint->sums[chunk] = sum;
+    __atomic_store_n(&checkpoint->done[chunk], 1, __ATOMIC_RELEASE);
+}//checkpointStore()
+
+/* Retorna o número de chunks já somados no checkpoint. */
+unsigned long long checkpointCompleted(const Checkpoint *checkpoint) {
+    unsigned long long completed = 0;
+    for (unsigned long long chunk = 0; chunk < checkpoint->header->numberOfChunks; chunk++) {
+        completed += checkpoint->done[chunk];
+    }
+    return completed;
+}//checkpointCompleted()
+
+/* Sincroniza o checkpoint com o disco se já se passaram CHECKPOINT_INTERVAL segundos desde a última sincronização. */
+void syncCheckpoint(Checkpoint *checkpoint) {
+    struct timespec now;
+    clock_gettime(DURATION_CLOCK, &now);
+    if (calculateDuration(checkpoint->lastSync, now) >= CHECKPOINT_INTERVAL) {
+        msync(checkpoint->header, checkpoint->size, MS_SYNC);
+        checkpoint->lastSync = now;
+    }
+}//syncCheckpoint()
+
+/* Sincroniza o checkpoint com o disco e desfaz o seu mapeamento. */
+void closeCheckpoint(Checkpoint *checkpoint) {
+    msync(checkpoint->header, checkpoint->size, MS_SYNC);
+    munmap(checkpoint->header, checkpoint->size);
+    free(checkpoint);
+}//closeCheckpoint()
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>    // Requerido pelos campos de largura fixa do arquivo.
+#include <time.h>      // Requerido pelo instante da última sincronização (struct timespec).
+#include "pi.h"
+
+// Identificação do arquivo de checkpoint ("PICKPT01") e versão do formato.
+#define CHECKPOINT_MAGIC 0x5049434B50543031ULL
+#define CHECKPOINT_VERSION 2
+
+// Intervalo mínimo entre duas sincronizações do checkpoint com o disco (em segundos).
+#define CHECKPOINT_INTERVAL 10
+
+// Permissões do arquivo de checkpoint criado.
+#define CHECKPOINT_MODE 0644
+
+// Formatações do modo de checkpoint.
+#define CHECKPOINT_RESUMED "Checkpoint %s: %llu de %llu chunks já somados serão reaproveitados.\n"
+
+// Mensagens de erros.
+#define ERROR_CHECKPOINT "Erro no arquivo de checkpoint"
+#define ERROR_CHECKPOINT_MISMATCH "ERRO: o checkpoint %s não corresponde a esta execução (série, soma, kernel, termos e chunk devem ser os mesmos).\n"
+
+// Cabeçalho do arquivo de checkpoint, seguido de um byte por chunk (1 se somado), completado até 8 bytes,
+// e da soma compensada de cada chunk. Os campos ficam na ordem de bytes da máquina.
+typedef struct {
+   uint64_t magic;
+   uint32_t version;
+   uint32_t series;
+   uint32_t summation;
+   uint32_t kernel;
+   uint64_t numberOfTerms;
+   uint64_t chunkSize;
+   uint64_t numberOfChunks;
+} CheckpointHeader;
+
+// Checkpoint mapeado em memória com MAP_SHARED: as escritas dos workers chegam ao cache de páginas do núcleo
+// imediatamente, de modo que sobrevivem à morte do processo, e vão para o disco a cada sincronização.
+typedef struct Checkpoint {
+   CheckpointHeader *header;       // Início do mapeamento.
+   unsigned char *done;            // done[c] é 1 se o chunk c já foi somado.
+   CompensatedSum *sums;           // Soma do chunk c, válida se done[c] é 1.
+   size_t size;                    // Tamanho do arquivo e do mapeamento.
+   struct timespec lastSync;       // Instante da última sincronização com o disco.
+} Checkpoint;
+
+/* Abre o checkpoint config->checkpointFile da execução 'config'. Com config->resume e um arquivo existente, valida o cabeçalho
+   e reaproveita os chunks já somados; caso contrário, cria o arquivo vazio (sobrescrevendo um anterior).
+   Retorna o checkpoint mapeado ou NULL se ocorreu algum erro.
+*/
+Checkpoint* openCheckpoint(const Config *config);
+
+/* Retorna TRUE e copia em 'sum' a soma do chunk 'chunk' se ele já está no checkpoint, ou FALSE caso contrário. */
+int checkpointLoad(const Checkpoint *checkpoint, unsigned long long chunk, CompensatedSum *sum);
+
+/* Grava no checkpoint a soma 'sum' do chunk 'chunk' e o marca como somado. */
+void checkpointStore(Checkpoint *checkpoint, unsigned long long chunk, CompensatedSum sum);
+
+/* Retorna o número de chunks já somados no checkpoint. */
+unsigned long long checkpointCompleted(const Checkpoint *checkpoint);
+
+/* Sincroniza o checkpoint com o disco se já se passaram CHECKPOINT_INTERVAL segundos desde a última sincronização. */
+void syncCheckpoint(Checkpoint *checkpoint);
+
+/* Sincroniza o checkpoint com o disco e desfaz o seu mapeamento. */
+void closeCheckpoint(Checkpoint *checkpoint);
@@ -0,0 +1,691 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "cluster.h"
+#include "metrics.h"
+#include "writer.h"
+
+/* Grava 'value' em 'buffer' como um campo de 64 bits big-endian.
+   Retorna a posição seguinte de 'buffer'.
+*/
+static unsigned char* putField(unsigned char *buffer, uint64_t value) {
+    for (int i = 7; i >= 0; i--) {
+        buffer[i] = (unsigned char)(value & 0xFF);
+        value >>= 8;
+    }
+    return buffer + 8;
+}//putField()
+
+/* Lê um campo de 64 bits big-endian de '*buffer' e avança '*buffer'. */
+static uint64_t getField(const unsigned char **buffer) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = (value << 8) | (*buffer)[i];
+    }
+    *buffer += 8;
+    return value;
+}//getField()
+
+/* Grava o double 'value' em 'buffer' pelos seus bits. Retorna a posição seguinte de 'buffer'. */
+static unsigned char* putDouble(unsigned char *buffer, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return putField(buffer, bits);
+}//putDouble()
+
+/* Lê um double gravado por putDouble de '*buffer' e avança '*buffer'. */
+static double getDouble(const unsigned char **buffer) {
+    uint64_t bits = getField(buffer);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}//getDouble()
+
+/* Separa 'address' (HOST:PORTA) em 'host' e 'port'.
+   Retorna TRUE se o endereço é válido ou FALSE caso contrário.
+*/
+int parseClusterAddress(const char *address, String host, unsigned int *port) {
+    const char *separator = strrchr(address, CLUSTER_PORT_SEPARATOR);
+    if (separator == NULL || separator == address || separator - address >= STRING_DEFAULT_SIZE) {
+        return FALSE;
+    }
+    char *end;
+    errno = 0;
+    unsigned long parsed = strtoul(separator + 1, &end, 10);
+    if (errno != 0 || end == separator + 1 || *end != NULL_CHAR || parsed == 0 || parsed > CLUSTER_MAXIMUM_PORT) {
+        return FALSE;
+    }
+    snprintf(host, STRING_DEFAULT_SIZE, "%.*s", (int)(separator - address), address);
+    *port = (unsigned int)parsed;
+    return TRUE;
+}//parseClusterAddress()
+
+/* Envia os 'size' bytes de 'buffer' pelo socket 'fd'.
+   Retorna TRUE se todos os bytes foram enviados ou FALSE se a conexão falhou.
+*/
+int sendFully(int fd, const unsigned char *buffer, size_t size) {
+    while (size > 0) {
+        // MSG_NOSIGNAL: um par que morreu não deve encerrar o processo com SIGPIPE.
+        ssize_t sent = send(fd, buffer, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return FALSE;
+        }
+        buffer += sent;
+        size -= (size_t)sent;
+    }
+    return TRUE;
+}//sendFully()
+
+/* Recebe exatamente 'size' bytes do socket 'fd' em 'buffer'.
+   Retorna TRUE se todos os bytes foram recebidos ou FALSE se a conexão foi fechada ou falhou.
+*/
+int receiveFully(int fd, unsigned char *buffer, size_t size) {
+    while (size > 0) {
+        ssize_t received = recv(fd, buffer, size, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return FALSE;
+        }
+        buffer += received;
+        size -= (size_t)received;
+    }
+    return TRUE;
+}//receiveFully()
+
+/* Limita a CLUSTER_IO_TIMEOUT segundos as leituras e escritas bloqueantes do socket 'fd' e desliga o algoritmo de Nagle,
+   já que as mensagens são pequenas e cada uma espera a resposta da outra.
+*/
+static void configureSocket(int fd) {
+    struct timeval timeout = {CLUSTER_IO_TIMEOUT, 0};
+    int enable = 1;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable));
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+}//configureSocket()
+
+/* Envia ao worker 'worker' o lote 'job', os chunks [job CLUSTER_JOB_CHUNKS, (job + 1) CLUSTER_JOB_CHUNKS) da série config->series.
+   Retorna TRUE se o lote foi enviado ou FALSE se a conexão falhou.
+*/
+int sendClusterJob(ClusterWorker *worker, int job, const Config *config) {
+    unsigned long long numberOfChunks = countChunks(config);
+    unsigned long long chunkStart = (unsigned long long)job * CLUSTER_JOB_CHUNKS;
+    unsigned long long chunkCount = numberOfChunks - chunkStart < CLUSTER_JOB_CHUNKS ? numberOfChunks - chunkStart : CLUSTER_JOB_CHUNKS;
+
+    unsigned char message[CLUSTER_JOB_FIELDS * 8], *field = message;
+    field = putField(field, CLUSTER_MESSAGE_JOB);
+    field = putField(field, (uint64_t)job);
+    field = putField(field, config->series);
+    field = putField(field, config->summation);
+    field = putField(field, config->kernel);
+    field = putField(field, config->numberOfTerms);
+    field = putField(field, config->chunkSize);
+    field = putField(field, chunkStart);
+    putField(field, chunkCount);
+    if (!sendFully(worker->fd, message, sizeof(message))) {
+        return FALSE;
+    }
+    worker->job = job;
+    return TRUE;
+}//sendClusterJob()
+
+/* Recebe o resultado do lote em execução no worker 'worker' e, se o lote ainda não foi concluído por outro worker,
+   acumula-o em 'total' e no resumo do worker, marcando-o como concluído em 'jobs'.
+   Retorna TRUE se o resultado foi recebido ou FALSE se a conexão falhou.
+*/
+int receiveClusterResult(ClusterWorker *worker, ClusterJob *jobs, const Config *config, Accumulator *total) {
+    unsigned int numberOfThreads = worker->numberOfThreads;
+    size_t size = (CLUSTER_RESULT_FIELDS + (size_t)numberOfThreads * CLUSTER_THREAD_FIELDS) * 8;
+    unsigned char *message = (unsigned char *)malloc(size);
+    if (message == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    if (!receiveFully(worker->fd, message, size)) {
+        free(message);
+        return FALSE;
+    }
+    const unsigned char *field = message;
+    int job = (int)getField(&field);
+    KernelType kernel = (KernelType)getField(&field);
+    CompensatedSum sum;
+    sum.sum = getDouble(&field);
+    sum.compensation = getDouble(&field);
+    struct timeval start, end;
+    start.tv_sec = (time_t)getField(&field);
+    start.tv_usec = (suseconds_t)getField(&field);
+    end.tv_sec = (time_t)getField(&field);
+    end.tv_usec = (suseconds_t)getField(&field);
+    double duration = getDouble(&field);
+    if (job != worker->job) {
+        free(message);
+        return FALSE;
+    }
+    worker->job = CLUSTER_NO_JOB;
+
+    // Um lote repetido vale uma única vez: o resultado que chega depois do primeiro é descartado.
+    if (jobs[job].state != CLUSTER_JOB_DONE) {
+        jobs[job].state = CLUSTER_JOB_DONE;
+        accumulatorAdd(total, sum);
+        accumulatorAdd(&worker->partial, sum);
+
+        unsigned long long chunkStart = (unsigned long long)job * CLUSTER_JOB_CHUNKS;
+        unsigned long long termStart = chunkStart * config->chunkSize;
+        unsigned long long termEnd = (chunkStart + CLUSTER_JOB_CHUNKS) * config->chunkSize;
+        worker->terms += (termEnd < config->numberOfTerms ? termEnd : config->numberOfTerms) - termStart;
+        if (worker->jobs == 0) {
+            worker->start = start;
+        }
+        worker->end = end;
+        worker->busy += duration;
+        worker->kernel = kernel;
+        worker->jobs++;
+        for (unsigned int i = 0; i < numberOfThreads; i++) {
+            Thread *thread = &worker->threads[i];
+            thread->tid = (pid_t)getField(&field);
+            thread->time += getDouble(&field);
+            thread->terms += getField(&field);
+            thread->chunks += (unsigned int)getField(&field);
+            thread->steals += (unsigned int)getField(&field);
+            thread->cpu = (int)(int64_t)getField(&field);
+            thread->lastCpu = (int)(int64_t)getField(&field);
+            thread->cpuTime += getDouble(&field);
+            thread->voluntarySwitches += getField(&field);
+            thread->involuntarySwitches += getField(&field);
+            thread->migrations += getField(&field);
+            thread->cycles += getField(&field);
+            thread->instructions += getField(&field);
+            // Os contadores acumulados só valem se foram lidos em todos os lotes.
+            int counters = (int)getField(&field);
+            thread->hardwareCounters = worker->jobs == 1 ? counters : thread->hardwareCounters && counters;
+            double started = getDouble(&field);
+            thread->started = worker->jobs == 1 ? started : thread->started;
+            thread->finished = getDouble(&field);
+        }
+    }
+    free(message);
+    return TRUE;
+}//receiveClusterResult()
+
+/* Desconecta o worker 'worker' e devolve à fila de 'jobs' o lote que só ele executava. */
+void dropClusterWorker(ClusterWorker *worker, ClusterJob *jobs) {
+    if (worker->job != CLUSTER_NO_JOB) {
+        ClusterJob *job = &jobs[worker->job];
+        if (job->state == CLUSTER_JOB_RUNNING && job->owner == worker->number) {
+            job->state = CLUSTER_JOB_PENDING;
+        }
+        worker->job = CLUSTER_NO_JOB;
+    }
+    close(worker->fd);
+    worker->fd = -1;
+}//dropClusterWorker()
+
+/* Aceita a conexão pendente no socket 'listener', lê a apresentação do worker e o registra em 'worker' com o número 'number'.
+   Retorna TRUE se o worker foi registrado ou FALSE se a conexão ou a apresentação falhou.
+*/
+static int acceptClusterWorker(int listener, ClusterWorker *worker, unsigned int number) {
+    struct sockaddr_storage address;
+    socklen_t length = sizeof(address);
+    int fd = accept(listener, (struct sockaddr *)&address, &length);
+    if (fd < 0) {
+        return FALSE;
+    }
+    configureSocket(fd);
+
+    unsigned char message[CLUSTER_HELLO_FIELDS * 8];
+    const unsigned char *field = message;
+    if (!receiveFully(fd, message, sizeof(message)) || getField(&field) != CLUSTER_MAGIC) {
+        close(fd);
+        return FALSE;
+    }
+    pid_t pid = (pid_t)getField(&field);
+    uint64_t numberOfThreads = getField(&field);
+    if (numberOfThreads == 0 || numberOfThreads > MAXIMUM_NUMBER_OF_THREADS) {
+        close(fd);
+        return FALSE;
+    }
+
+    char host[NI_MAXHOST], service[NI_MAXSERV];
+    if (getnameinfo((struct sockaddr *)&address, length, host, sizeof(host), service, sizeof(service),
+                    NI_NUMERICHOST | NI_NUMERICSERV) != 0) {
+        snprintf(host, sizeof(host), "?");
+        snprintf(service, sizeof(service), "?");
+    }
+    memset(worker, 0, sizeof(ClusterWorker));
+    worker->threads = (Thread *)calloc(numberOfThreads, sizeof(Thread));
+    if (worker->threads == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    worker->fd = fd;
+    worker->job = CLUSTER_NO_JOB;
+    worker->number = number;
+    worker->pid = pid;
+    worker->numberOfThreads = (unsigned int)numberOfThreads;
+    snprintf(worker->address, STRING_DEFAULT_SIZE, "%.64s:%.16s", host, service);
+    return TRUE;
+}//acceptClusterWorker()
+
+/* Cria o socket TCP do coordenador, escutando em todas as interfaces na porta 'port'.
+   Em caso de falha, imprime uma mensagem de erro e encerra o programa.
+*/
+static int createListener(unsigned int port) {
+    int fd = socket(AF_INET6, SOCK_STREAM, 0);
+    int enable = 1, disable = 0;
+    struct sockaddr_in6 address;
+    memset(&address, 0, sizeof(address));
+    address.sin6_family = AF_INET6;
+    address.sin6_addr = in6addr_any;
+    address.sin6_port = htons((uint16_t)port);
+    // Um socket IPv6 sem IPV6_V6ONLY aceita também conexões IPv4 (127.0.0.1).
+    if (fd < 0
+        || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) != 0
+        || setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &disable, sizeof(disable)) != 0
+        || bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0
+        || listen(fd, CLUSTER_BACKLOG) != 0) {
+        perror(ERROR_CLUSTER_SOCKET);
+        exit(EXIT_FAILURE);
+    }
+    return fd;
+}//createListener()
+
+/* Retorna o primeiro lote pendente de 'jobs' a partir de '*next', avançando '*next' até ele, ou CLUSTER_NO_JOB se não há. */
+static int nextClusterJob(const ClusterJob *jobs, unsigned long long numberOfJobs, unsigned long long *next) {
+    while (*next < numberOfJobs && jobs[*next].state != CLUSTER_JOB_PENDING) {
+        (*next)++;
+    }
+    return *next < numberOfJobs ? (int)*next : CLUSTER_NO_JOB;
+}//nextClusterJob()
+
+/* Preenche 'processReport' com o resumo do trabalho aceito do worker 'worker'. */
+static void fillClusterReport(ProcessReport *processReport, const ClusterWorker *worker) {
+    char startTimeStr[9];
+    char endTimeStr[9];
+    struct tm startTm, endTm;
+    time_t startTimeSeconds = worker->start.tv_sec;
+    time_t endTimeSeconds = worker->end.tv_sec;
+    gmtime_r(&startTimeSeconds, &startTm);
+    gmtime_r(&endTimeSeconds, &endTm);
+    strftime(startTimeStr, sizeof(startTimeStr), TIME_FORMAT, &startTm);
+    strftime(endTimeStr, sizeof(endTimeStr), TIME_FORMAT, &endTm);
+
+    CompensatedSum partial = accumulatorResult(&worker->partial);
+    snprintf(processReport->identification, STRING_DEFAULT_SIZE, CLUSTER_REPORT_IDENTIFICATION, worker->number, worker->address, worker->pid);
+    snprintf(processReport->numberOfThreads, STRING_DEFAULT_SIZE, CLUSTER_REPORT_NUMBER_OF_THREADS, worker->numberOfThreads, kernelName(worker->kernel));
+    snprintf(processReport->start, STRING_DEFAULT_SIZE, PROCESS_REPORT_START, startTimeStr);
+    snprintf(processReport->end, STRING_DEFAULT_SIZE, PROCESS_REPORT_END, endTimeStr);
+    formatReport(processReport->duration, STRING_DEFAULT_SIZE, PROCESS_REPORT_DURATION, worker->busy);
+    snprintf(processReport->terms, STRING_DEFAULT_SIZE, CLUSTER_REPORT_TERMS, worker->terms, worker->jobs);
+    formatReport(processReport->partialSum, STRING_DEFAULT_SIZE, PROCESS_REPORT_PARTIAL_SUM, partial.sum + partial.compensation);
+}//fillClusterReport()
+
+/* Executa o coordenador do modo distribuído: aceita workers na porta config->coordinatorPort, entrega-lhes lotes de
+   CLUSTER_JOB_CHUNKS chunks, repete os lotes de workers mortos ou atrasados, reduz as somas parciais na ordem de chegada
+   e escreve o relatório e os arquivos pi%d.txt de cada worker.
+   Retorna TRUE se o cálculo terminou ou FALSE se ocorreu algum erro.
+*/
+int clusterCoordinator(const Config *config) {
+    unsigned long long numberOfJobs = (countChunks(config) + CLUSTER_JOB_CHUNKS - 1) / CLUSTER_JOB_CHUNKS;
+    ClusterJob *jobs = (ClusterJob *)calloc(numberOfJobs, sizeof(ClusterJob));
+    ClusterWorker *workers = (ClusterWorker *)calloc(CLUSTER_MAXIMUM_WORKERS, sizeof(ClusterWorker));
+    struct pollfd *fds = (struct pollfd *)calloc(CLUSTER_MAXIMUM_WORKERS + 1, sizeof(struct pollfd));
+    unsigned int *polled = (unsigned int *)calloc(CLUSTER_MAXIMUM_WORKERS, sizeof(unsigned int));
+    if (jobs == NULL || workers == NULL || fds == NULL || polled == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    int listener = createListener(config->coordinatorPort);
+    printf(CLUSTER_WAITING, getpid(), config->coordinatorPort, numberOfJobs, CLUSTER_JOB_CHUNKS);
+    fflush(stdout);
+
+    Accumulator total;
+    accumulatorInit(&total, config->summation);
+    unsigned int numberOfWorkers = 0, repeated = 0;
+    unsigned long long completed = 0, next = 0;
+    struct timespec startTime, endTime, now;
+    struct timeval runStart, runEnd;
+    int started = FALSE;
+
+    while (completed < numberOfJobs) {
+        // Entrega um lote a cada worker ocioso; a contagem do tempo começa no primeiro lote.
+        for (unsigned int i = 0; i < numberOfWorkers; i++) {
+            ClusterWorker *worker = &workers[i];
+            int job;
+            if (worker->fd < 0 || worker->job != CLUSTER_NO_JOB || (job = nextClusterJob(jobs, numberOfJobs, &next)) == CLUSTER_NO_JOB) {
+                continue;
+            }
+            if (!started) {
+                clock_gettime(DURATION_CLOCK, &startTime);
+                gettimeofday(&runStart, NULL);
+                started = TRUE;
+            }
+            if (!sendClusterJob(worker, job, config)) {
+                dropClusterWorker(worker, jobs);
+                continue;
+            }
+            if (jobs[job].owner != 0) {
+                repeated++;
+            }
+            jobs[job].state = CLUSTER_JOB_RUNNING;
+            jobs[job].owner = worker->number;
+            clock_gettime(DURATION_CLOCK, &jobs[job].assigned);
+        }
+
+        nfds_t count = 0;
+        fds[count].fd = listener;
+        fds[count++].events = POLLIN;
+        for (unsigned int i = 0; i < numberOfWorkers; i++) {
+            if (workers[i].fd >= 0) {
+                polled[count - 1] = i;
+                fds[count].fd = workers[i].fd;
+                fds[count++].events = POLLIN;
+            }
+        }
+        if (poll(fds, count, CLUSTER_POLL_INTERVAL_MS) < 0 && errno != EINTR) {
+            perror(ERROR_CLUSTER_SOCKET);
+            break;
+        }
+
+        for (nfds_t i = 1; i < count; i++) {
+            ClusterWorker *worker = &workers[polled[i - 1]];
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            // Um worker só escreve quando termina um lote; qualquer outro evento é a queda da conexão.
+            int wasCompleted = worker->job != CLUSTER_NO_JOB && jobs[worker->job].state == CLUSTER_JOB_DONE;
+            if (worker->job == CLUSTER_NO_JOB || !receiveClusterResult(worker, jobs, config, &total)) {
+                dropClusterWorker(worker, jobs);
+                next = 0;
+            }
+            else if (!wasCompleted) {
+                completed++;
+            }
+        }
+        if (fds[0].revents & POLLIN) {
+            // Os números dos workers começam em 1, de modo que o dono 0 indica um lote nunca entregue.
+            if (numberOfWorkers < CLUSTER_MAXIMUM_WORKERS && acceptClusterWorker(listener, &workers[numberOfWorkers], numberOfWorkers + 1)) {
+                accumulatorInit(&workers[numberOfWorkers].partial, config->summation);
+                numberOfWorkers++;
+            }
+        }
+
+        // Um lote atrasado volta para a fila sem desconectar o seu worker; o primeiro resultado que chegar vale.
+        clock_gettime(DURATION_CLOCK, &now);
+        for (unsigned int i = 0; i < numberOfWorkers; i++) {
+            int job = workers[i].job;
+            if (job != CLUSTER_NO_JOB && jobs[job].state == CLUSTER_JOB_RUNNING && jobs[job].owner == workers[i].number
+                && calculateDuration(jobs[job].assigned, now) > CLUSTER_JOB_TIMEOUT) {
+                jobs[job].state = CLUSTER_JOB_PENDING;
+                next = (unsigned long long)job < next ? (unsigned long long)job : next;
+            }
+        }
+    }
+    clock_gettime(DURATION_CLOCK, &endTime);
+    gettimeofday(&runEnd, NULL);
+    close(listener);
+
+    // Encerra os workers; os que ainda somam um lote repetido percebem o fechamento da conexão.
+    unsigned char message[CLUSTER_JOB_FIELDS * 8];
+    memset(message, 0, sizeof(message));
+    putField(message, CLUSTER_MESSAGE_DONE);
+    unsigned int contributors = 0;
+    for (unsigned int i = 0; i < numberOfWorkers; i++) {
+        if (workers[i].fd >= 0) {
+            sendFully(workers[i].fd, message, sizeof(message));
+            close(workers[i].fd);
+        }
+        contributors += workers[i].jobs > 0;
+    }
+
+    int success = completed == numberOfJobs;
+    if (success) {
+        Report report;
+        fillReportProcessFather(&report, config);
+        snprintf(report.message1, STRING_DEFAULT_SIZE, CLUSTER_REPORT_MESSAGE1, numberOfJobs, CLUSTER_JOB_CHUNKS, contributors, repeated);
+        snprintf(report.total, STRING_DEFAULT_SIZE, CLUSTER_REPORT_TOTAL, contributors);
+        report.numberOfProcesses = contributors;
+        report.processReports = (ProcessReport *)calloc(contributors, sizeof(ProcessReport));
+        if (report.processReports == NULL) {
+            perror(ERROR_MALLOC);
+            exit(EXIT_FAILURE);
+        }
+        double duration = calculateDuration(startTime, endTime);
+        PiResult result = seriesResult(config, accumulatorResult(&total));
+        long long run = runIdentifier(runStart);
+        Writer *structured = config->reportFile != NULL ? openWriter(config->reportFile, config->reportFormat, CSV_HEADER) : NULL;
+        if (structured != NULL) {
+            unsigned int numberOfThreads = 0;
+            for (unsigned int i = 0; i < numberOfWorkers; i++) {
+                numberOfThreads += workers[i].jobs > 0 ? workers[i].numberOfThreads : 0;
+            }
+            writeRunRecord(structured, run, config, contributors, numberOfThreads, result, runStart, runEnd, duration, NULL, FALSE);
+        }
+        Writer *metrics = config->metricsFile != NULL ? createMetricsFile(config->metricsFile) : NULL;
+        unsigned int index = 0;
+        for (unsigned int i = 0; i < numberOfWorkers; i++) {
+            ClusterWorker *worker = &workers[i];
+            if (worker->jobs == 0) {
+                continue;
+            }
+            fillClusterReport(&report.processReports[index++], worker);
+
+            FileName fileName;
+            snprintf(fileName, sizeof(FileName), FILE_NAME_PROCESS, worker->number);
+            String description;
+            snprintf(description, STRING_DEFAULT_SIZE, CLUSTER_FILE_DESCRIPTION, worker->numberOfThreads, worker->number, worker->address);
+            createFile(fileName, description, worker->threads, worker->numberOfThreads);
+            if (metrics != NULL) {
+                writeMetrics(metrics, worker->number, worker->threads, worker->numberOfThreads);
+            }
+            if (structured != NULL) {
+                CompensatedSum partial = accumulatorResult(&worker->partial);
+                writeProcessRecord(structured, run, worker->number, worker->pid, worker->numberOfThreads, worker->start, worker->end,
+                                   worker->busy, worker->terms, partial.sum + partial.compensation);
+                writeThreadRecords(structured, run, worker->number, worker->threads, worker->numberOfThreads);
+            }
+        }
+        if (metrics != NULL) {
+            closeWriter(metrics);
+        }
+        if (structured != NULL) {
+            closeWriter(structured);
+        }
+        fillReportTotal(&report, duration, result, config);
+        createReport(&report);
+        free(report.processReports);
+    }
+
+    for (unsigned int i = 0; i < numberOfWorkers; i++) {
+        free(workers[i].threads);
+    }
+    free(polled);
+    free(fds);
+    free(workers);
+    free(jobs);
+    return success;
+}//clusterCoordinator()
+
+/* Conecta-se ao coordenador 'host':'port', tentando CLUSTER_CONNECT_ATTEMPTS vezes para tolerar um coordenador
+   que ainda não começou a escutar.
+   Retorna o socket conectado ou -1 se todas as tentativas falharam.
+*/
+static int connectToCoordinator(const char *host, unsigned int port) {
+    struct addrinfo hints, *addresses;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    String service;
+    snprintf(service, STRING_DEFAULT_SIZE, "%u", port);
+    if (getaddrinfo(host, service, &hints, &addresses) != 0) {
+        return -1;
+    }
+    for (unsigned int attempt = 0; attempt < CLUSTER_CONNECT_ATTEMPTS; attempt++) {
+        for (struct addrinfo *address = addresses; address != NULL; address = address->ai_next) {
+            int fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (fd < 0) {
+                continue;
+            }
+            if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+                freeaddrinfo(addresses);
+                configureSocket(fd);
+                return fd;
+            }
+            close(fd);
+        }
+        usleep(CLUSTER_CONNECT_INTERVAL_MS * 1000);
+    }
+    freeaddrinfo(addresses);
+    return -1;
+}//connectToCoordinator()
+
+/* Executa um worker do modo distribuído: conecta-se ao coordenador config->coordinatorAddress e soma os lotes recebidos
+   com 'calculationOfNumberPi' e as suas próprias threads, afinidade e kernel, até receber CLUSTER_MESSAGE_DONE.
+   Retorna TRUE se o coordenador encerrou o cálculo ou FALSE se a conexão falhou.
+*/
+int clusterWorker(const Config *config) {
+    String host;
+    unsigned int port;
+    if (!parseClusterAddress(config->coordinatorAddress, host, &port)) {
+        fprintf(stderr, ERROR_CLUSTER_ADDRESS, config->coordinatorAddress);
+        return FALSE;
+    }
+    int fd = connectToCoordinator(host, port);
+    if (fd < 0) {
+        fprintf(stderr, ERROR_CLUSTER_CONNECT, config->coordinatorAddress);
+        return FALSE;
+    }
+    unsigned int numberOfThreads = config->numberOfThreads;
+    unsigned char hello[CLUSTER_HELLO_FIELDS * 8], *field = hello;
+    field = putField(field, CLUSTER_MAGIC);
+    field = putField(field, (uint64_t)getpid());
+    putField(field, numberOfThreads);
+
+    int *placement = createPlacement(config, 1, 0);
+    if (placement == NULL && config->affinity != AFFINITY_NONE) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    bindProcess(config, placement, numberOfThreads);
+    ThreadPool *pool = createThreadPool(numberOfThreads, placement);
+    if (pool == NULL) {
+        perror(ERROR_THREAD_POOL);
+        exit(EXIT_FAILURE);
+    }
+    size_t resultSize = (CLUSTER_RESULT_FIELDS + (size_t)numberOfThreads * CLUSTER_THREAD_FIELDS) * 8;
+    unsigned char *result = (unsigned char *)malloc(resultSize);
+    Thread *threads = (Thread *)malloc(numberOfThreads * sizeof(Thread));
+    if (result == NULL || threads == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+
+    unsigned int jobs = 0;
+    int success = sendFully(fd, hello, sizeof(hello));
+    // O worker espera o próximo lote sem limite de tempo: o coordenador pode demorar a ter trabalho para ele.
+    struct timeval noTimeout = {0, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &noTimeout, sizeof(noTimeout));
+    while (success) {
+        unsigned char message[CLUSTER_JOB_FIELDS * 8];
+        const unsigned char *job = message;
+        if (!receiveFully(fd, message, sizeof(message))) {
+            fprintf(stderr, ERROR_CLUSTER_CONNECTION, config->coordinatorAddress);
+            success = FALSE;
+            break;
+        }
+        if (getField(&job) == CLUSTER_MESSAGE_DONE) {
+            break;
+        }
+        uint64_t number = getField(&job);
+        uint64_t series = getField(&job);
+        uint64_t summation = getField(&job);
+        uint64_t kernel = getField(&job);
+        Config jobConfig = *config;
+        jobConfig.checkpoint = NULL;
+        jobConfig.cache = NULL;
+        jobConfig.stream = NULL;
+        jobConfig.numberOfTerms = getField(&job);
+        jobConfig.chunkSize = getField(&job);
+        TermRange chunks;
+        chunks.start = getField(&job);
+        chunks.count = getField(&job);
+        if (series == SERIES_AUTO || series >= NUMBER_OF_SERIES || summation >= NUMBER_OF_SUMMATIONS || kernel >= NUMBER_OF_KERNELS
+            || jobConfig.chunkSize == 0 || chunks.count == 0 || chunks.start + chunks.count > countChunks(&jobConfig)) {
+            fprintf(stderr, ERROR_CLUSTER_JOB, config->coordinatorAddress);
+            success = FALSE;
+            break;
+        }
+        jobConfig.series = (SeriesType)series;
+        jobConfig.summation = (SummationMode)summation;
+        // Cada nó usa o kernel pedido se a sua CPU o suporta, ou o melhor que ela tiver.
+        jobConfig.kernel = kernelSupported((KernelType)kernel) ? (KernelType)kernel : KERNEL_AUTO;
+        selectKernel(&jobConfig.kernel);
+        if (jobConfig.series != SERIES_LEIBNIZ) {
+            jobConfig.kernel = KERNEL_SCALAR;
+        }
+
+        struct timeval start, end;
+        struct timespec startTime, endTime;
+        gettimeofday(&start, NULL);
+        clock_gettime(DURATION_CLOCK, &startTime);
+        CompensatedSum sum = calculationOfNumberPi(&jobConfig, pool, chunks, threads, NULL);
+        clock_gettime(DURATION_CLOCK, &endTime);
+        gettimeofday(&end, NULL);
+
+        field = result;
+        field = putField(field, number);
+        field = putField(field, jobConfig.kernel);
+        field = putDouble(field, sum.sum);
+        field = putDouble(field, sum.compensation);
+        field = putField(field, (uint64_t)start.tv_sec);
+        field = putField(field, (uint64_t)start.tv_usec);
+        field = putField(field, (uint64_t)end.tv_sec);
+        field = putField(field, (uint64_t)end.tv_usec);
+        field = putDouble(field, calculateDuration(startTime, endTime));
+        for (unsigned int i = 0; i < numberOfThreads; i++) {
+            field = putField(field, (uint64_t)threads[i].tid);
+            field = putDouble(field, threads[i].time);
+            field = putField(field, threads[i].terms);
+            field = putField(field, threads[i].chunks);
+            field = putField(field, threads[i].steals);
+            field = putField(field, (uint64_t)(int64_t)threads[i].cpu);
+            field = putField(field, (uint64_t)(int64_t)threads[i].lastCpu);
+            field = putDouble(field, threads[i].cpuTime);
+            field = putField(field, threads[i].voluntarySwitches);
+            field = putField(field, threads[i].involuntarySwitches);
+            field = putField(field, threads[i].migrations);
+            field = putField(field, threads[i].cycles);
+            field = putField(field, threads[i].instructions);
+            field = putField(field, (uint64_t)threads[i].hardwareCounters);
+            field = putDouble(field, threads[i].started);
+            field = putDouble(field, threads[i].finished);
+        }
+        success = sendFully(fd, result, resultSize);
+        if (!success) {
+            fprintf(stderr, ERROR_CLUSTER_CONNECTION, config->coordinatorAddress);
+        }
+        jobs++;
+    }
+    close(fd);
+    destroyThreadPool(pool);
+    free(placement);
+    free(threads);
+    free(result);
+    if (success) {
+        printf(CLUSTER_WORKER_DONE, getpid(), jobs, config->coordinatorAddress);
+    }
+    return success;
+}//clusterWorker()
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <stdint.h>    // Requerido pelos campos de largura fixa do protocolo.
+#include <sys/time.h>  // Requerido pelos instantes exibidos dos lotes (struct timeval).
+#include "pi.h"
+
+// Identificação e versão do protocolo, enviada pelo worker ao se conectar ("PIC3").
+#define CLUSTER_MAGIC 0x50494333ULL
+
+// Chunks de cada lote distribuído pelo coordenador.
+#define CLUSTER_JOB_CHUNKS 16
+
+// Número máximo de workers conectados ao mesmo tempo.
+#define CLUSTER_MAXIMUM_WORKERS 256
+
+// Fila de conexões pendentes do socket do coordenador.
+#define CLUSTER_BACKLOG 64
+
+// Intervalo máximo de espera do laço do coordenador (em milissegundos).
+#define CLUSTER_POLL_INTERVAL_MS 1000
+
+// Tempo máximo de uma leitura ou escrita em um socket antes de considerar o outro lado morto (em segundos).
+#define CLUSTER_IO_TIMEOUT 10
+
+// Tempo depois do qual um lote em execução é entregue também a outro worker (em segundos); vale o primeiro resultado.
+#define CLUSTER_JOB_TIMEOUT 300
+
+// Tentativas de conexão do worker ao coordenador e intervalo entre elas (em milissegundos).
+#define CLUSTER_CONNECT_ATTEMPTS 50
+#define CLUSTER_CONNECT_INTERVAL_MS 100
+
+// Separador do endereço HOST:PORTA do coordenador.
+#define CLUSTER_PORT_SEPARATOR ':'
+
+// Maior porta TCP.
+#define CLUSTER_MAXIMUM_PORT 65535
+
+// Tamanho das mensagens, em campos de 64 bits big-endian.
+#define CLUSTER_HELLO_FIELDS 3
+#define CLUSTER_JOB_FIELDS 9
+#define CLUSTER_RESULT_FIELDS 9
+#define CLUSTER_THREAD_FIELDS 16
+
+// Lote de um worker ocioso.
+#define CLUSTER_NO_JOB -1
+
+// Formatações do relatório do modo distribuído.
+#define CLUSTER_WAITING "Coordenador (PID %d) aguardando workers na porta %u: %llu lotes de até %u chunks.\n"
+#define CLUSTER_REPORT_MESSAGE1 "Distribuídos %llu lotes de até %u chunks a %u workers (%u lotes repetidos)."
+#define CLUSTER_REPORT_TOTAL "- Resultado combinado dos %u workers"
+#define CLUSTER_REPORT_IDENTIFICATION "- Worker %u: %s (PID %d)"
+#define CLUSTER_REPORT_NUMBER_OF_THREADS "Nº de threads: %u (kernel %s)"
+#define CLUSTER_REPORT_TERMS "Termos: %llu (%u lotes)"
+#define CLUSTER_FILE_DESCRIPTION "Tempo em segundos acumulado das %u threads do worker %u (%s)."
+#define CLUSTER_WORKER_DONE "Worker (PID %d) somou %u lotes para o coordenador %s.\n"
+
+// Mensagens de erros.
+#define ERROR_CLUSTER_SOCKET "Erro no socket do modo distribuído"
+#define ERROR_CLUSTER_ADDRESS "Endereço do coordenador inválido: %s\n"
+#define ERROR_CLUSTER_CONNECT "ERRO: não foi possível conectar ao coordenador %s.\n"
+#define ERROR_CLUSTER_CONNECTION "ERRO: a conexão com o coordenador %s foi perdida.\n"
+#define ERROR_CLUSTER_JOB "ERRO: lote inválido recebido do coordenador %s.\n"
+
+// Tipos das mensagens enviadas pelo coordenador.
+typedef enum {
+   CLUSTER_MESSAGE_JOB,            // Lote a somar.
+   CLUSTER_MESSAGE_DONE            // Fim do cálculo: o worker encerra.
+} ClusterMessage;
+
+// Estado de um lote de chunks no coordenador.
+typedef enum {
+   CLUSTER_JOB_PENDING,            // Aguarda um worker (inclusive depois da morte ou do atraso de quem o recebeu).
+   CLUSTER_JOB_RUNNING,
+   CLUSTER_JOB_DONE
+} ClusterJobState;
+
+// Lote de chunks distribuído pelo coordenador.
+typedef struct {
+   ClusterJobState state;
+   unsigned int owner;             // Último worker que recebeu o lote.
+   struct timespec assigned;       // Quando o lote foi entregue ao último worker (DURATION_CLOCK).
+} ClusterJob;
+
+// Worker conectado ao coordenador e o resumo do trabalho que ele entregou.
+typedef struct {
+   int fd;                         // Socket do worker (-1 depois que ele se desconecta).
+   int job;                        // Lote em execução (CLUSTER_NO_JOB se ocioso).
+   unsigned int number;            // Worker 1, 2, ... na ordem de conexão.
+   pid_t pid;
+   unsigned int numberOfThreads;
+   KernelType kernel;              // Kernel usado pelo worker no último lote.
+   String address;
+   unsigned int jobs;              // Lotes aceitos do worker.
+   unsigned long long terms;
+   double busy;                    // Soma das durações dos lotes aceitos, medidas pelo worker com DURATION_CLOCK.
+   struct timeval start, end;      // Início do primeiro e fim do último lote aceito.
+   Accumulator partial;            // Soma parcial dos lotes aceitos.
+   Thread *threads;                // Tempos e trabalho de cada thread, acumulados entre os lotes.
+} ClusterWorker;
+
+/* Separa 'address' (HOST:PORTA) em 'host' e 'port'.
+   Retorna TRUE se o endereço é válido ou FALSE caso contrário.
+*/
+int parseClusterAddress(const char *address, String host, unsigned int *port);
+
+/* Envia os 'size' bytes de 'buffer' pelo socket 'fd'.
+   Retorna TRUE se todos os bytes foram enviados ou FALSE se a conexão falhou.
+*/
+int sendFully(int fd, const unsigned char *buffer, size_t size);
+
+/* Recebe exatamente 'size' bytes do socket 'fd' em 'buffer'.
+   Retorna TRUE se todos os bytes foram recebidos ou FALSE se a conexão foi fechada ou falhou.
+*/
+int receiveFully(int fd, unsigned char *buffer, size_t size);
+
+/* Envia ao worker 'worker' o lote 'job', os chunks [job CLUSTER_JOB_CHUNKS, (job + 1) CLUSTER_JOB_CHUNKS) da série config->series.
+   Retorna TRUE se o lote foi enviado ou FALSE se a conexão falhou.
+*/
+int sendClusterJob(ClusterWorker *worker, int job, const Config *config);
+
+/* Recebe o resultado do lote em execução no worker 'worker' e, se o lote ainda não foi concluído por outro worker,
+   acumula-o em 'total' e no resumo do worker, marcando-o como concluído em 'jobs'.
+   Retorna TRUE se o resultado foi recebido ou FALSE se a conexão falhou.
+*/
+int receiveClusterResult(ClusterWorker *worker, ClusterJob *jobs, const Config *config, Accumulator *total);
+
+/* Desconecta o worker 'worker' e devolve à fila de 'jobs' o lote que só ele executava. */
+void dropClusterWorker(ClusterWorker *worker, ClusterJob *jobs);
+
+/* Executa o coordenador do modo distribuído: aceita workers na porta config->coordinatorPort, entrega-lhes lotes de
+   CLUSTER_JOB_CHUNKS chunks, repete os lotes de workers mortos ou atrasados, reduz as somas parciais na ordem de chegada
+   e escreve o relatório e os arquivos pi%d.txt de cada worker.
+   Retorna TRUE se o cálculo terminou ou FALSE se ocorreu algum erro.
+*/
+int clusterCoordinator(const Config *config);
+
+/* Executa um worker do modo distribuído: conecta-se ao coordenador config->coordinatorAddress e soma os lotes recebidos
+   com 'calculationOfNumberPi' e as suas próprias threads, afinidade e kernel, até receber CLUSTER_MESSAGE_DONE.
+   Retorna TRUE se o coordenador encerrou o cálculo ou FALSE se a conexão falhou.
+*/
+int clusterWorker(const Config *config);
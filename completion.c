@@ -0,0 +1,176 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include "completion.h"
+
+/* Cria uma fila de conclusões vazia.
+   Retorna a fila ou NULL, com errno indicando a causa, se a alocação ou o eventfd falhar.
+*/
+CompletionQueue* createCompletionQueue() {
+    CompletionQueue *queue = (CompletionQueue *)aligned_alloc(CACHE_LINE_SIZE, sizeof(CompletionQueue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    memset(queue, 0, sizeof(CompletionQueue));
+    queue->eventfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (queue->eventfd < 0) {
+        free(queue);
+        return NULL;
+    }
+    // A posição i fica livre para o produtor que reservar a posição de número i.
+    for (unsigned long long i = 0; i < COMPLETION_QUEUE_SIZE; i++) {
+        queue->slots[i].sequence = i;
+    }
+    return queue;
+}//createCompletionQueue()
+
+/* Libera a fila 'queue' e o seu eventfd. */
+void destroyCompletionQueue(CompletionQueue *queue) {
+    close(queue->eventfd);
+    free(queue);
+}//destroyCompletionQueue()
+
+/* Publica 'completion' na fila 'queue', de qualquer thread, e acorda o consumidor se ele está dormindo. */
+void pushCompletion(CompletionQueue *queue, const Completion *completion) {
+    unsigned long long position = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+    CompletionSlot *slot;
+    for (;;) {
+        slot = &queue->slots[position & (COMPLETION_QUEUE_SIZE - 1)];
+        long long difference = (long long)(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - position);
+        if (difference == 0) {
+            // Em caso de falha, o compare-and-swap recarrega 'position' com a cauda atual.
+            if (__atomic_compare_exchange_n(&queue->tail, &position, position + 1, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        }
+        else {
+            // Fila cheia (a posição ainda guarda a conclusão da volta anterior) ou outro produtor reservou a posição.
+            if (difference < 0) {
+                sched_yield();
+            }
+            position = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+        }
+    }
+    slot->completion = *completion;
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+
+    // A barreira ordena a publicação antes da leitura de 'sleeping', casando com a barreira de waitCompletion.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&queue->sleeping, __ATOMIC_RELAXED) && __atomic_exchange_n(&queue->sleeping, FALSE, __ATOMIC_RELAXED)) {
+        unsigned long long one = 1;
+        if (write(queue->eventfd, &one, sizeof(one)) < 0) {
+            // O consumidor acorda de qualquer forma no fim do seu prazo.
+        }
+    }
+}//pushCompletion()
+
+/* Retira a conclusão mais antiga da fila 'queue' e a armazena em 'completion'. Só pode ser chamada pelo consumidor.
+   Retorna TRUE se havia uma conclusão ou FALSE se a fila está vazia.
+*/
+int popCompletion(CompletionQueue *queue, Completion *completion) {
+    CompletionSlot *slot = &queue->slots[queue->head & (COMPLETION_QUEUE_SIZE - 1)];
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != queue->head + 1) {
+        return FALSE;
+    }
+    *completion = slot->completion;
+    // Libera a posição para o produtor da próxima volta.
+    __atomic_store_n(&slot->sequence, queue->head + COMPLETION_QUEUE_SIZE, __ATOMIC_RELEASE);
+    queue->head++;
+    return TRUE;
+}//popCompletion()
+
+/* Espera no máximo 'timeout' segundos por uma conclusão na fila 'queue'. Só pode ser chamada pelo consumidor;
+   retorna antes do prazo se chegar uma conclusão ou um sinal.
+*/
+void waitCompletion(CompletionQueue *queue, double timeout) {
+    __atomic_store_n(&queue->sleeping, TRUE, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    // Uma conclusão publicada antes do anúncio não acordaria o consumidor: confere a fila de novo antes de dormir.
+    const CompletionSlot *slot = &queue->slots[queue->head & (COMPLETION_QUEUE_SIZE - 1)];
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != queue->head + 1) {
+        struct pollfd descriptor = {queue->eventfd, POLLIN, 0};
+        int milliseconds = timeout > 0.0 ? (int)(timeout * 1000.0) + 1 : 0;
+        poll(&descriptor, 1, milliseconds);
+    }
+    __atomic_store_n(&queue->sleeping, FALSE, __ATOMIC_RELAXED);
+    unsigned long long count;
+    if (read(queue->eventfd, &count, sizeof(count)) < 0) {
+        // EAGAIN: ninguém escreveu no eventfd.
+    }
+}//waitCompletion()
+
+/* Inicia o prefixo 'prefix' vazio, a partir do chunk 'start', reduzido com a estratégia 'mode'. */
+void initCompletionPrefix(CompletionPrefix *prefix, unsigned long long start, SummationMode mode) {
+    accumulatorInit(&prefix->accumulator, mode);
+    prefix->next = start;
+    prefix->terms = 0;
+    prefix->pending = NULL;
+    prefix->numberOfPending = 0;
+    prefix->capacity = 0;
+}//initCompletionPrefix()
+
+/* Acrescenta a conclusão 'completion' ao prefixo 'prefix': se ela é o próximo chunk, estende o prefixo com ela e com as
+   conclusões adiantadas que passam a ser contíguas; senão, guarda-a até que o prefixo a alcance. Se não houver memória
+   para guardá-la, a conclusão é descartada e o prefixo para antes dela, sem deixar de ser contíguo.
+*/
+void addCompletionPrefix(CompletionPrefix *prefix, const Completion *completion) {
+    if (completion->chunk != prefix->next) {
+        if (prefix->numberOfPending == prefix->capacity) {
+            size_t capacity = prefix->capacity > 0 ? 2 * prefix->capacity : COMPLETION_PREFIX_INITIAL;
+            Completion *pending = (Completion *)realloc(prefix->pending, capacity * sizeof(Completion));
+            if (pending == NULL) {
+                return;
+            }
+            prefix->pending = pending;
+            prefix->capacity = capacity;
+        }
+        // Sobe a nova conclusão no heap até que o pai tenha um chunk menor.
+        size_t child = prefix->numberOfPending++;
+        while (child > 0 && prefix->pending[(child - 1) / 2].chunk > completion->chunk) {
+            prefix->pending[child] = prefix->pending[(child - 1) / 2];
+            child = (child - 1) / 2;
+        }
+        prefix->pending[child] = *completion;
+        return;
+    }
+
+    accumulatorAdd(&prefix->accumulator, completion->sum);
+    prefix->terms += completion->terms;
+    prefix->next++;
+    while (prefix->numberOfPending > 0 && prefix->pending[0].chunk == prefix->next) {
+        accumulatorAdd(&prefix->accumulator, prefix->pending[0].sum);
+        prefix->terms += prefix->pending[0].terms;
+        prefix->next++;
+        // Desce a última conclusão a partir da raiz até que os filhos tenham chunks maiores.
+        Completion last = prefix->pending[--prefix->numberOfPending];
+        size_t parent = 0;
+        for (;;) {
+            size_t child = 2 * parent + 1;
+            if (child >= prefix->numberOfPending) {
+                break;
+            }
+            if (child + 1 < prefix->numberOfPending && prefix->pending[child + 1].chunk < prefix->pending[child].chunk) {
+                child++;
+            }
+            if (prefix->pending[child].chunk >= last.chunk) {
+                break;
+            }
+            prefix->pending[parent] = prefix->pending[child];
+            parent = child;
+        }
+        prefix->pending[parent] = last;
+    }
+}//addCompletionPrefix()
+
+/* Libera as conclusões adiantadas de 'prefix', que ficaram fora do prefixo. */
+void freeCompletionPrefix(CompletionPrefix *prefix) {
+    free(prefix->pending);
+    prefix->pending = NULL;
+    prefix->numberOfPending = 0;
+    prefix->capacity = 0;
+}//freeCompletionPrefix()
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "pi.h"
+
+// Capacidade da fila de conclusões (potência de 2). Com a fila cheia, o worker cede a CPU até o agregador esvaziá-la.
+#define COMPLETION_QUEUE_SIZE 4096
+
+// Chunk das conclusões que avisam que um worker terminou o trabalho submetido.
+#define COMPLETION_WORKER_DONE (~0ULL)
+
+// Capacidade inicial do heap das conclusões adiantadas de um prefixo; dobra quando fica cheio.
+#define COMPLETION_PREFIX_INITIAL 64
+
+// Conclusão de um chunk publicada por um worker: o chunk, os seus termos e a sua soma.
+typedef struct {
+   unsigned long long chunk;       // Chunk concluído, ou COMPLETION_WORKER_DONE quando o worker terminou.
+   unsigned long long terms;       // Termos do chunk.
+   CompensatedSum sum;
+   unsigned int worker;
+} Completion;
+
+// Prefixo contíguo das conclusões de um cálculo: reduz, na ordem dos chunks, as conclusões que chegam fora de ordem,
+// guardando as adiantadas em um heap mínimo pelo chunk até que o prefixo as alcance.
+typedef struct {
+   Accumulator accumulator;        // Soma dos chunks do prefixo.
+   unsigned long long next;        // Primeiro chunk que ainda não está no prefixo.
+   unsigned long long terms;       // Termos dos chunks do prefixo.
+   Completion *pending;            // Heap mínimo das conclusões adiantadas.
+   size_t numberOfPending, capacity;
+} CompletionPrefix;
+
+// Posição da fila: 'sequence' diz se a posição está livre para o produtor da volta 'sequence' ou cheia para o consumidor.
+typedef struct {
+   unsigned long long sequence;
+   Completion completion;
+} CompletionSlot;
+
+// Fila circular limitada sem travas com vários produtores (os workers) e um consumidor (o agregador de sumSeries).
+// Os produtores reservam posições com compare-and-swap em 'tail'; o consumidor dorme em um eventfd, acordado
+// apenas quando anunciou em 'sleeping' que vai dormir, de modo que o caminho comum não faz chamadas de sistema.
+typedef struct CompletionQueue {
+   unsigned long long tail __attribute__((aligned(CACHE_LINE_SIZE))); // Próxima posição dos produtores.
+   unsigned long long head __attribute__((aligned(CACHE_LINE_SIZE))); // Próxima posição do consumidor.
+   int sleeping;                   // TRUE enquanto o consumidor espera no eventfd.
+   int eventfd;
+   CompletionSlot slots[COMPLETION_QUEUE_SIZE];
+} CompletionQueue;
+
+/* Cria uma fila de conclusões vazia.
+   Retorna a fila ou NULL, com errno indicando a causa, se a alocação ou o eventfd falhar.
+*/
+CompletionQueue* createCompletionQueue();
+
+/* Libera a fila 'queue' e o seu eventfd. */
+void destroyCompletionQueue(CompletionQueue *queue);
+
+/* Publica 'completion' na fila 'queue', de qualquer thread, e acorda o consumidor se ele está dormindo. */
+void pushCompletion(CompletionQueue *queue, const Completion *completion);
+
+/* Retira a conclusão mais antiga da fila 'queue' e a armazena em 'completion'. Só pode ser chamada pelo consumidor.
+   Retorna TRUE se havia uma conclusão ou FALSE se a fila está vazia.
+*/
+int popCompletion(CompletionQueue *queue, Completion *completion);
+
+/* Espera no máximo 'timeout' segundos por uma conclusão na fila 'queue'. Só pode ser chamada pelo consumidor;
+   retorna antes do prazo se chegar uma conclusão ou um sinal.
+*/
+void waitCompletion(CompletionQueue *queue, double timeout);
+
+/* Inicia o prefixo 'prefix' vazio, a partir do chunk 'start', reduzido com a estratégia 'mode'. */
+void initCompletionPrefix(CompletionPrefix *prefix, unsigned long long start, SummationMode mode);
+
+/* Acrescenta a conclusão 'completion' ao prefixo 'prefix': se ela é o próximo chunk, estende o prefixo com ela e com as
+   conclusões adiantadas que passam a ser contíguas; senão, guarda-a até que o prefixo a alcance. Se não houver memória
+   para guardá-la, a conclusão é descartada e o prefixo para antes dela, sem deixar de ser contíguo.
+*/
+void addCompletionPrefix(CompletionPrefix *prefix, const Completion *completion);
+
+/* Libera as conclusões adiantadas de 'prefix', que ficaram fora do prefixo. */
+void freeCompletionPrefix(CompletionPrefix *prefix);
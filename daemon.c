@@ -0,0 +1,468 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <math.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include "daemon.h"
+#include "writer.h"
+
+// TRUE depois de SIGINT ou SIGTERM; o laço do serviço termina o lote em andamento e encerra.
+static volatile sig_atomic_t stopRequested = FALSE;
+
+/* Trata SIGINT e SIGTERM pedindo o encerramento do serviço. */
+static void handleStop(int signalNumber) {
+    (void)signalNumber;
+    stopRequested = TRUE;
+}//handleStop()
+
+/* Cria o socket Unix 'path', removendo um socket antigo com o mesmo caminho, e o coloca em escuta.
+   Retorna o descritor do socket ou -1 se ocorreu algum erro.
+*/
+static int listenDaemon(const char *path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, ERROR_DAEMON_PATH, path);
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener < 0) {
+        perror(ERROR_DAEMON_SOCKET);
+        return -1;
+    }
+    unlink(path);
+    if (bind(listener, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(listener, DAEMON_BACKLOG) < 0) {
+        perror(ERROR_DAEMON_SOCKET);
+        close(listener);
+        return -1;
+    }
+    return listener;
+}//listenDaemon()
+
+/* Fecha a conexão do cliente 'client'; os seus pedidos ainda no lote são calculados, mas não respondidos. */
+static void closeClient(DaemonClient *client) {
+    if (client->fd >= 0) {
+        close(client->fd);
+        client->fd = -1;
+    }
+}//closeClient()
+
+/* Envia os 'count' trechos de 'vectors' pela conexão 'fd' com writev, completando as escritas parciais.
+   Retorna TRUE se tudo foi enviado ou FALSE se a conexão caiu ou o cliente não leu por DAEMON_IO_TIMEOUT_MS.
+*/
+static int sendVectors(int fd, struct iovec *vectors, int count) {
+    while (count > 0) {
+        ssize_t written = writev(fd, vectors, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            struct pollfd descriptor = {fd, POLLOUT, 0};
+            if ((errno != EAGAIN && errno != EWOULDBLOCK) || poll(&descriptor, 1, DAEMON_IO_TIMEOUT_MS) <= 0) {
+                return FALSE;
+            }
+            continue;
+        }
+        // Descarta os trechos já enviados e avança dentro do primeiro trecho incompleto.
+        while (count > 0 && (size_t)written >= vectors->iov_len) {
+            written -= vectors->iov_len;
+            vectors++;
+            count--;
+        }
+        if (count > 0) {
+            vectors->iov_base = (char *)vectors->iov_base + written;
+            vectors->iov_len -= written;
+        }
+    }
+    return TRUE;
+}//sendVectors()
+
+/* Soma os 'count' termos a partir de 'start' da série de 'config' que não formam um chunk completo, com o mesmo kernel
+   que sumPartial usaria para um chunk parcial.
+*/
+static CompensatedSum sumTail(const Config *config, unsigned long long start, unsigned long long count) {
+    CompensatedKernel partialKernel = selectSpecializedKernel(config, 0);
+    if (partialKernel != NULL) {
+        return partialKernel(start, count);
+    }
+    return sumTerms(selectSeriesKernel(config), config->summation, start, count);
+}//sumTail()
+
+/* Retorna a configuração de 'daemon' para a série 'series': os kernels vetoriais só existem para a série de Leibniz. */
+static Config seriesConfig(const Daemon *daemon, SeriesType series) {
+    Config config = daemon->config;
+    config.series = series;
+    if (series != SERIES_LEIBNIZ) {
+        config.kernel = KERNEL_SCALAR;
+        config.acceleration = ACCELERATION_NONE;
+    }
+    return config;
+}//seriesConfig()
+
+/* Garante espaço para 'count' somas de chunks em 'store'.
+   Em caso de falha, imprime uma mensagem de erro e encerra o programa.
+*/
+static void reserveChunks(ChunkStore *store, unsigned long long count) {
+    if (count <= store->capacity) {
+        return;
+    }
+    unsigned long long capacity = store->capacity > 0 ? store->capacity : DAEMON_INITIAL_CHUNKS;
+    while (capacity < count) {
+        capacity *= 2;
+    }
+    CompensatedSum *sums = (CompensatedSum *)realloc(store->sums, capacity * sizeof(CompensatedSum));
+    if (sums == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    store->sums = sums;
+    store->capacity = capacity;
+}//reserveChunks()
+
+/* Ordena os pedidos do lote por série e, dentro da série, por termos; os pedidos com erro ficam no início. */
+static int compareRequests(const void *first, const void *second, void *context) {
+    const DaemonRequest *batch = (const DaemonRequest *)context;
+    const DaemonRequest *a = &batch[*(const unsigned int *)first];
+    const DaemonRequest *b = &batch[*(const unsigned int *)second];
+    if ((a->error == NULL) != (b->error == NULL)) {
+        return a->error == NULL ? 1 : -1;
+    }
+    if (a->series != b->series) {
+        return a->series < b->series ? -1 : 1;
+    }
+    return a->terms < b->terms ? -1 : (a->terms > b->terms ? 1 : 0);
+}//compareRequests()
+
+/* Calcula o lote de 'daemon' e envia as respostas. Para cada série, os chunks completos que algum pedido usa e que ainda
+   não estão guardados são somados uma única vez, com calculationOfNumberPi sobre o pool aquecido; depois, com os pedidos
+   em ordem crescente de termos, o prefixo dos chunks guardados é acumulado uma só vez para todos os pedidos da série,
+   e cada pedido soma apenas o seu chunk final incompleto (também compartilhado entre pedidos com os mesmos termos).
+*/
+static void runBatch(Daemon *daemon) {
+    unsigned int batchSize = daemon->batchSize;
+    double batchStart = monotonicSeconds();
+    for (unsigned int i = 0; i < batchSize; i++) {
+        daemon->order[i] = i;
+    }
+    qsort_r(daemon->order, batchSize, sizeof(unsigned int), compareRequests, daemon->batch);
+    locale_t previous = uselocale(daemon->numeric);
+
+    unsigned int i = 0;
+    while (i < batchSize) {
+        const DaemonRequest *first = &daemon->batch[daemon->order[i]];
+        if (first->error != NULL) {
+            snprintf(daemon->responses[daemon->order[i]], DAEMON_RESPONSE_SIZE, DAEMON_RESPONSE_ERROR, first->id, first->error);
+            i++;
+            continue;
+        }
+
+        // Os pedidos da série ocupam order[i..end); o último é o que usa mais chunks.
+        SeriesType series = first->series;
+        unsigned int end = i;
+        while (end < batchSize && daemon->batch[daemon->order[end]].error == NULL && daemon->batch[daemon->order[end]].series == series) {
+            end++;
+        }
+        Config config = seriesConfig(daemon, series);
+        ChunkStore *store = &daemon->stores[series];
+        unsigned long long stored = store->count;
+        unsigned long long needed = daemon->batch[daemon->order[end - 1]].terms / config.chunkSize;
+        if (needed > stored) {
+            reserveChunks(store, needed);
+            Config chunkConfig = config;
+            chunkConfig.numberOfTerms = needed * config.chunkSize;
+            chunkConfig.chunkSums = store->sums;
+            TermRange chunks = {stored, needed - stored};
+            calculationOfNumberPi(&chunkConfig, daemon->pool, chunks, daemon->threads, NULL);
+            store->count = needed;
+            daemon->computedChunks += chunks.count;
+        }
+
+        Accumulator prefix;
+        accumulatorInit(&prefix, config.summation);
+        unsigned long long position = 0;
+        CompensatedSum tail = {0.0, 0.0};
+        unsigned long long tailTerms = 0;
+        for (; i < end; i++) {
+            const DaemonRequest *request = &daemon->batch[daemon->order[i]];
+            unsigned long long full = request->terms / config.chunkSize;
+            while (position < full) {
+                accumulatorAdd(&prefix, store->sums[position++]);
+            }
+            Accumulator total = prefix;
+            if (request->terms > full * config.chunkSize) {
+                if (tailTerms != request->terms) {
+                    tail = sumTail(&config, full * config.chunkSize, request->terms - full * config.chunkSize);
+                    tailTerms = request->terms;
+                }
+                accumulatorAdd(&total, tail);
+            }
+            config.numberOfTerms = request->terms;
+            PiResult result = seriesResult(&config, accumulatorResult(&total));
+            unsigned long long reused = full < stored ? full : stored;
+            double ready = monotonicSeconds();
+            snprintf(daemon->responses[daemon->order[i]], DAEMON_RESPONSE_SIZE, DAEMON_RESPONSE, request->id, seriesName(series),
+                     request->terms, result.pi, result.rawPi, result.pi - M_PI, batchSize, full - reused, reused,
+                     batchStart - request->received, ready - batchStart, ready - request->received);
+        }
+    }
+    uselocale(previous);
+
+    // Um writev por cliente, com as respostas na ordem em que os seus pedidos chegaram.
+    struct iovec vectors[DAEMON_MAXIMUM_BATCH];
+    for (unsigned int client = 0; client < daemon->numberOfClients; client++) {
+        int count = 0;
+        for (unsigned int j = 0; j < batchSize; j++) {
+            if (daemon->batch[j].client == client) {
+                vectors[count].iov_base = daemon->responses[j];
+                vectors[count].iov_len = strlen(daemon->responses[j]);
+                count++;
+            }
+        }
+        if (count > 0 && daemon->clients[client].fd >= 0 && !sendVectors(daemon->clients[client].fd, vectors, count)) {
+            closeClient(&daemon->clients[client]);
+        }
+    }
+    daemon->requests += batchSize;
+    daemon->batches++;
+    daemon->batchSize = 0;
+}//runBatch()
+
+/* Interpreta a linha 'line' recebida do cliente 'client' e a acrescenta ao lote de 'daemon', com o erro de
+   'error' se ele não for NULL ou se a linha não é um pedido válido. Com o lote cheio, calcula-o antes.
+*/
+static void addRequest(Daemon *daemon, unsigned int client, char *line, const char *error) {
+    if (daemon->batchSize == DAEMON_MAXIMUM_BATCH) {
+        runBatch(daemon);
+    }
+    DaemonRequest *request = &daemon->batch[daemon->batchSize++];
+    request->id = daemon->nextId++;
+    request->client = client;
+    request->series = daemon->config.series;
+    request->terms = 0;
+    request->received = monotonicSeconds();
+    request->error = error;
+    if (error != NULL) {
+        return;
+    }
+
+    char seriesText[DAEMON_SERIES_SIZE];
+    char extra;
+    int fields = sscanf(line, DAEMON_REQUEST_FORMAT, &request->terms, seriesText, &extra);
+    if (fields < DAEMON_REQUEST_MINIMUM_FIELDS || fields > DAEMON_REQUEST_MAXIMUM_FIELDS || line[strspn(line, " \t")] == '-') {
+        request->error = DAEMON_ERROR_SYNTAX;
+        return;
+    }
+    if (fields == DAEMON_REQUEST_MAXIMUM_FIELDS) {
+        // SERIES_AUTO escolhe a série pelas casas decimais, que um pedido por termos não tem.
+        request->error = DAEMON_ERROR_SERIES;
+        for (int series = SERIES_AUTO + 1; series < NUMBER_OF_SERIES; series++) {
+            if (strcmp(seriesText, seriesName((SeriesType)series)) == 0) {
+                request->series = (SeriesType)series;
+                request->error = NULL;
+            }
+        }
+        if (request->error != NULL) {
+            return;
+        }
+    }
+    if (request->terms == 0 || request->terms > DAEMON_MAXIMUM_TERMS || request->terms / daemon->config.chunkSize > DAEMON_MAXIMUM_CHUNKS) {
+        request->error = DAEMON_ERROR_TERMS;
+    }
+}//addRequest()
+
+/* Lê o que chegou na conexão do cliente 'index' de 'daemon' e acrescenta ao lote um pedido por linha completa.
+   Fecha a conexão quando o cliente a encerra ou ela falha.
+*/
+static void readClient(Daemon *daemon, unsigned int index) {
+    DaemonClient *client = &daemon->clients[index];
+    ssize_t received = read(client->fd, client->buffer + client->length, DAEMON_LINE_SIZE - 1 - client->length);
+    if (received <= 0) {
+        if (received == 0 || (errno != EAGAIN && errno != EINTR)) {
+            closeClient(client);
+        }
+        return;
+    }
+    client->length += received;
+    client->buffer[client->length] = NULL_CHAR;
+
+    char *line = client->buffer;
+    char *newline;
+    while ((newline = strchr(line, NEW_LINE)) != NULL) {
+        *newline = NULL_CHAR;
+        if (newline > line && newline[-1] == '\r') {
+            newline[-1] = NULL_CHAR;
+        }
+        if (client->discarding) {
+            client->discarding = FALSE;
+        }
+        else if (line[strspn(line, " \t")] != NULL_CHAR) {
+            addRequest(daemon, index, line, NULL);
+        }
+        line = newline + 1;
+    }
+    client->length -= line - client->buffer;
+    memmove(client->buffer, line, client->length);
+    // Uma linha que não cabe no buffer é respondida com erro e descartada até a próxima quebra de linha.
+    if (client->length == DAEMON_LINE_SIZE - 1) {
+        if (!client->discarding) {
+            addRequest(daemon, index, NULL, DAEMON_ERROR_LINE);
+        }
+        client->discarding = TRUE;
+        client->length = 0;
+    }
+}//readClient()
+
+/* Aceita as conexões pendentes no socket de 'daemon'; as que excedem DAEMON_MAXIMUM_CLIENTS são fechadas. */
+static void acceptClients(Daemon *daemon) {
+    int fd;
+    while ((fd = accept4(daemon->listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        if (daemon->numberOfClients == DAEMON_MAXIMUM_CLIENTS) {
+            close(fd);
+            continue;
+        }
+        DaemonClient *client = &daemon->clients[daemon->numberOfClients++];
+        client->fd = fd;
+        client->length = 0;
+        client->discarding = FALSE;
+    }
+}//acceptClients()
+
+/* Remove de 'daemon' os clientes cujas conexões foram fechadas. Só pode ser chamada com o lote vazio, pois os pedidos
+   guardam o índice do cliente.
+*/
+static void compactClients(Daemon *daemon) {
+    unsigned int kept = 0;
+    for (unsigned int i = 0; i < daemon->numberOfClients; i++) {
+        if (daemon->clients[i].fd >= 0) {
+            if (kept != i) {
+                daemon->clients[kept] = daemon->clients[i];
+            }
+            kept++;
+        }
+    }
+    daemon->numberOfClients = kept;
+}//compactClients()
+
+/* Executa o serviço de longa duração no socket Unix config->daemonSocket até receber SIGINT ou SIGTERM.
+   Cada linha recebida é um pedido "TERMOS [SERIE]"; os pedidos que chegam juntos formam um lote, cujos chunks completos
+   ainda não calculados são somados uma única vez por calculationOfNumberPi e guardados para os lotes seguintes.
+   Cada pedido recebe uma linha JSON com a estimativa e as suas métricas de latência.
+   Retorna TRUE se o serviço foi encerrado por um sinal ou FALSE se ocorreu algum erro.
+*/
+int serveDaemon(const Config *config) {
+    Daemon *daemon = (Daemon *)calloc(1, sizeof(Daemon));
+    if (daemon == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    daemon->listener = listenDaemon(config->daemonSocket);
+    if (daemon->listener < 0) {
+        free(daemon);
+        return FALSE;
+    }
+    // O serviço soma apenas na memória: sem checkpoint, cache, modo incremental, prazo ou progresso.
+    daemon->config = *config;
+    daemon->config.numberOfProcesses = 1;
+    daemon->config.checkpoint = NULL;
+    daemon->config.cache = NULL;
+    daemon->config.stream = NULL;
+    daemon->config.deadlineAt = 0.0;
+    daemon->config.progress = NULL;
+    daemon->config.cancel = NULL;
+    daemon->config.chunkSums = NULL;
+    daemon->numeric = newlocale(LC_NUMERIC_MASK, WRITER_LOCALE, (locale_t)0);
+    daemon->placement = createPlacement(&daemon->config, 1, 0);
+    if (daemon->placement == NULL && daemon->config.affinity != AFFINITY_NONE) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    daemon->pool = createThreadPool(daemon->config.numberOfThreads, daemon->placement);
+    if (daemon->pool == NULL) {
+        perror(ERROR_THREAD_POOL);
+        exit(EXIT_FAILURE);
+    }
+    daemon->threads = (Thread *)calloc(daemon->config.numberOfThreads, sizeof(Thread));
+    if (daemon->threads == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+
+    // Sem SA_RESTART, o sinal interrompe o poll() e o laço termina; um cliente que fecha a conexão não derruba o serviço.
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleStop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    printf(DAEMON_LISTENING, getpid(), config->daemonSocket, daemon->config.numberOfThreads);
+    fflush(stdout);
+
+    struct pollfd descriptors[DAEMON_MAXIMUM_CLIENTS + 1];
+    while (!stopRequested) {
+        descriptors[0].fd = daemon->listener;
+        descriptors[0].events = POLLIN;
+        for (unsigned int i = 0; i < daemon->numberOfClients; i++) {
+            descriptors[i + 1].fd = daemon->clients[i].fd;
+            descriptors[i + 1].events = POLLIN;
+        }
+        // Com um lote em formação, espera no máximo até o fim da sua janela de agrupamento.
+        int timeout = -1;
+        if (daemon->batchSize > 0) {
+            double remaining = daemon->batch[0].received + DAEMON_BATCH_WINDOW_MS / 1000.0 - monotonicSeconds();
+            timeout = remaining > 0.0 ? (int)ceil(remaining * 1000.0) : 0;
+        }
+        int ready = poll(descriptors, daemon->numberOfClients + 1, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror(ERROR_DAEMON_SOCKET);
+            break;
+        }
+        unsigned int numberOfClients = daemon->numberOfClients;
+        for (unsigned int i = 0; i < numberOfClients; i++) {
+            if (descriptors[i + 1].revents != 0 && daemon->clients[i].fd >= 0) {
+                readClient(daemon, i);
+            }
+        }
+        if (descriptors[0].revents & POLLIN) {
+            acceptClients(daemon);
+        }
+        if (daemon->batchSize > 0 && monotonicSeconds() >= daemon->batch[0].received + DAEMON_BATCH_WINDOW_MS / 1000.0) {
+            runBatch(daemon);
+        }
+        if (daemon->batchSize == 0) {
+            compactClients(daemon);
+        }
+    }
+    if (daemon->batchSize > 0) {
+        runBatch(daemon);
+    }
+    printf(DAEMON_STOPPED, daemon->requests, daemon->batches, daemon->computedChunks);
+
+    for (unsigned int i = 0; i < daemon->numberOfClients; i++) {
+        closeClient(&daemon->clients[i]);
+    }
+    close(daemon->listener);
+    unlink(config->daemonSocket);
+    destroyThreadPool(daemon->pool);
+    for (int series = 0; series < NUMBER_OF_SERIES; series++) {
+        free(daemon->stores[series].sums);
+    }
+    freelocale(daemon->numeric);
+    free(daemon->threads);
+    free(daemon->placement);
+    free(daemon);
+    return stopRequested;
+}//serveDaemon()
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <locale.h>    // Requerido pela localidade numérica fixa das respostas (locale_t).
+#include "pi.h"
+
+// Conexões simultâneas de clientes aceitas pelo serviço.
+#define DAEMON_MAXIMUM_CLIENTS 64
+
+// Pedidos de um mesmo lote; os que chegarem com o lote cheio esperam o lote seguinte.
+#define DAEMON_MAXIMUM_BATCH 1024
+
+// Tamanho máximo de uma linha de pedido, incluindo a quebra de linha.
+#define DAEMON_LINE_SIZE 256
+
+// Tamanho máximo de uma linha de resposta.
+#define DAEMON_RESPONSE_SIZE 512
+
+// Janela de agrupamento: depois do primeiro pedido de um lote, espera outros por este tempo antes de calcular (em milissegundos).
+#define DAEMON_BATCH_WINDOW_MS 2
+
+// Fila de conexões pendentes do socket do serviço.
+#define DAEMON_BACKLOG 64
+
+// Capacidade inicial, em chunks, das somas guardadas de cada série; dobra quando um pedido precisa de mais.
+#define DAEMON_INITIAL_CHUNKS 64
+
+// Espera máxima para enviar as respostas de um lote a um cliente que não as lê; depois disso a conexão é fechada (em milissegundos).
+#define DAEMON_IO_TIMEOUT_MS 1000
+
+// Limites de um pedido: os chunks completos de cada série ficam guardados em memória enquanto o serviço existir.
+#define DAEMON_MAXIMUM_TERMS 1000000000000ULL
+#define DAEMON_MAXIMUM_CHUNKS 16777216ULL
+
+// Campos de um pedido: os termos e, opcionalmente, a série (padrão: a série do serviço). Um terceiro campo é um erro.
+#define DAEMON_REQUEST_FORMAT "%llu %31s %c"
+#define DAEMON_REQUEST_MINIMUM_FIELDS 1
+#define DAEMON_REQUEST_MAXIMUM_FIELDS 2
+#define DAEMON_SERIES_SIZE 32
+
+// Respostas, uma linha JSON por pedido, na ordem em que os pedidos do mesmo cliente chegaram.
+#define DAEMON_RESPONSE "{\"id\":%llu,\"series\":\"%s\",\"terms\":%llu,\"estimate\":%.17g,\"raw_estimate\":%.17g,\"error\":%.17g," \
+                        "\"batch\":%u,\"chunks_computed\":%llu,\"chunks_reused\":%llu,\"queue_s\":%.9f,\"compute_s\":%.9f,\"latency_s\":%.9f}\n"
+#define DAEMON_RESPONSE_ERROR "{\"id\":%llu,\"error\":\"%s\"}\n"
+#define DAEMON_ERROR_SYNTAX "pedido inválido: use TERMOS [SERIE]"
+#define DAEMON_ERROR_TERMS "número de termos fora dos limites"
+#define DAEMON_ERROR_SERIES "série desconhecida"
+#define DAEMON_ERROR_LINE "linha longa demais"
+
+// Mensagens do serviço.
+#define DAEMON_LISTENING "Serviço (PID %d) aguardando pedidos em %s com %u threads.\n"
+#define DAEMON_STOPPED "Serviço encerrado: %llu pedidos em %llu lotes, %llu chunks calculados.\n"
+
+// Mensagens de erros.
+#define ERROR_DAEMON_SOCKET "Erro no socket do serviço"
+#define ERROR_DAEMON_PATH "Caminho do socket do serviço longo demais: %s\n"
+
+// Conexão de um cliente e o texto recebido que ainda não forma uma linha completa.
+typedef struct {
+   int fd;                         // Descritor da conexão, ou -1 depois que ela foi fechada.
+   size_t length;                  // Bytes ocupados em 'buffer'.
+   int discarding;                 // TRUE enquanto descarta o resto de uma linha longa demais.
+   char buffer[DAEMON_LINE_SIZE];
+} DaemonClient;
+
+// Pedido de um lote: os termos pedidos, a série e os instantes usados nas métricas de latência.
+typedef struct {
+   unsigned long long id;          // Identificador do pedido, crescente desde o início do serviço.
+   unsigned int client;            // Índice do cliente em Daemon.clients.
+   SeriesType series;
+   unsigned long long terms;
+   double received;                // Instante em que a linha do pedido chegou (DURATION_CLOCK).
+   const char *error;              // Erro do pedido, respondido na sua vez, ou NULL se o pedido é válido.
+} DaemonRequest;
+
+// Somas dos chunks completos de uma série já calculados pelo serviço: os chunks 0 a count - 1.
+typedef struct {
+   CompensatedSum *sums;
+   unsigned long long count;
+   unsigned long long capacity;
+} ChunkStore;
+
+// Estado do serviço: o pool mantido aquecido entre os lotes, os clientes, o lote em formação e as somas guardadas.
+typedef struct {
+   Config config;                  // Configuração do serviço (threads, chunk, kernel, soma e aceleração).
+   ThreadPool *pool;
+   int *placement;                 // CPU de cada thread do pool (NULL sem afinidade).
+   Thread *threads;                // Estatísticas das threads de calculationOfNumberPi, reaproveitadas entre os lotes.
+   int listener;                   // Socket Unix que aceita as conexões.
+   locale_t numeric;               // Localidade dos números das respostas (WRITER_LOCALE).
+   DaemonClient clients[DAEMON_MAXIMUM_CLIENTS];
+   unsigned int numberOfClients;
+   DaemonRequest batch[DAEMON_MAXIMUM_BATCH];
+   unsigned int batchSize;
+   unsigned int order[DAEMON_MAXIMUM_BATCH];             // Pedidos do lote ordenados por série e termos.
+   char responses[DAEMON_MAXIMUM_BATCH][DAEMON_RESPONSE_SIZE]; // Resposta de cada pedido do lote.
+   ChunkStore stores[NUMBER_OF_SERIES];
+   unsigned long long nextId;
+   unsigned long long requests, batches, computedChunks; // Totais exibidos no encerramento.
+} Daemon;
+
+/* Executa o serviço de longa duração no socket Unix config->daemonSocket até receber SIGINT ou SIGTERM.
+   Cada linha recebida é um pedido "TERMOS [SERIE]"; os pedidos que chegam juntos formam um lote, cujos chunks completos
+   ainda não calculados são somados uma única vez por calculationOfNumberPi e guardados para os lotes seguintes.
+   Cada pedido recebe uma linha JSON com a estimativa e as suas métricas de latência.
+   Retorna TRUE se o serviço foi encerrado por um sinal ou FALSE se ocorreu algum erro.
+*/
+int serveDaemon(const Config *config);
@@ -0,0 +1,219 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "pi.h"
+#include "engine.h"
+
+// Os enums públicos de engine.h repetem, na mesma ordem, os enums internos de pi.h; a conversão é uma simples troca de tipo.
+_Static_assert((int)ENGINE_SERIES_CHUDNOVSKY == SERIES_CHUDNOVSKY && (int)ENGINE_KERNEL_NEWTON == KERNEL_NEWTON
+               && (int)ENGINE_SUMMATION_DOUBLE_DOUBLE == SUMMATION_DOUBLE_DOUBLE && (int)ENGINE_ACCELERATION_EULER == ACCELERATION_EULER
+               && (int)ENGINE_AFFINITY_NUMA == AFFINITY_NUMA && (int)ENGINE_CANCEL_REQUEST == CANCEL_REQUEST
+               && ENGINE_CPU_NOT_PINNED == CPU_NOT_PINNED, "enums de engine.h fora da ordem de pi.h");
+
+// Motor de cálculo embutido: um pool de threads persistente e a configuração resolvida, sem processos filhos.
+// Cálculos no mesmo motor são serializados pela trava; motores distintos calculam em paralelo.
+struct Engine {
+   pthread_mutex_t mutex;            // Serializa os cálculos do motor.
+   Config config;                    // Configuração resolvida (série, kernel, termos e threads).
+   ThreadPool *pool;
+   int *placement;                   // CPU de cada thread do pool (NULL sem afinidade).
+   int cancel;                       // Pedido de cancelamento do cálculo em andamento (ou do próximo).
+   EngineProgressCallback progress;  // Callback de progresso do programa hospedeiro (NULL sem callback).
+   void *progressContext;
+};
+
+/* Preenche 'config' com a configuração padrão: os mesmos padrões do programa de linha de comando, exceto a afinidade,
+   que é ENGINE_AFFINITY_NONE para não fixar as threads do processo hospedeiro.
+*/
+void defaultEngineConfig(EngineConfig *config) {
+    memset(config, 0, sizeof(EngineConfig));
+    config->series = ENGINE_SERIES_LEIBNIZ;
+    config->kernel = ENGINE_KERNEL_AUTO;
+    config->summation = ENGINE_SUMMATION_NAIVE;
+    config->acceleration = ENGINE_ACCELERATION_NONE;
+    config->affinity = ENGINE_AFFINITY_NONE;
+}//defaultEngineConfig()
+
+/* Repassa o progresso 'progress' de sumSeries ao callback do programa hospedeiro do motor 'context'.
+   Retorna o que o callback retornar (FALSE cancela o cálculo).
+*/
+static int forwardProgress(const Progress *progress, void *context) {
+    const Engine *engine = (const Engine *)context;
+    EngineProgress current = {
+        .terms = progress->terms,
+        .totalTerms = progress->totalTerms,
+        .chunks = progress->chunks,
+        .totalChunks = progress->totalChunks,
+        .sum = progress->sum.sum + progress->sum.compensation,
+        .elapsed = progress->elapsed
+    };
+    return engine->progress(&current, engine->progressContext);
+}//forwardProgress()
+
+/* Resolve em 'resolved' a configuração do motor 'config', com as mesmas regras de parseConfig.
+   Retorna TRUE se a configuração é válida ou FALSE caso contrário.
+*/
+static int resolveEngineConfig(const EngineConfig *config, Config *resolved) {
+    if ((unsigned int)config->series >= NUMBER_OF_SERIES || (unsigned int)config->kernel >= NUMBER_OF_KERNELS
+        || (unsigned int)config->summation >= NUMBER_OF_SUMMATIONS || (unsigned int)config->acceleration >= NUMBER_OF_ACCELERATIONS
+        || (unsigned int)config->affinity > AFFINITY_NUMA
+        || config->numberOfThreads > MAXIMUM_NUMBER_OF_THREADS || config->digits > MAXIMUM_DOUBLE_DIGITS
+        || config->numberOfTerms > ULLONG_MAX / 2 || config->chunkSize > ULLONG_MAX / 2 || config->deadline < 0.0) {
+        return FALSE;
+    }
+    memset(resolved, 0, sizeof(Config));
+    resolved->numberOfProcesses = 1;
+    resolved->numberOfThreads = config->numberOfThreads > 0 ? config->numberOfThreads : detectNumberOfThreads();
+    resolved->digits = config->digits > 0 ? config->digits : DECIMAL_PLACES;
+    resolved->series = config->series == ENGINE_SERIES_AUTO ? cheapestSeries(resolved->digits) : (SeriesType)config->series;
+    resolved->numberOfTerms = config->numberOfTerms > 0 ? config->numberOfTerms : getSeries(resolved->series)->termsForDigits(resolved->digits);
+    resolved->chunkSize = config->chunkSize > 0 ? config->chunkSize : DEFAULT_CHUNK_SIZE;
+    resolved->summation = (SummationMode)config->summation;
+    resolved->acceleration = (AccelerationMode)config->acceleration;
+    resolved->affinity = (AffinityPolicy)config->affinity;
+    resolved->hardwareCounters = config->hardwareCounters ? TRUE : FALSE;
+    resolved->deadline = config->deadline;
+    resolved->reportFormat = REPORT_JSON;
+    if (resolved->acceleration != ACCELERATION_NONE && resolved->series != SERIES_LEIBNIZ) {
+        return FALSE;
+    }
+    resolved->kernel = (KernelType)config->kernel;
+    if (selectKernel(&resolved->kernel) == NULL) {
+        return FALSE;
+    }
+    // Os kernels vetoriais só existem para a série de Leibniz.
+    if (resolved->series != SERIES_LEIBNIZ) {
+        resolved->kernel = KERNEL_SCALAR;
+    }
+    if (resolved->numberOfThreads > resolved->numberOfTerms) {
+        resolved->numberOfThreads = (unsigned int)resolved->numberOfTerms;
+    }
+    return TRUE;
+}//resolveEngineConfig()
+
+/* Cria um motor com a configuração 'config' e o seu pool de threads.
+   Retorna o motor ou NULL se a configuração é inválida (kernel não suportado pela CPU, aceleração fora da série
+   de Leibniz ou valores fora dos limites do programa) ou se faltou memória ou não foi possível criar as threads.
+*/
+Engine* createEngine(const EngineConfig *config) {
+    Config resolved;
+    if (config == NULL || !resolveEngineConfig(config, &resolved)) {
+        return NULL;
+    }
+    Engine *engine = (Engine *)malloc(sizeof(Engine));
+    if (engine == NULL) {
+        return NULL;
+    }
+    engine->config = resolved;
+    engine->config.cancel = &engine->cancel;
+    engine->cancel = FALSE;
+    engine->progress = config->progress;
+    engine->progressContext = config->progressContext;
+    if (engine->progress != NULL) {
+        engine->config.progress = forwardProgress;
+        engine->config.progressContext = engine;
+    }
+    engine->placement = createPlacement(&engine->config, 1, 0);
+    engine->pool = engine->placement != NULL || engine->config.affinity == AFFINITY_NONE
+        ? createThreadPool(engine->config.numberOfThreads, engine->placement) : NULL;
+    if (engine->pool == NULL) {
+        free(engine->placement);
+        free(engine);
+        return NULL;
+    }
+    pthread_mutex_init(&engine->mutex, NULL);
+    return engine;
+}//createEngine()
+
+/* Calcula pi com o motor 'engine' e grava o resultado em 'result', que deve ser liberado com freeEngineResult.
+   Pode ser chamada de qualquer thread; cálculos simultâneos no mesmo motor esperam a sua vez.
+   Retorna TRUE se o cálculo terminou, mesmo cancelado (result->cancelled), ou FALSE, sem calcular, se 'result' é NULL ou
+   faltou memória para as estatísticas das threads.
+*/
+int computeEngine(Engine *engine, EngineResult *result) {
+    if (result == NULL) {
+        return FALSE;
+    }
+    unsigned int numberOfThreads = engine->config.numberOfThreads;
+    Thread *threads = (Thread *)calloc(numberOfThreads, sizeof(Thread));
+    EngineThread *statistics = (EngineThread *)calloc(numberOfThreads, sizeof(EngineThread));
+    if (threads == NULL || statistics == NULL) {
+        free(threads);
+        free(statistics);
+        return FALSE;
+    }
+
+    pthread_mutex_lock(&engine->mutex);
+    Config config = engine->config;
+    TermRange chunks = {0, countChunks(&config)};
+    double started = monotonicSeconds();
+    config.deadlineAt = config.deadline > 0.0 ? started + config.deadline : 0.0;
+    Progress progress;
+    CompensatedSum sum = calculationOfNumberPi(&config, engine->pool, chunks, threads, &progress);
+    double duration = monotonicSeconds() - started;
+    // Um pedido de cancelamento vale para um único cálculo.
+    __atomic_store_n(&engine->cancel, FALSE, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&engine->mutex);
+
+    // Cancelado, só o prefixo contíguo dos chunks somados é uma soma parcial da série; a aceleração usa os seus termos.
+    if (progress.cancelled != CANCEL_NONE) {
+        config.numberOfTerms = progress.prefixTerms;
+        sum = progress.prefix;
+    }
+    PiResult estimate = seriesResult(&config, sum);
+    result->pi = estimate.pi;
+    result->rawPi = estimate.rawPi;
+    result->sum = sum.sum;
+    result->compensation = sum.compensation;
+    result->terms = estimate.terms;
+    result->duration = duration;
+    result->cancelled = (EngineCancelReason)progress.cancelled;
+    for (unsigned int i = 0; i < numberOfThreads; i++) {
+        statistics[i] = (EngineThread){
+            .tid = threads[i].tid,
+            .cpu = threads[i].cpu,
+            .lastCpu = threads[i].lastCpu,
+            .time = threads[i].time,
+            .cpuTime = threads[i].cpuTime,
+            .terms = threads[i].terms,
+            .chunks = threads[i].chunks,
+            .steals = threads[i].steals,
+            .voluntarySwitches = threads[i].voluntarySwitches,
+            .involuntarySwitches = threads[i].involuntarySwitches,
+            .migrations = threads[i].migrations,
+            .cycles = threads[i].cycles,
+            .instructions = threads[i].instructions,
+            .hardwareCounters = threads[i].hardwareCounters
+        };
+    }
+    free(threads);
+    result->numberOfThreads = numberOfThreads;
+    result->threads = statistics;
+    return TRUE;
+}//computeEngine()
+
+/* Cancela o cálculo em andamento no motor 'engine' ou, se não houver um, o próximo; pode ser chamada de qualquer thread.
+   O cálculo para antes do próximo chunk e reporta o que já somou.
+*/
+void cancelEngine(Engine *engine) {
+    __atomic_store_n(&engine->cancel, TRUE, __ATOMIC_RELAXED);
+}//cancelEngine()
+
+/* Libera as estatísticas por thread de 'result'. */
+void freeEngineResult(EngineResult *result) {
+    free(result->threads);
+    result->threads = NULL;
+    result->numberOfThreads = 0;
+}//freeEngineResult()
+
+/* Encerra o pool do motor 'engine', esperando o cálculo em andamento, e libera o motor. */
+void destroyEngine(Engine *engine) {
+    pthread_mutex_lock(&engine->mutex);
+    destroyThreadPool(engine->pool);
+    pthread_mutex_unlock(&engine->mutex);
+    pthread_mutex_destroy(&engine->mutex);
+    free(engine->placement);
+    free(engine);
+}//destroyEngine()
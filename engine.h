@@ -0,0 +1,150 @@
+#pragma once
+
+#include <sys/types.h> // Requerido pelos identificadores das threads (pid_t).
+
+// API pública do motor de cálculo embutido. Este cabeçalho não inclui pi.h: o programa hospedeiro vê apenas os nomes
+// com prefixo Engine e ENGINE_, e os tipos internos ficam em engine.c.
+
+// Visibilidade dos símbolos da API: a biblioteca é compilada com -fvisibility=hidden e exporta apenas as funções deste
+// cabeçalho (e pi(), de pi.h, para o programa de linha de comando).
+#define ENGINE_API __attribute__((visibility("default")))
+
+// Séries, na ordem da opção -A do programa.
+typedef enum {
+   ENGINE_SERIES_AUTO,               // A série de menor custo estimado para 'digits' casas.
+   ENGINE_SERIES_LEIBNIZ,
+   ENGINE_SERIES_MACHIN,
+   ENGINE_SERIES_BBP,
+   ENGINE_SERIES_CHUDNOVSKY
+} EngineSeries;
+
+// Kernels da série de Leibniz, na ordem da opção -k do programa.
+typedef enum {
+   ENGINE_KERNEL_AUTO,               // O kernel vetorial mais largo suportado pela CPU, com divisão exata.
+   ENGINE_KERNEL_SCALAR,
+   ENGINE_KERNEL_SSE2,
+   ENGINE_KERNEL_AVX2,
+   ENGINE_KERNEL_AVX512,
+   ENGINE_KERNEL_NEWTON              // Recíprocos por iterações de Newton, sem divisão.
+} EngineKernel;
+
+// Estratégias de soma dos kernels e da redução final.
+typedef enum {
+   ENGINE_SUMMATION_NAIVE,
+   ENGINE_SUMMATION_NEUMAIER,
+   ENGINE_SUMMATION_PAIRWISE,
+   ENGINE_SUMMATION_DOUBLE_DOUBLE
+} EngineSummation;
+
+// Acelerações da série de Leibniz.
+typedef enum {
+   ENGINE_ACCELERATION_NONE,
+   ENGINE_ACCELERATION_TAIL,
+   ENGINE_ACCELERATION_EULER
+} EngineAcceleration;
+
+// Afinidade das threads do motor.
+typedef enum {
+   ENGINE_AFFINITY_NONE,             // O escalonador do sistema posiciona as threads.
+   ENGINE_AFFINITY_COMPACT,          // Threads consecutivas em CPUs vizinhas.
+   ENGINE_AFFINITY_SCATTER,          // Threads consecutivas alternando pacotes e núcleos.
+   ENGINE_AFFINITY_NUMA              // Threads nas CPUs de um nó NUMA.
+} EngineAffinity;
+
+// Motivos do cancelamento de um cálculo.
+typedef enum {
+   ENGINE_CANCEL_NONE,               // O cálculo somou todos os chunks.
+   ENGINE_CANCEL_DEADLINE,           // O prazo EngineConfig.deadline se esgotou.
+   ENGINE_CANCEL_REQUEST             // cancelEngine foi chamada ou o callback de progresso retornou 0.
+} EngineCancelReason;
+
+// CPU de uma thread que não foi fixada pela afinidade.
+#define ENGINE_CPU_NOT_PINNED -1
+
+// Progresso de um cálculo, passado ao callback de progresso.
+typedef struct {
+   unsigned long long terms, totalTerms;   // Termos dos chunks já somados e do cálculo inteiro.
+   unsigned long long chunks, totalChunks; // Chunks já somados e do cálculo inteiro.
+   double sum;                             // Soma dos chunks já somados, na ordem em que foram concluídos.
+   double elapsed;                         // Segundos desde o início do cálculo.
+} EngineProgress;
+
+// Callback chamado a cada segundo com o progresso do cálculo e EngineConfig.progressContext. Retorna 0 para cancelar o cálculo.
+typedef int (*EngineProgressCallback)(const EngineProgress *progress, void *context);
+
+// Configuração de um motor de cálculo embutido. Os campos com 0 usam o padrão do programa de linha de comando.
+typedef struct {
+   unsigned int numberOfThreads;     // Threads do motor (0: CPUs online).
+   unsigned long long numberOfTerms; // Termos da série (0: os necessários para 'digits' casas na série escolhida).
+   unsigned long long chunkSize;     // Termos por chunk (0: o chunk padrão do programa).
+   unsigned int digits;              // Casas decimais que definem os termos padrão (0: as casas padrão do programa).
+   EngineSeries series;              // Série; ENGINE_SERIES_AUTO escolhe a mais barata para 'digits' casas.
+   EngineKernel kernel;              // Kernel da série de Leibniz; ENGINE_KERNEL_AUTO escolhe o melhor suportado.
+   EngineSummation summation;
+   EngineAcceleration acceleration;  // Apenas na série de Leibniz.
+   EngineAffinity affinity;          // Afinidade das threads do motor.
+   int hardwareCounters;             // Diferente de 0 para ler os contadores de hardware de cada thread.
+   double deadline;                  // Prazo de cada cálculo em segundos (0 sem prazo).
+   EngineProgressCallback progress;  // Callback de progresso de cada cálculo (NULL sem callback).
+   void *progressContext;            // Contexto passado ao callback de progresso.
+} EngineConfig;
+
+// Identificação, tempos e trabalho de uma thread de um cálculo.
+typedef struct {
+   pid_t tid;                        // Identificação da thread obtida com gettid.
+   int cpu;                          // CPU atribuída pela afinidade (ENGINE_CPU_NOT_PINNED se livre).
+   int lastCpu;                      // CPU em que a thread terminou.
+   double time;                      // Tempo de parede, em segundos.
+   double cpuTime;                   // Tempo de CPU, em segundos.
+   unsigned long long terms;         // Termos somados.
+   unsigned int chunks;              // Chunks somados.
+   unsigned int steals;              // Roubos de trabalho bem sucedidos.
+   unsigned long long voluntarySwitches, involuntarySwitches, migrations;
+   unsigned long long cycles, instructions; // Contadores de hardware, válidos se hardwareCounters.
+   int hardwareCounters;             // Diferente de 0 se cycles e instructions foram lidos.
+} EngineThread;
+
+// Resultado de um cálculo do motor.
+typedef struct {
+   double pi;                        // Estimativa (acelerada, se houver aceleração).
+   double rawPi;                     // Estimativa da série sem aceleração.
+   double sum, compensation;         // Soma da série que deu a estimativa e a sua correção.
+   unsigned long long terms;         // Termos da estimativa: se o cálculo foi cancelado, os do prefixo contíguo de chunks somados.
+   double duration;                  // Duração do cálculo, em segundos.
+   EngineCancelReason cancelled;     // Motivo do cancelamento, ou ENGINE_CANCEL_NONE.
+   unsigned int numberOfThreads;
+   EngineThread *threads;            // Estatísticas de cada thread (liberadas por freeEngineResult).
+} EngineResult;
+
+// Motor de cálculo embutido: um pool de threads persistente e a configuração resolvida, sem processos filhos.
+// Cálculos no mesmo motor são serializados; motores distintos calculam em paralelo.
+typedef struct Engine Engine;
+
+/* Preenche 'config' com a configuração padrão: os mesmos padrões do programa de linha de comando, exceto a afinidade,
+   que é ENGINE_AFFINITY_NONE para não fixar as threads do processo hospedeiro.
+*/
+ENGINE_API void defaultEngineConfig(EngineConfig *config);
+
+/* Cria um motor com a configuração 'config' e o seu pool de threads.
+   Retorna o motor ou NULL se a configuração é inválida (kernel não suportado pela CPU, aceleração fora da série
+   de Leibniz ou valores fora dos limites do programa) ou se faltou memória ou não foi possível criar as threads.
+*/
+ENGINE_API Engine* createEngine(const EngineConfig *config);
+
+/* Calcula pi com o motor 'engine' e grava o resultado em 'result', que deve ser liberado com freeEngineResult.
+   Pode ser chamada de qualquer thread; cálculos simultâneos no mesmo motor esperam a sua vez.
+   Retorna 1 se o cálculo terminou, mesmo cancelado (result->cancelled), ou 0, sem calcular, se 'result' é NULL ou
+   faltou memória para as estatísticas das threads.
+*/
+ENGINE_API int computeEngine(Engine *engine, EngineResult *result);
+
+/* Cancela o cálculo em andamento no motor 'engine' ou, se não houver um, o próximo; pode ser chamada de qualquer thread.
+   O cálculo para antes do próximo chunk e reporta o que já somou.
+*/
+ENGINE_API void cancelEngine(Engine *engine);
+
+/* Libera as estatísticas por thread de 'result'. */
+ENGINE_API void freeEngineResult(EngineResult *result);
+
+/* Encerra o pool do motor 'engine', esperando o cálculo em andamento, e libera o motor. */
+ENGINE_API void destroyEngine(Engine *engine);
@@ -0,0 +1,101 @@
+#pragma once
+
+// Fachada C++ (RAII) do motor de cálculo embutido de engine.h; apenas cabeçalho.
+
+#include <future>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include "engine.h"
+}
+
+namespace picalc {
+
+// Configuração do motor: a mesma de engine.h, já preenchida com os padrões de defaultEngineConfig.
+struct Config : EngineConfig {
+    Config() {
+        defaultEngineConfig(this);
+    }
+};
+
+// Identificação, tempos e trabalho de uma thread do cálculo.
+struct ThreadStats {
+    pid_t tid;                           // Identificação da thread obtida com gettid.
+    int cpu;                             // CPU atribuída pela afinidade (ENGINE_CPU_NOT_PINNED se livre).
+    int lastCpu;                         // CPU em que a thread terminou.
+    double time;                         // Tempo de parede, em segundos.
+    double cpuTime;                      // Tempo de CPU, em segundos.
+    unsigned long long terms;            // Termos somados.
+    unsigned int chunks;                 // Chunks somados.
+    unsigned int steals;                 // Roubos de trabalho bem sucedidos.
+    unsigned long long voluntarySwitches, involuntarySwitches, migrations;
+    unsigned long long cycles, instructions; // Contadores de hardware, válidos se hardwareCounters.
+    bool hardwareCounters;               // true se cycles e instructions foram lidos.
+};
+
+// Resultado de um cálculo.
+struct Result {
+    double pi;                           // Estimativa (acelerada, se houver aceleração).
+    double rawPi;                        // Estimativa da série sem aceleração.
+    unsigned long long terms;            // Termos da estimativa (o prefixo contíguo somado, se cancelado).
+    double duration;                     // Duração, em segundos.
+    EngineCancelReason cancelled;        // Motivo do cancelamento, ou ENGINE_CANCEL_NONE.
+    std::vector<ThreadStats> threads;    // Estatísticas de cada thread.
+};
+
+// Motor de cálculo: cria o pool de threads na construção e o encerra na destruição. Pode ser movido, não copiado.
+// compute() e compute_async() podem ser chamadas de várias threads; os cálculos do mesmo motor são serializados.
+class PiEngine {
+public:
+    // Lança std::invalid_argument se a configuração é inválida ou o pool de threads não pôde ser criado.
+    explicit PiEngine(const Config &config = Config())
+        : engine_(createEngine(&config), destroyEngine) {
+        if (!engine_) {
+            throw std::invalid_argument("configuração inválida do motor de cálculo de pi");
+        }
+    }
+
+    // Calcula pi e espera o resultado. Lança std::bad_alloc se faltou memória para as estatísticas das threads.
+    Result compute() {
+        return run(engine_.get());
+    }
+
+    // Calcula pi em outra thread; o motor deve viver até o futuro ficar pronto, mas pode ser movido enquanto isso.
+    std::future<Result> compute_async() {
+        Engine *engine = engine_.get();
+        return std::async(std::launch::async, [engine] { return run(engine); });
+    }
+
+    // Cancela o cálculo em andamento (ou o próximo); ele termina com o que já somou.
+    void cancel() {
+        cancelEngine(engine_.get());
+    }
+
+private:
+    // Calcula pi com o motor 'engine' e converte o resultado; não depende do objeto PiEngine, que pode ter sido movido.
+    static Result run(Engine *engine) {
+        EngineResult raw;
+        if (!computeEngine(engine, &raw)) {
+            throw std::bad_alloc();
+        }
+        // As estatísticas de raw são liberadas mesmo que a cópia para o vetor lance uma exceção.
+        std::unique_ptr<EngineResult, void (*)(EngineResult *)> guard(&raw, freeEngineResult);
+        Result result{raw.pi, raw.rawPi, raw.terms, raw.duration, raw.cancelled, {}};
+        result.threads.reserve(raw.numberOfThreads);
+        for (unsigned int i = 0; i < raw.numberOfThreads; i++) {
+            const EngineThread &thread = raw.threads[i];
+            result.threads.push_back({thread.tid, thread.cpu, thread.lastCpu, thread.time, thread.cpuTime, thread.terms,
+                                      thread.chunks, thread.steals, thread.voluntarySwitches, thread.involuntarySwitches,
+                                      thread.migrations, thread.cycles, thread.instructions, thread.hardwareCounters != 0});
+        }
+        return result;
+    }
+
+    std::unique_ptr<Engine, void (*)(Engine *)> engine_;
+};
+
+} // namespace picalc
@@ -0,0 +1,6 @@
+#include "pi.h"
+
+/* Ponto de entrada do programa de linha de comando: toda a lógica está na biblioteca (pi.c e os demais módulos). */
+int main(int argc, char *argv[]){
+    return pi(argc, argv);
+}//main()
@@ -0,0 +1,122 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <syscall.h>
+#include <linux/perf_event.h>
+#include "metrics.h"
+
+/* Abre, para a thread corrente, o contador 'config' do tipo 'type' já ativo.
+   Retorna o descritor do contador ou -1 se o núcleo o recusou.
+*/
+static int openCounter(unsigned int type, unsigned long long config, int excludeKernel) {
+    struct perf_event_attr attribute;
+    memset(&attribute, 0, sizeof(attribute));
+    attribute.size = sizeof(attribute);
+    attribute.type = type;
+    attribute.config = config;
+    attribute.exclude_kernel = excludeKernel;
+    attribute.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attribute, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}//openCounter()
+
+/* Inicia a medição da thread corrente em 'probe'. Com 'hardware' TRUE, abre também os contadores de ciclos, instruções
+   e migrações com perf_event_open; os que o núcleo recusar (perf_event_paranoid, máquina virtual) ficam indisponíveis.
+*/
+void startProbe(ThreadProbe *probe, int hardware) {
+    for (int i = 0; i < NUMBER_OF_COUNTERS; i++) {
+        probe->counters[i] = -1;
+    }
+    if (hardware) {
+        // Ciclos e instruções contam só o modo usuário, permitido com perf_event_paranoid 2; a migração acontece no núcleo.
+        probe->counters[COUNTER_CYCLES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 1);
+        probe->counters[COUNTER_INSTRUCTIONS] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 1);
+        probe->counters[COUNTER_MIGRATIONS] = openCounter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS, 0);
+    }
+    probe->cpuNow = sched_getcpu();
+    probe->migrations = 0;
+    getrusage(RUSAGE_THREAD, &probe->usage);
+    clock_gettime(METRICS_THREAD_CLOCK, &probe->cpu);
+    clock_gettime(DURATION_CLOCK, &probe->wall);
+    clock_gettime(CLOCK_REALTIME, &probe->started);
+}//startProbe()
+
+/* Registra, na fronteira de um chunk, a CPU em que a thread está, contando uma migração se ela mudou. */
+void sampleProbe(ThreadProbe *probe) {
+    int cpu = sched_getcpu();
+    if (cpu != probe->cpuNow) {
+        probe->migrations++;
+        probe->cpuNow = cpu;
+    }
+}//sampleProbe()
+
+/* Lê e fecha o contador 'fd'. Retorna TRUE e grava a contagem em 'value' se o contador estava disponível. */
+static int closeCounter(int fd, unsigned long long *value) {
+    if (fd < 0) {
+        return FALSE;
+    }
+    unsigned long long count;
+    int success = read(fd, &count, sizeof(count)) == (ssize_t)sizeof(count);
+    close(fd);
+    if (success) {
+        *value = count;
+    }
+    return success;
+}//closeCounter()
+
+/* Encerra a medição 'probe' da thread corrente, fecha os contadores e grava em 'thread' o tempo de parede, o tempo de CPU,
+   os instantes de início e fim, as trocas de contexto, as migrações e, se disponíveis, os ciclos e as instruções.
+*/
+void stopProbe(ThreadProbe *probe, Thread *thread) {
+    struct timespec wall, cpu, finished;
+    struct rusage usage;
+    clock_gettime(CLOCK_REALTIME, &finished);
+    clock_gettime(DURATION_CLOCK, &wall);
+    clock_gettime(METRICS_THREAD_CLOCK, &cpu);
+    getrusage(RUSAGE_THREAD, &usage);
+
+    thread->time = calculateDuration(probe->wall, wall);
+    thread->cpuTime = calculateDuration(probe->cpu, cpu);
+    thread->started = (double)probe->started.tv_sec + (double)probe->started.tv_nsec / 1e9;
+    thread->finished = (double)finished.tv_sec + (double)finished.tv_nsec / 1e9;
+    thread->voluntarySwitches = (unsigned long long)(usage.ru_nvcsw - probe->usage.ru_nvcsw);
+    thread->involuntarySwitches = (unsigned long long)(usage.ru_nivcsw - probe->usage.ru_nivcsw);
+    // O contador do núcleo vê toda migração; sem ele, valem as observadas entre chunks.
+    if (!closeCounter(probe->counters[COUNTER_MIGRATIONS], &thread->migrations)) {
+        thread->migrations = probe->migrations;
+    }
+    int cycles = closeCounter(probe->counters[COUNTER_CYCLES], &thread->cycles);
+    int instructions = closeCounter(probe->counters[COUNTER_INSTRUCTIONS], &thread->instructions);
+    thread->hardwareCounters = cycles && instructions;
+    if (!thread->hardwareCounters) {
+        thread->cycles = 0;
+        thread->instructions = 0;
+    }
+}//stopProbe()
+
+/* Cria o arquivo 'fileName' de exportação das métricas por thread e escreve o seu cabeçalho.
+   Retorna o escritor do arquivo ou NULL se ocorreu algum erro.
+*/
+Writer* createMetricsFile(const char *fileName) {
+    return openWriter(fileName, REPORT_CSV, METRICS_HEADER);
+}//createMetricsFile()
+
+/* Acrescenta ao escritor 'writer' uma linha por thread do vetor 'threads', com 'numberOfThreads' elementos, do processo 'numberProcess'. */
+void writeMetrics(Writer *writer, int numberProcess, const Thread *threads, unsigned int numberOfThreads) {
+    for (unsigned int i = 0; i < numberOfThreads; i++) {
+        const Thread *thread = &threads[i];
+        double throughput = thread->time > 0.0 ? (double)thread->terms / thread->time : 0.0;
+        writerPrintf(writer, METRICS_ROW, numberProcess, thread->tid, thread->cpu, thread->lastCpu, thread->time, thread->cpuTime,
+                thread->terms, throughput, thread->chunks, thread->steals, thread->voluntarySwitches, thread->involuntarySwitches,
+                thread->migrations);
+        if (thread->hardwareCounters) {
+            double ipc = thread->cycles > 0 ? (double)thread->instructions / (double)thread->cycles : 0.0;
+            writerPrintf(writer, METRICS_COUNTERS, thread->cycles, thread->instructions, ipc);
+        }
+        else {
+            writerPrintf(writer, METRICS_NO_COUNTERS);
+        }
+    }
+}//writeMetrics()
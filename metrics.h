@@ -0,0 +1,56 @@
+#pragma once
+
+#include <time.h>          // Requerido pelos relógios de clock_gettime (struct timespec).
+#include <sys/resource.h>  // Requerido pelo uso de recursos por thread (struct rusage).
+#include "pi.h"
+#include "writer.h"
+
+// Relógio do tempo de CPU consumido pela thread.
+#define METRICS_THREAD_CLOCK CLOCK_THREAD_CPUTIME_ID
+
+// Formatações da exportação das métricas por thread (CSV, sempre com ponto decimal).
+#define METRICS_HEADER "process,tid,cpu,last_cpu,wall_s,cpu_s,terms,terms_per_s,chunks,steals," \
+                       "voluntary_switches,involuntary_switches,migrations,cycles,instructions,ipc\n"
+#define METRICS_ROW "%d,%d,%d,%d,%.9f,%.9f,%llu,%.6e,%u,%u,%llu,%llu,%llu,"
+#define METRICS_COUNTERS "%llu,%llu,%.4f\n"
+#define METRICS_NO_COUNTERS ",,\n"
+
+// Contadores lidos com perf_event_open enquanto a thread soma os seus chunks.
+typedef enum {
+   COUNTER_CYCLES,
+   COUNTER_INSTRUCTIONS,
+   COUNTER_MIGRATIONS,
+   NUMBER_OF_COUNTERS
+} PerfCounter;
+
+// Instantes e leituras do início de uma medição da thread que a criou.
+typedef struct {
+   struct timespec wall;           // DURATION_CLOCK no início.
+   struct timespec cpu;            // METRICS_THREAD_CLOCK no início.
+   struct timespec started;        // CLOCK_REALTIME no início, exibido no relatório estruturado.
+   struct rusage usage;            // getrusage(RUSAGE_THREAD) no início.
+   int counters[NUMBER_OF_COUNTERS]; // Descritores dos contadores (-1 se indisponível ou desligado).
+   int cpuNow;                     // CPU observada no último chunk, para contar migrações sem perf_event_open.
+   unsigned long long migrations;  // Migrações observadas entre chunks.
+} ThreadProbe;
+
+/* Inicia a medição da thread corrente em 'probe'. Com 'hardware' TRUE, abre também os contadores de ciclos, instruções
+   e migrações com perf_event_open; os que o núcleo recusar (perf_event_paranoid, máquina virtual) ficam indisponíveis.
+*/
+void startProbe(ThreadProbe *probe, int hardware);
+
+/* Registra, na fronteira de um chunk, a CPU em que a thread está, contando uma migração se ela mudou. */
+void sampleProbe(ThreadProbe *probe);
+
+/* Encerra a medição 'probe' da thread corrente, fecha os contadores e grava em 'thread' o tempo de parede, o tempo de CPU,
+   os instantes de início e fim, as trocas de contexto, as migrações e, se disponíveis, os ciclos e as instruções.
+*/
+void stopProbe(ThreadProbe *probe, Thread *thread);
+
+/* Cria o arquivo 'fileName' de exportação das métricas por thread e escreve o seu cabeçalho.
+   Retorna o escritor do arquivo ou NULL se ocorreu algum erro.
+*/
+Writer* createMetricsFile(const char *fileName);
+
+/* Acrescenta ao escritor 'writer' uma linha por thread do vetor 'threads', com 'numberOfThreads' elementos, do processo 'numberProcess'. */
+void writeMetrics(Writer *writer, int numberProcess, const Thread *threads, unsigned int numberOfThreads);
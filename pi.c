@@ -1,3 +1,4 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h> 
@@ -6,256 +7,2558 @@
 #include <sys/wait.h>
 #include <locale.h>
 #include <sys/time.h>
+#include <getopt.h>
+#include <errno.h>
+#include <limits.h>
+#include <sched.h>
+#include <math.h>
+#include <ctype.h>
+#include <float.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <linux/futex.h>
+#include <signal.h>
 #include "pi.h"
+#include "bignum.h"
+#include "cluster.h"
+#include "checkpoint.h"
+#include "cache.h"
+#include "metrics.h"
+#include "writer.h"
+#include "benchmark.h"
+#include "completion.h"
+#include "daemon.h"
+
+// Os kernels vetoriais usam intrínsecos SSE2/AVX2/AVX-512 e só existem em x86.
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define X86_KERNELS
+#endif
+
+// TRUE depois de cancelCalculation(); lido pelo agregador de sumSeries, que então cancela o cálculo em andamento.
+static int cancelRequested = FALSE;
 
 /* Cria o relatório do programa escrevendo na tela as informações da estrutura Report.
- * Retorna TRUE se o relatório foi escrito com sucesso ou FALSE se os dados da estrutura Report são vazios ou nulos.
+ * O texto é montado em um buffer pré-alocado e enviado em um único write(), sem intercalar com a saída de outros processos.
+ * Retorna TRUE se o relatório foi escrito com sucesso ou FALSE se os dados da estrutura Report são vazios ou nulos ou a escrita falhou.
+*/
+int createReport(const Report *report) {
+    if (report == NULL || report->processReports == NULL) {
+        return FALSE;
+    }
+    for (unsigned int i = 0; i < report->numberOfProcesses; i++) {
+        if (report->processReports[i].identification[0] == NULL_CHAR) {
+            return FALSE;
+        }
+    }
+
+    // O relatório inteiro é formatado no buffer e vai à saída padrão em um único write().
+    Writer *writer = openTextWriter(NULL, REPORT_TEXT_SIZE(report->numberOfProcesses));
+    if (writer == NULL) {
+        return FALSE;
+    }
+    writerPrintf(writer, "%s%s%s", EMPTY_LINE, report->programName, EMPTY_LINE);
+    writerPrintf(writer, "%s%c", report->message1, NEW_LINE);
+    writerPrintf(writer, "%s%c", report->message2, NEW_LINE);
+
+    for (unsigned int i = 0; i < report->numberOfProcesses; i++) {
+        const ProcessReport *processReport = &report->processReports[i];
+        writerPrintf(writer, "%c%s%s", NEW_LINE, processReport->identification, EMPTY_LINE);
+        writerPrintf(writer, "%c%s%s", TAB, processReport->numberOfThreads, EMPTY_LINE);
+        writerPrintf(writer, "%c%s%c", TAB, processReport->start, NEW_LINE);
+        writerPrintf(writer, "%c%s%c", TAB, processReport->end, NEW_LINE);
+        writerPrintf(writer, "%c%s%s", TAB, processReport->duration, EMPTY_LINE);
+        writerPrintf(writer, "%c%s%c", TAB, processReport->terms, NEW_LINE);
+        writerPrintf(writer, "%c%s%c", TAB, processReport->partialSum, NEW_LINE);
+    }
+
+    writerPrintf(writer, "%c%s%s", NEW_LINE, report->total, EMPTY_LINE);
+    writerPrintf(writer, "%c%s%c", TAB, report->series, NEW_LINE);
+    writerPrintf(writer, "%c%s%c", TAB, report->kernel, NEW_LINE);
+    writerPrintf(writer, "%c%s%c", TAB, report->summation, NEW_LINE);
+    writerPrintf(writer, "%c%s%s", TAB, report->acceleration, EMPTY_LINE);
+    writerPrintf(writer, "%c%s%s", TAB, report->duration, EMPTY_LINE);
+    writerPrintf(writer, "%c%s%c", TAB, report->pi, NEW_LINE);
+    if (report->rawPi[0] != NULL_CHAR) {
+        writerPrintf(writer, "%c%s%c", TAB, report->rawPi, NEW_LINE);
+    }
+    if (report->bound[0] != NULL_CHAR) {
+        writerPrintf(writer, "%c%s%c", TAB, report->bound, NEW_LINE);
+    }
+    if (report->cancelled[0] != NULL_CHAR) {
+        writerPrintf(writer, "%c%s%c", TAB, report->cancelled, NEW_LINE);
+    }
+    writerPrintf(writer, "%c%s%s", TAB, report->terms, EMPTY_LINE);
+
+    return closeWriter(writer);
+}//createReport();
+
+/* Cria o arquivo texto no diretório atual usando o nome do arquivo, a descrição e os dados do vetor de threads
+ * com 'numberOfThreads' elementos.
+ * Retorna TRUE se o arquivo foi criado com sucesso ou FALSE se ocorreu algum erro.
+ */
+int createFile(const FileName fileName, String description, const Thread *threads, unsigned int numberOfThreads) {
+    // As linhas vão direto ao buffer pré-alocado, com a vírgula decimal já na formatação, e o arquivo recebe um único write().
+    Writer *arquivo = openTextWriter(fileName, FILE_TEXT_SIZE(numberOfThreads));
+    if (arquivo == NULL) {
+        return FALSE;
+    }
+
+    writerPrintf(arquivo, SHOW_FILE_NAME, fileName, NEW_LINE);
+    writerPrintf(arquivo, SHOW_FILE_DESCRIPTION, description, EMPTY_LINE);
+
+    double totalTimeOfThreads = 0.0;
+    char cpu[CPU_TEXT_SIZE];
+    for (unsigned int i = 0; i < numberOfThreads; i++){
+        if (threads[i].cpu == CPU_NOT_PINNED) {
+            snprintf(cpu, CPU_TEXT_SIZE, SHOW_CPU_NOT_PINNED, threads[i].lastCpu);
+        }
+        else {
+            snprintf(cpu, CPU_TEXT_SIZE, SHOW_CPU, threads[i].cpu);
+        }
+        double throughput = threads[i].time > 0.0 ? (double)threads[i].terms / threads[i].time : 0.0;
+        writerPrintf(arquivo, SHOW_TID, threads[i].tid, cpu, threads[i].time, threads[i].cpuTime,
+                     throughput, threads[i].terms, threads[i].chunks, threads[i].steals, threads[i].voluntarySwitches,
+                     threads[i].involuntarySwitches, threads[i].migrations);
+        if (threads[i].hardwareCounters && threads[i].cycles > 0) {
+            writerPrintf(arquivo, SHOW_TID_IPC, (double)threads[i].instructions / (double)threads[i].cycles);
+        }
+        writerPrintf(arquivo, SHOW_TID_END, NEW_LINE);
+        totalTimeOfThreads += threads[i].time;
+    }
+    writerPrintf(arquivo, SHOW_TOTAL_TIME_THREAD, NEW_LINE, totalTimeOfThreads, NEW_LINE);
+    return closeWriter(arquivo);
+}//createFile();
+
+/* Realiza a soma parcial dos chunks da série de Leibniz da fila do worker 'worker' usando o kernel do escalonador 'argument' (um Scheduler).
+   A fila começa com uma fatia contígua de chunks, por exemplo, com 2.000.000.000 de termos, chunks de 1.000.000 de termos
+   e 16 threads, a thread 0 começa com os chunks 0 até 124, que cobrem os termos de 0 até 124.999.999, e assim por diante.
+   Quando a sua fila esvazia, a thread rouba a metade final da fila de outra thread até que todas estejam vazias.
+   A soma de cada chunk é publicada na fila de conclusões do escalonador assim que fica pronta, e a thread para antes
+   do próximo chunk se o agregador cancelou o cálculo.
+
+   O resultado dessa soma parcial é gravado em 'threadResult', o slot do worker no pool.
+*/
+void sumPartial(void *argument, unsigned int worker, ThreadResult *threadResult) {    
+    Scheduler *scheduler = (Scheduler *)argument;
+    ThreadProbe probe;
+    startProbe(&probe, scheduler->hardwareCounters);
+
+    WorkQueue *queue = &scheduler->slots[worker].queue;
+    Accumulator accumulator;
+    accumulatorInit(&accumulator, scheduler->summation);
+    unsigned long long chunk, terms = 0;
+    unsigned int chunks = 0, steals = 0;
+
+    for (;;) {
+        if (__atomic_load_n(&scheduler->cancelled, __ATOMIC_RELAXED)) {
+            break;
+        }
+        // No modo incremental os chunks saem em ordem crescente de um contador comum a todos os processos.
+        if (scheduler->stream != NULL) {
+            if (!takeStreamChunk(scheduler->stream, &chunk)) {
+                break;
+            }
+        }
+        else if (!popChunk(queue, &chunk)) {
+            if (!stealChunks(scheduler, worker)) {
+                break;
+            }
+            steals++;
+            continue;
+        }
+        sampleProbe(&probe);
+        unsigned long long start = chunk * scheduler->chunkSize;
+        unsigned long long count = scheduler->numberOfTerms - start;
+        if (count > scheduler->chunkSize) {
+            count = scheduler->chunkSize;
+        }
+        // Um chunk já gravado no checkpoint ou no cache não é somado de novo nem entra nos termos e chunks da thread.
+        CompensatedSum sum;
+        int loaded = scheduler->checkpoint != NULL && checkpointLoad(scheduler->checkpoint, chunk, &sum);
+        if (!loaded && scheduler->cache != NULL && cacheLoad(scheduler->cache, chunk, count, &sum)) {
+            loaded = TRUE;
+            if (scheduler->checkpoint != NULL) {
+                checkpointStore(scheduler->checkpoint, chunk, sum);
+            }
+        }
+        if (!loaded) {
+            // Os kernels especializados substituem sumTerms quando há um para o comprimento do chunk.
+            if (count == scheduler->chunkSize && scheduler->fullKernel != NULL) {
+                sum = scheduler->fullKernel(start, count);
+            }
+            else if (scheduler->partialKernel != NULL) {
+                sum = scheduler->partialKernel(start, count);
+            }
+            else {
+                sum = sumTerms(scheduler->kernel, scheduler->summation, start, count);
+            }
+            if (scheduler->checkpoint != NULL) {
+                checkpointStore(scheduler->checkpoint, chunk, sum);
+            }
+            if (scheduler->cache != NULL) {
+                cacheStore(scheduler->cache, chunk, count, sum);
+            }
+            terms += count;
+            chunks++;
+        }
+        if (scheduler->stream != NULL) {
+            publishStreamChunk(scheduler->stream, chunk, sum);
+        }
+        accumulatorAdd(&accumulator, sum);
+        Completion completion = {chunk, count, sum, worker};
+        pushCompletion(scheduler->completions, &completion);
+    }
+    CompensatedSum sum = accumulatorResult(&accumulator);
+    threadResult->sumPartional = sum.sum;
+    threadResult->compensation = sum.compensation;
+    threadResult->thread.terms = terms;
+    threadResult->thread.chunks = chunks;
+    threadResult->thread.steals = steals;
+
+    stopProbe(&probe, &threadResult->thread);
+    threadResult->thread.tid = syscall(SYS_gettid); 
+    threadResult->thread.lastCpu = sched_getcpu();
+
+    // Avisa o agregador por último: depois disso, o slot da thread não muda mais.
+    Completion done = {COMPLETION_WORKER_DONE, 0, {0.0, 0.0}, worker};
+    pushCompletion(scheduler->completions, &done);
+}//sumPartial()
+
+/* Retira o primeiro chunk da fila 'queue' e o armazena em 'chunk'.
+   Retorna TRUE se um chunk foi retirado ou FALSE se a fila está vazia.
+*/
+int popChunk(WorkQueue *queue, unsigned long long *chunk) {
+    int popped = FALSE;
+    pthread_mutex_lock(&queue->mutex);
+    if (queue->top < queue->bottom) {
+        *chunk = queue->top++;
+        popped = TRUE;
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return popped;
+}//popChunk()
+
+/* Rouba a metade final da fila de outra thread e a coloca na fila da thread 'thief', que deve estar vazia.
+   As vítimas são examinadas a partir da thread seguinte à ladra.
+   Retorna TRUE se algum trabalho foi roubado ou FALSE se todas as filas estão vazias.
+*/
+int stealChunks(Scheduler *scheduler, unsigned int thief) {
+    for (unsigned int offset = 1; offset < scheduler->numberOfWorkers; offset++) {
+        WorkQueue *victim = &scheduler->slots[(thief + offset) % scheduler->numberOfWorkers].queue;
+        unsigned long long top = 0, bottom = 0;
+
+        // Nunca segura duas travas ao mesmo tempo: a metade roubada sai da vítima antes de entrar na ladra.
+        pthread_mutex_lock(&victim->mutex);
+        if (victim->top < victim->bottom) {
+            unsigned long long stolen = (victim->bottom - victim->top + 1) / 2;
+            bottom = victim->bottom;
+            top = bottom - stolen;
+            victim->bottom = top;
+        }
+        pthread_mutex_unlock(&victim->mutex);
+
+        if (top < bottom) {
+            WorkQueue *queue = &scheduler->slots[thief].queue;
+            pthread_mutex_lock(&queue->mutex);
+            queue->top = top;
+            queue->bottom = bottom;
+            pthread_mutex_unlock(&queue->mutex);
+            return TRUE;
+        }
+    }
+    return FALSE;
+}//stealChunks()
+
+/* Kernel de referência: soma os termos [start, start + count) da série de Leibniz um a um. */
+double leibnizScalar(unsigned long long start, unsigned long long count) {
+    double sum = 0.0;
+    unsigned long long end = start + count;
+    for (unsigned long long i = start; i < end; i++) {
+        double term = 1.0 / (2.0 * i + 1);
+        if (i % 2 == 0) {
+            sum += term;
+        } 
+        else {
+            sum -= term;
+        }
+    }
+    return sum;
+}//leibnizScalar()
+
+#ifdef X86_KERNELS
+
+/* Se 'start' é ímpar, subtrai o primeiro termo e avança o intervalo, de modo que nos kernels vetoriais
+   as lanes pares sejam sempre positivas e as ímpares sempre negativas.
+   Retorna o termo consumido (ou 0.0).
+*/
+static double alignToEvenTerm(unsigned long long *start, unsigned long long *count) {
+    if (*start % 2 == 0 || *count == 0) {
+        return 0.0;
+    }
+    double term = -1.0 / (2.0 * (*start) + 1);
+    (*start)++;
+    (*count)--;
+    return term;
+}//alignToEvenTerm()
+
+/* Kernels vetoriais: somam os termos [start, start + count) da série de Leibniz sem desvios condicionais, com
+   KERNEL_ACCUMULATORS acumuladores independentes. Cada lane soma um par de termos positivo/negativo 1/d - 1/(d + 2)
+   fundido em 2/(d (d + 2)), como os kernels escalares especializados: uma divisão a cada dois termos.
+   Os termos que não completam um vetor são somados por leibnizScalar. Disponíveis apenas em x86.
+*/
+__attribute__((target("sse2")))
+double leibnizSse2(unsigned long long start, unsigned long long count) {
+    double sum = alignToEvenTerm(&start, &count);
+    const unsigned long long lanes = 2, step = 2 * lanes * KERNEL_ACCUMULATORS;
+    unsigned long long blocks = count / step;
+
+    const __m128d two = _mm_set1_pd(2.0);
+    const __m128d increment = _mm_set1_pd(2.0 * step);
+    const __m128d first = _mm_set_pd(2.0 * start + 5.0, 2.0 * start + 1.0);
+    __m128d denominator[KERNEL_ACCUMULATORS], accumulator[KERNEL_ACCUMULATORS];
+    for (int j = 0; j < KERNEL_ACCUMULATORS; j++) {
+        denominator[j] = _mm_add_pd(first, _mm_set1_pd(4.0 * lanes * j));
+        accumulator[j] = _mm_setzero_pd();
+    }
+    for (unsigned long long block = 0; block < blocks; block++) {
+        for (int j = 0; j < KERNEL_ACCUMULATORS; j++) {
+            accumulator[j] = _mm_add_pd(accumulator[j], _mm_div_pd(two, _mm_mul_pd(denominator[j], _mm_add_pd(denominator[j], two))));
+            denominator[j] = _mm_add_pd(denominator[j], increment);
+        }
+    }
+    for (int j = 1; j < KERNEL_ACCUMULATORS; j++) {
+        accumulator[0] = _mm_add_pd(accumulator[0], accumulator[j]);
+    }
+    double lane[2];
+    _mm_storeu_pd(lane, accumulator[0]);
+    sum += lane[0] + lane[1];
+
+    return sum + leibnizScalar(start + blocks * step, count - blocks * step);
+}//leibnizSse2()
+
+__attribute__((target("avx2")))
+double leibnizAvx2(unsigned long long start, unsigned long long count) {
+    double sum = alignToEvenTerm(&start, &count);
+    const unsigned long long lanes = 4, step = 2 * lanes * KERNEL_ACCUMULATORS;
+    unsigned long long blocks = count / step;
+
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d increment = _mm256_set1_pd(2.0 * step);
+    const double base = 2.0 * start + 1.0;
+    const __m256d first = _mm256_set_pd(base + 12.0, base + 8.0, base + 4.0, base);
+    __m256d denominator[KERNEL_ACCUMULATORS], accumulator[KERNEL_ACCUMULATORS];
+    for (int j = 0; j < KERNEL_ACCUMULATORS; j++) {
+        denominator[j] = _mm256_add_pd(first, _mm256_set1_pd(4.0 * lanes * j));
+        accumulator[j] = _mm256_setzero_pd();
+    }
+    for (unsigned long long block = 0; block < blocks; block++) {
+        for (int j = 0; j < KERNEL_ACCUMULATORS; j++) {
+            accumulator[j] = _mm256_add_pd(accumulator[j], _mm256_div_pd(two, _mm256_mul_pd(denominator[j], _mm256_add_pd(denominator[j], two))));
+            denominator[j] = _mm256_add_pd(denominator[j], increment);
+        }
+    }
+    for (int j = 1; j < KERNEL_ACCUMULATORS; j++) {
+        accumulator[0] = _mm256_add_pd(accumulator[0], accumulator[j]);
+    }
+    double lane[4];
+    _mm256_storeu_pd(lane, accumulator[0]);
+    sum += (lane[0] + lane[1]) + (lane[2] + lane[3]);
+
+    return sum + leibnizScalar(start + blocks * step, count - blocks * step);
+}//leibnizAvx2()
+
+__attribute__((target("avx512f")))
+double leibnizAvx512(unsigned long long start, unsigned long long count) {
+    double sum = alignToEvenTerm(&start, &count);
+    const unsigned long long lanes = 8, step = 2 * lanes * KERNEL_ACCUMULATORS;
+    unsigned long long blocks = count / step;
+
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d increment = _mm512_set1_pd(2.0 * step);
+    const double base = 2.0 * start + 1.0;
+    const __m512d first = _mm512_set_pd(base + 28.0, base + 24.0, base + 20.0, base + 16.0,
+                                        base + 12.0, base + 8.0, base + 4.0, base);
+    __m512d denominator[KERNEL_ACCUMULATORS], accumulator[KERNEL_ACCUMULATORS];
+    for (int j = 0; j < KERNEL_ACCUMULATORS; j++) {
+        denominator[j] = _mm512_add_pd(first, _mm512_set1_pd(4.0 * lanes * j));
+        accumulator[j] = _mm512_setzero_pd();
+    }
+    for (unsigned long long block = 0; block < blocks; block++) {
+        for (int j = 0; j < KERNEL_ACCUMULATORS; j++) {
+            accumulator[j] = _mm512_add_pd(accumulator[j], _mm512_div_pd(two, _mm512_mul_pd(denominator[j], _mm512_add_pd(denominator[j], two))));
+            denominator[j] = _mm512_add_pd(denominator[j], increment);
+        }
+    }
+    for (int j = 1; j < KERNEL_ACCUMULATORS; j++) {
+        accumulator[0] = _mm512_add_pd(accumulator[0], accumulator[j]);
+    }
+    sum += _mm512_reduce_add_pd(accumulator[0]);
+
+    return sum + leibnizScalar(start + blocks * step, count - blocks * step);
+}//leibnizAvx512()
+
+/* Kernels sem divisão (kernel newton): como os kernels vetoriais, mas o recíproco de cada denominador d (d + 2) vem da
+   aproximação de hardware (rcp14 em AVX-512, rcp_ps em precisão simples em AVX2) refinada por iterações de Newton com FMA,
+   r = r + r (1 - d r), trocando a divisão, de vazão baixa, por multiplicações e somas. O recíproco fica a cerca de 1 ulp
+   do exato. Os termos que não completam um vetor são somados por leibnizScalar. Disponíveis apenas em x86.
+*/
+__attribute__((target("avx2,fma")))
+double leibnizNewtonAvx2(unsigned long long start, unsigned long long count) {
+    double sum = alignToEvenTerm(&start, &count);
+    const unsigned long long lanes = 4, step = 2 * lanes * KERNEL_ACCUMULATORS;
+    unsigned long long blocks = count / step;
+
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d increment = _mm256_set1_pd(2.0 * step);
+    const double base = 2.0 * start + 1.0;
+    const __m256d first = _mm256_set_pd(base + 12.0, base + 8.0, base + 4.0, base);
+    __m256d denominator[KERNEL_ACCUMULATORS], accumulator[KERNEL_ACCUMULATORS];
+    for (int j = 0; j < KERNEL_ACCUMULATORS; j++) {
+        denominator[j] = _mm256_add_pd(first, _mm256_set1_pd(4.0 * lanes * j));
+        accumulator[j] = _mm256_setzero_pd();
+    }
+    for (unsigned long long block = 0; block < blocks; block++) {
+        for (int j = 0; j < KERNEL_ACCUMULATORS; j++) {
+            __m256d product = _mm256_mul_pd(denominator[j], _mm256_add_pd(denominator[j], two));
+            __m256d reciprocal = _mm256_cvtps_pd(_mm_rcp_ps(_mm256_cvtpd_ps(product)));
+            for (int k = 0; k < NEWTON_ITERATIONS_AVX2; k++) {
+                __m256d residual = _mm256_fnmadd_pd(product, reciprocal, one);
+                reciprocal = _mm256_fmadd_pd(reciprocal, residual, reciprocal);
+            }
+            accumulator[j] = _mm256_fmadd_pd(two, reciprocal, accumulator[j]);
+            denominator[j] = _mm256_add_pd(denominator[j], increment);
+        }
+    }
+    for (int j = 1; j < KERNEL_ACCUMULATORS; j++) {
+        accumulator[0] = _mm256_add_pd(accumulator[0], accumulator[j]);
+    }
+    double lane[4];
+    _mm256_storeu_pd(lane, accumulator[0]);
+    sum += (lane[0] + lane[1]) + (lane[2] + lane[3]);
+
+    return sum + leibnizScalar(start + blocks * step, count - blocks * step);
+}//leibnizNewtonAvx2()
+
+__attribute__((target("avx512f")))
+double leibnizNewtonAvx512(unsigned long long start, unsigned long long count) {
+    double sum = alignToEvenTerm(&start, &count);
+    const unsigned long long lanes = 8, step = 2 * lanes * KERNEL_ACCUMULATORS;
+    unsigned long long blocks = count / step;
+
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d increment = _mm512_set1_pd(2.0 * step);
+    const double base = 2.0 * start + 1.0;
+    const __m512d first = _mm512_set_pd(base + 28.0, base + 24.0, base + 20.0, base + 16.0,
+                                        base + 12.0, base + 8.0, base + 4.0, base);
+    __m512d denominator[KERNEL_ACCUMULATORS], accumulator[KERNEL_ACCUMULATORS];
+    for (int j = 0; j < KERNEL_ACCUMULATORS; j++) {
+        denominator[j] = _mm512_add_pd(first, _mm512_set1_pd(4.0 * lanes * j));
+        accumulator[j] = _mm512_setzero_pd();
+    }
+    for (unsigned long long block = 0; block < blocks; block++) {
+        for (int j = 0; j < KERNEL_ACCUMULATORS; j++) {
+            __m512d product = _mm512_mul_pd(denominator[j], _mm512_add_pd(denominator[j], two));
+            __m512d reciprocal = _mm512_rcp14_pd(product);
+            for (int k = 0; k < NEWTON_ITERATIONS_AVX512; k++) {
+                __m512d residual = _mm512_fnmadd_pd(product, reciprocal, one);
+                reciprocal = _mm512_fmadd_pd(reciprocal, residual, reciprocal);
+            }
+            accumulator[j] = _mm512_fmadd_pd(two, reciprocal, accumulator[j]);
+            denominator[j] = _mm512_add_pd(denominator[j], increment);
+        }
+    }
+    for (int j = 1; j < KERNEL_ACCUMULATORS; j++) {
+        accumulator[0] = _mm512_add_pd(accumulator[0], accumulator[j]);
+    }
+    sum += _mm512_reduce_add_pd(accumulator[0]);
+
+    return sum + leibnizScalar(start + blocks * step, count - blocks * step);
+}//leibnizNewtonAvx512()
+
+#endif
+
+/* Retorna TRUE se a CPU suporta o kernel 'kernel' ou FALSE caso contrário. */
+int kernelSupported(KernelType kernel) {
+    switch (kernel) {
+        case KERNEL_AUTO:
+        case KERNEL_SCALAR:
+            return TRUE;
+#ifdef X86_KERNELS
+        case KERNEL_SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2") ? TRUE : FALSE;
+        case KERNEL_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? TRUE : FALSE;
+        case KERNEL_AVX512:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f") ? TRUE : FALSE;
+        case KERNEL_NEWTON:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f") || (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) ? TRUE : FALSE;
+#endif
+        default:
+            return FALSE;
+    }
+}//kernelSupported()
+
+/* Resolve KERNEL_AUTO para o melhor kernel suportado pela CPU (verificado via CPUID) e retorna a função do kernel.
+   KERNEL_AUTO escolhe apenas entre os kernels com divisão exata; o kernel newton usa a variante AVX-512 quando a CPU a suporta.
+   Retorna NULL se o kernel pedido não é suportado pela CPU.
+*/
+SeriesKernel selectKernel(KernelType *kernel) {
+    if (*kernel == KERNEL_AUTO) {
+        *kernel = KERNEL_SCALAR;
+        for (KernelType candidate = KERNEL_AVX512; candidate > KERNEL_SCALAR; candidate--) {
+            if (kernelSupported(candidate)) {
+                *kernel = candidate;
+                break;
+            }
+        }
+    }
+    if (!kernelSupported(*kernel)) {
+        return NULL;
+    }
+    switch (*kernel) {
+#ifdef X86_KERNELS
+        case KERNEL_SSE2:
+            return leibnizSse2;
+        case KERNEL_AVX2:
+            return leibnizAvx2;
+        case KERNEL_AVX512:
+            return leibnizAvx512;
+        case KERNEL_NEWTON:
+            return __builtin_cpu_supports("avx512f") ? leibnizNewtonAvx512 : leibnizNewtonAvx2;
+#endif
+        default:
+            return leibnizScalar;
+    }
+}//selectKernel()
+
+/* Retorna o nome do kernel 'kernel' (por exemplo, "avx2"). */
+const char* kernelName(KernelType kernel) {
+    static const char *names[NUMBER_OF_KERNELS] = KERNEL_NAMES;
+    return kernel < NUMBER_OF_KERNELS ? names[kernel] : names[KERNEL_AUTO];
+}//kernelName()
+
+/* Kernels das séries de convergência rápida: somam os termos [start, start + count) das séries de Machin
+   (arctan), BBP e Chudnovsky em double. Os termos que ficam abaixo do menor double são descartados.
+*/
+double machinTerms(unsigned long long start, unsigned long long count) {
+    double power5 = pow(5.0, -(2.0 * start + 1));
+    double power239 = pow(239.0, -(2.0 * start + 1));
+    double sign = (start % 2 == 0) ? 1.0 : -1.0;
+    double sum = 0.0;
+    for (unsigned long long k = start; k < start + count && power5 > 0.0; k++) {
+        sum += sign * (16.0 * power5 - 4.0 * power239) / (2.0 * k + 1);
+        power5 /= 25.0;
+        power239 /= 57121.0;
+        sign = -sign;
+    }
+    return sum;
+}//machinTerms()
+
+double bbpTerms(unsigned long long start, unsigned long long count) {
+    double power = start < 300 ? ldexp(1.0, -4 * (int)start) : 0.0;
+    double sum = 0.0;
+    for (unsigned long long k = start; k < start + count && power > 0.0; k++) {
+        double k8 = 8.0 * k;
+        sum += power * (4.0 / (k8 + 1) - 2.0 / (k8 + 4) - 1.0 / (k8 + 5) - 1.0 / (k8 + 6));
+        power /= 16.0;
+    }
+    return sum;
+}//bbpTerms()
+
+double chudnovskyTerms(unsigned long long start, unsigned long long count) {
+    // Os fatoriais crescem rápido demais para double: a magnitude (6k)! / ((3k)! (k!)^3 C^(3k+3/2)) do primeiro termo
+    // é calculada em logaritmo (exata para k = 0) e as seguintes pela razão entre termos consecutivos.
+    const double cubeC = CHUDNOVSKY_C * CHUDNOVSKY_C * CHUDNOVSKY_C;
+    double magnitude = start == 0 ? pow(CHUDNOVSKY_C, -1.5)
+        : exp(lgamma(6.0 * start + 1) - lgamma(3.0 * start + 1) - 3.0 * lgamma(start + 1.0) - (3.0 * start + 1.5) * log(CHUDNOVSKY_C));
+    double sum = 0.0;
+    for (unsigned long long k = start; k < start + count && magnitude > 0.0; k++) {
+        double term = magnitude * (CHUDNOVSKY_A + CHUDNOVSKY_B * k);
+        sum += (k % 2 == 0) ? term : -term;
+        double k6 = 6.0 * k, k3 = 3.0 * k, k1 = k + 1.0;
+        magnitude *= (k6 + 1) * (k6 + 2) * (k6 + 3) * (k6 + 4) * (k6 + 5) * (k6 + 6)
+                   / ((k3 + 1) * (k3 + 2) * (k3 + 3) * k1 * k1 * k1 * cubeC);
+    }
+    return sum;
+}//chudnovskyTerms()
+
+static double leibnizToPi(double sum) {
+    return sum * 4.0;
+}//leibnizToPi()
+
+static double identityToPi(double sum) {
+    return sum;
+}//identityToPi()
+
+static double chudnovskyToPi(double sum) {
+    return 1.0 / (12.0 * sum);
+}//chudnovskyToPi()
+
+// Erro após N termos: ~1/N na série de Leibniz e o primeiro termo descartado nas demais.
+static unsigned long long leibnizTermsForDigits(unsigned int digits) {
+    return 2ULL * (unsigned long long)pow(10.0, digits);
+}//leibnizTermsForDigits()
+
+static unsigned long long machinTermsForDigits(unsigned int digits) {
+    return (unsigned long long)ceil((digits + 1) / log10(25.0)) + 1;
+}//machinTermsForDigits()
+
+static unsigned long long bbpTermsForDigits(unsigned int digits) {
+    return (unsigned long long)ceil((digits + 1) / log10(16.0)) + 1;
+}//bbpTermsForDigits()
+
+static unsigned long long chudnovskyTermsForDigits(unsigned int digits) {
+    return (unsigned long long)ceil((digits + 1) / log10(CHUDNOVSKY_C * CHUDNOVSKY_C * CHUDNOVSKY_C / 1728.0)) + 1;
+}//chudnovskyTermsForDigits()
+
+// Limitantes do erro após N termos: o primeiro termo descartado nas séries alternadas (Leibniz, Machin e Chudnovsky)
+// e a cauda geométrica na série BBP, cujos termos são positivos.
+static double leibnizErrorBound(unsigned long long terms) {
+    return 4.0 / (2.0 * terms + 1);
+}//leibnizErrorBound()
+
+// Soma dos |termos|, na escala de pi: ~2 ln(N) na série de Leibniz e limitada pelo primeiro termo nas demais.
+static double leibnizAbsoluteSum(unsigned long long terms) {
+    return 4.0 * (1.0 + 0.5 * log(2.0 * terms + 1.0));
+}//leibnizAbsoluteSum()
+
+static double fastSeriesAbsoluteSum(unsigned long long terms) {
+    (void)terms;
+    // Machin: 16/5 (25/24) + 4/239 (...) < 4; BBP: (4 + 2/4 + 1/5 + 1/6) (16/15) < 6; Chudnovsky: erro relativo da soma vezes pi.
+    return 6.0;
+}//fastSeriesAbsoluteSum()
+
+static double machinErrorBound(unsigned long long terms) {
+    return 16.0 * pow(5.0, -(2.0 * terms + 1)) / (2.0 * terms + 1);
+}//machinErrorBound()
+
+static double bbpErrorBound(unsigned long long terms) {
+    return 4.0 / (8.0 * terms + 1) * pow(16.0, -(double)terms) * 16.0 / 15.0;
+}//bbpErrorBound()
+
+static double chudnovskyErrorBound(unsigned long long terms) {
+    // O termo descartado t altera a soma S ~ 1/(12 pi); em pi = 1/(12 S), o erro é ~12 pi^2 t (dobrado por segurança).
+    double n = (double)terms;
+    double term = exp(lgamma(6.0 * n + 1) - lgamma(3.0 * n + 1) - 3.0 * lgamma(n + 1.0) - (3.0 * n + 1.5) * log(CHUDNOVSKY_C))
+                * (CHUDNOVSKY_A + CHUDNOVSKY_B * n);
+    return 2.0 * 12.0 * M_PI * M_PI * term;
+}//chudnovskyErrorBound()
+
+/* Retorna o backend da série 'series', que não pode ser SERIES_AUTO. */
+const Series* getSeries(SeriesType series) {
+    static const Series table[NUMBER_OF_SERIES] = {
+        [SERIES_LEIBNIZ] = {leibnizScalar, leibnizToPi, leibnizTermsForDigits, leibnizErrorBound, leibnizAbsoluteSum, 1.0},
+        [SERIES_MACHIN] = {machinTerms, identityToPi, machinTermsForDigits, machinErrorBound, fastSeriesAbsoluteSum, 4.0},
+        [SERIES_BBP] = {bbpTerms, identityToPi, bbpTermsForDigits, bbpErrorBound, fastSeriesAbsoluteSum, 5.0},
+        [SERIES_CHUDNOVSKY] = {chudnovskyTerms, chudnovskyToPi, chudnovskyTermsForDigits, chudnovskyErrorBound, fastSeriesAbsoluteSum, 30.0}
+    };
+    return &table[series > SERIES_AUTO && series < NUMBER_OF_SERIES ? series : SERIES_LEIBNIZ];
+}//getSeries()
+
+/* Retorna a série de menor custo estimado (termos necessários x custo por termo) para 'digits' casas decimais. */
+SeriesType cheapestSeries(unsigned int digits) {
+    SeriesType cheapest = SERIES_LEIBNIZ;
+    double cheapestCost = INFINITY;
+    for (SeriesType series = SERIES_LEIBNIZ; series < NUMBER_OF_SERIES; series++) {
+        const Series *backend = getSeries(series);
+        double cost = backend->termsForDigits(digits) * backend->costPerTerm;
+        if (cost < cheapestCost) {
+            cheapest = series;
+            cheapestCost = cost;
+        }
+    }
+    return cheapest;
+}//cheapestSeries()
+
+/* Retorna o kernel usado pelo escalonador para a série e o kernel de 'config': os kernels vetoriais para Leibniz
+   ou o kernel escalar da série nos demais casos.
+*/
+SeriesKernel selectSeriesKernel(const Config *config) {
+    if (config->series == SERIES_LEIBNIZ) {
+        KernelType kernel = config->kernel;
+        return selectKernel(&kernel);
+    }
+    return getSeries(config->series)->kernel;
+}//selectSeriesKernel()
+
+/* Retorna o nome da série 'series' (por exemplo, "machin"). */
+const char* seriesName(SeriesType series) {
+    static const char *names[NUMBER_OF_SERIES] = SERIES_NAMES;
+    return series < NUMBER_OF_SERIES ? names[series] : names[SERIES_AUTO];
+}//seriesName()
+
+/* Kernels escalares compensados: somam os termos [start, start + count) da série de Leibniz com
+   compensação a cada termo, em Kahan-Neumaier e em double-double, respectivamente.
+*/
+static inline void neumaierAdd(double *sum, double *compensation, double value) {
+    double total = *sum + value;
+    if (fabs(*sum) >= fabs(value)) {
+        *compensation += (*sum - total) + value;
+    }
+    else {
+        *compensation += (value - total) + *sum;
+    }
+    *sum = total;
+}//neumaierAdd()
+
+static inline void doubleDoubleAdd(double *high, double *low, double valueHigh, double valueLow) {
+    // TwoSum exato das partes altas seguido de uma renormalização (FastTwoSum).
+    double sum = *high + valueHigh;
+    double virtualValue = sum - *high;
+    double error = (*high - (sum - virtualValue)) + (valueHigh - virtualValue);
+    error += *low + valueLow;
+    *high = sum + error;
+    *low = error - (*high - sum);
+}//doubleDoubleAdd()
+
+CompensatedSum leibnizNeumaier(unsigned long long start, unsigned long long count) {
+    CompensatedSum result = {0.0, 0.0};
+    double sign = (start % 2 == 0) ? 1.0 : -1.0;
+    unsigned long long end = start + count;
+    for (unsigned long long i = start; i < end; i++) {
+        neumaierAdd(&result.sum, &result.compensation, sign / (2.0 * i + 1));
+        sign = -sign;
+    }
+    return result;
+}//leibnizNeumaier()
+
+CompensatedSum leibnizDoubleDouble(unsigned long long start, unsigned long long count) {
+    CompensatedSum result = {0.0, 0.0};
+    double sign = (start % 2 == 0) ? 1.0 : -1.0;
+    unsigned long long end = start + count;
+    for (unsigned long long i = start; i < end; i++) {
+        doubleDoubleAdd(&result.sum, &result.compensation, sign / (2.0 * i + 1), 0.0);
+        sign = -sign;
+    }
+    return result;
+}//leibnizDoubleDouble()
+
+/* Soma os termos [start, start + count) da série de Leibniz com o kernel 'kernel' e a estratégia 'mode'.
+   O kernel escalar compensa cada termo; os kernels vetoriais somam blocos de SUMMATION_BLOCK termos e
+   compensam (ou combinam par a par) as somas dos blocos.
+*/
+CompensatedSum sumTerms(SeriesKernel kernel, SummationMode mode, unsigned long long start, unsigned long long count) {
+    CompensatedSum result = {0.0, 0.0};
+    if (mode == SUMMATION_NAIVE) {
+        result.sum = kernel(start, count);
+        return result;
+    }
+    if (kernel == leibnizScalar && mode == SUMMATION_NEUMAIER) {
+        return leibnizNeumaier(start, count);
+    }
+    if (kernel == leibnizScalar && mode == SUMMATION_DOUBLE_DOUBLE) {
+        return leibnizDoubleDouble(start, count);
+    }
+
+    Accumulator accumulator;
+    accumulatorInit(&accumulator, mode);
+    for (unsigned long long offset = 0; offset < count; offset += SUMMATION_BLOCK) {
+        unsigned long long blockSize = count - offset < SUMMATION_BLOCK ? count - offset : SUMMATION_BLOCK;
+        CompensatedSum block = {kernel(start + offset, blockSize), 0.0};
+        accumulatorAdd(&accumulator, block);
+    }
+    return accumulatorResult(&accumulator);
+}//sumTerms()
+
+/* Acrescenta 'value' à soma 'sum' com correção 'compensation' segundo a estratégia 'policy', que é uma constante
+   nos kernels especializados: o compilador elimina os ramos das outras estratégias.
+*/
+static inline void policyAdd(SummationMode policy, double *sum, double *compensation, double value) {
+    if (policy == SUMMATION_NEUMAIER) {
+        neumaierAdd(sum, compensation, value);
+    }
+    else if (policy == SUMMATION_DOUBLE_DOUBLE) {
+        doubleDoubleAdd(sum, compensation, value, 0.0);
+    }
+    else {
+        *sum += value;
+    }
+}//policyAdd()
+
+/* Combina a parcela 'sum' com correção 'compensation' ao resultado 'result' segundo a estratégia 'policy'. */
+static inline void policyCombine(SummationMode policy, CompensatedSum *result, double sum, double compensation) {
+    if (policy == SUMMATION_DOUBLE_DOUBLE) {
+        doubleDoubleAdd(&result->sum, &result->compensation, sum, compensation);
+    }
+    else {
+        policyAdd(policy, &result->sum, &result->compensation, sum);
+        result->compensation += compensation;
+    }
+}//policyCombine()
+
+/* Gera o kernel especializado 'name' da série de Leibniz com a estratégia de soma POLICY, o comprimento LENGTH (0 para
+   qualquer comprimento), UNROLL pares de termos desdobrados por acumulador e ACCUMULATORS acumuladores independentes.
+   Com LENGTH e os limites do laço constantes, o compilador desdobra o laço interno por completo e conhece o número de
+   iterações do externo. Um 'start' ímpar só é aceito com LENGTH 0: o primeiro termo, negativo, é somado à parte.
+*/
+#define DEFINE_LEIBNIZ_SPECIALIZATION(name, POLICY, LENGTH, UNROLL, ACCUMULATORS) \
+CompensatedSum name(unsigned long long start, unsigned long long count) { \
+    CompensatedSum result = {0.0, 0.0}; \
+    if ((LENGTH) != 0) { \
+        count = (LENGTH); \
+    } \
+    else if (start % 2 == 1 && count > 0) { \
+        policyAdd(POLICY, &result.sum, &result.compensation, -1.0 / (2.0 * start + 1)); \
+        start++; \
+        count--; \
+    } \
+    const unsigned long long step = (UNROLL) * (ACCUMULATORS); \
+    unsigned long long blocks = count / 2 / step; \
+    double sum[ACCUMULATORS], compensation[ACCUMULATORS]; \
+    for (int j = 0; j < (ACCUMULATORS); j++) { \
+        sum[j] = 0.0; \
+        compensation[j] = 0.0; \
+    } \
+    double denominator = 2.0 * start + 1.0; \
+    for (unsigned long long block = 0; block < blocks; block++) { \
+        for (int u = 0; u < (UNROLL); u++) { \
+            for (int j = 0; j < (ACCUMULATORS); j++) { \
+                double d = denominator + 4.0 * (u * (ACCUMULATORS) + j); \
+                policyAdd(POLICY, &sum[j], &compensation[j], 2.0 / (d * (d + 2.0))); \
+            } \
+        } \
+        denominator += 4.0 * step; \
+    } \
+    for (int j = 0; j < (ACCUMULATORS); j++) { \
+        policyCombine(POLICY, &result, sum[j], compensation[j]); \
+    } \
+    /* Os termos que não completam um bloco, a partir de um termo par. */ \
+    double sign = 1.0; \
+    for (unsigned long long i = start + 2 * blocks * step; i < start + count; i++) { \
+        policyAdd(POLICY, &result.sum, &result.compensation, sign / (2.0 * i + 1)); \
+        sign = -sign; \
+    } \
+    return result; \
+}
+
+DEFINE_LEIBNIZ_SPECIALIZATION(leibnizNaiveAny, SUMMATION_NAIVE, 0, SPECIALIZED_UNROLL, SPECIALIZED_ACCUMULATORS)
+DEFINE_LEIBNIZ_SPECIALIZATION(leibnizNaiveLarge, SUMMATION_NAIVE, SPECIALIZED_LENGTH_LARGE, SPECIALIZED_UNROLL, SPECIALIZED_ACCUMULATORS)
+DEFINE_LEIBNIZ_SPECIALIZATION(leibnizNaiveSmall, SUMMATION_NAIVE, SPECIALIZED_LENGTH_SMALL, SPECIALIZED_UNROLL, SPECIALIZED_ACCUMULATORS)
+DEFINE_LEIBNIZ_SPECIALIZATION(leibnizNeumaierAny, SUMMATION_NEUMAIER, 0, SPECIALIZED_UNROLL, SPECIALIZED_ACCUMULATORS)
+DEFINE_LEIBNIZ_SPECIALIZATION(leibnizNeumaierLarge, SUMMATION_NEUMAIER, SPECIALIZED_LENGTH_LARGE, SPECIALIZED_UNROLL, SPECIALIZED_ACCUMULATORS)
+DEFINE_LEIBNIZ_SPECIALIZATION(leibnizNeumaierSmall, SUMMATION_NEUMAIER, SPECIALIZED_LENGTH_SMALL, SPECIALIZED_UNROLL, SPECIALIZED_ACCUMULATORS)
+DEFINE_LEIBNIZ_SPECIALIZATION(leibnizDoubleDoubleAny, SUMMATION_DOUBLE_DOUBLE, 0, SPECIALIZED_UNROLL, SPECIALIZED_ACCUMULATORS)
+DEFINE_LEIBNIZ_SPECIALIZATION(leibnizDoubleDoubleLarge, SUMMATION_DOUBLE_DOUBLE, SPECIALIZED_LENGTH_LARGE, SPECIALIZED_UNROLL, SPECIALIZED_ACCUMULATORS)
+DEFINE_LEIBNIZ_SPECIALIZATION(leibnizDoubleDoubleSmall, SUMMATION_DOUBLE_DOUBLE, SPECIALIZED_LENGTH_SMALL, SPECIALIZED_UNROLL, SPECIALIZED_ACCUMULATORS)
+
+/* Retorna o kernel especializado para a série, o kernel e a estratégia de soma de 'config' e chunks de 'length' termos
+   (0 para qualquer comprimento), ou NULL se não há especialização: só o kernel escalar da série de Leibniz com as somas
+   ingênua, Kahan-Neumaier e double-double é especializado, e só para os comprimentos SPECIALIZED_LENGTH_*.
+*/
+CompensatedKernel selectSpecializedKernel(const Config *config, unsigned long long length) {
+    // Uma linha por estratégia de soma, com os kernels de qualquer comprimento, do comprimento grande e do pequeno.
+    static const struct {
+        SummationMode summation;
+        CompensatedKernel kernels[3];
+    } table[] = {
+        {SUMMATION_NAIVE, {leibnizNaiveAny, leibnizNaiveLarge, leibnizNaiveSmall}},
+        {SUMMATION_NEUMAIER, {leibnizNeumaierAny, leibnizNeumaierLarge, leibnizNeumaierSmall}},
+        {SUMMATION_DOUBLE_DOUBLE, {leibnizDoubleDoubleAny, leibnizDoubleDoubleLarge, leibnizDoubleDoubleSmall}}
+    };
+    if (config->series != SERIES_LEIBNIZ || selectSeriesKernel(config) != leibnizScalar) {
+        return NULL;
+    }
+    int index;
+    if (length == 0) {
+        index = 0;
+    }
+    else if (length == SPECIALIZED_LENGTH_LARGE) {
+        index = 1;
+    }
+    else if (length == SPECIALIZED_LENGTH_SMALL) {
+        index = 2;
+    }
+    else {
+        return NULL;
+    }
+    for (unsigned int i = 0; i < sizeof(table) / sizeof(table[0]); i++) {
+        if (table[i].summation == config->summation) {
+            return table[i].kernels[index];
+        }
+    }
+    return NULL;
+}//selectSpecializedKernel()
+
+/* Inicializa 'accumulator' vazio com a estratégia 'mode'. */
+void accumulatorInit(Accumulator *accumulator, SummationMode mode) {
+    accumulator->mode = mode;
+    accumulator->sum = 0.0;
+    accumulator->compensation = 0.0;
+    accumulator->count = 0;
+}//accumulatorInit()
+
+/* Acrescenta 'value' (valor e correção) ao acumulador segundo a sua estratégia. */
+void accumulatorAdd(Accumulator *accumulator, CompensatedSum value) {
+    switch (accumulator->mode) {
+        case SUMMATION_NEUMAIER:
+            neumaierAdd(&accumulator->sum, &accumulator->compensation, value.sum);
+            accumulator->compensation += value.compensation;
+            break;
+        case SUMMATION_DOUBLE_DOUBLE:
+            doubleDoubleAdd(&accumulator->sum, &accumulator->compensation, value.sum, value.compensation);
+            break;
+        case SUMMATION_PAIRWISE: {
+            // Contador binário: cada "vai um" soma duas parcelas do mesmo tamanho no nível seguinte.
+            double carry = value.sum + value.compensation;
+            unsigned long long count = accumulator->count;
+            unsigned int level = 0;
+            while (count & 1) {
+                carry = accumulator->levels[level] + carry;
+                count >>= 1;
+                level++;
+            }
+            accumulator->levels[level] = carry;
+            accumulator->count++;
+            break;
+        }
+        default:
+            accumulator->sum += value.sum + value.compensation;
+            break;
+    }
+}//accumulatorAdd()
+
+/* Retorna a soma acumulada, com a correção separada do valor principal. */
+CompensatedSum accumulatorResult(const Accumulator *accumulator) {
+    CompensatedSum result = {accumulator->sum, accumulator->compensation};
+    if (accumulator->mode == SUMMATION_PAIRWISE) {
+        result.sum = 0.0;
+        for (unsigned int level = 0; level < PAIRWISE_LEVELS; level++) {
+            if ((accumulator->count >> level) & 1) {
+                result.sum += accumulator->levels[level];
+            }
+        }
+    }
+    return result;
+}//accumulatorResult()
+
+/* Retorna o nome da estratégia de soma 'mode' (por exemplo, "neumaier"). */
+const char* summationName(SummationMode mode) {
+    static const char *names[NUMBER_OF_SUMMATIONS] = SUMMATION_NAMES;
+    return mode < NUMBER_OF_SUMMATIONS ? names[mode] : names[SUMMATION_NAIVE];
+}//summationName()
+
+/* Cria um worker do pool descrito em 'task', fixado na CPU pool->threads[índice].cpu (livre se CPU_NOT_PINNED), e grava
+   a identificação da thread em 'threadID'. O worker executa a função poolWorker e a tarefa deve permanecer válida até o
+   término da thread.
+   Retorna TRUE se a thread foi criada ou FALSE, com errno indicando a causa, caso contrário.
+*/
+int createThread(ThreadTask *task, pthread_t *threadID) {
+    int cpu = task->pool->threads[task->index].cpu;
+    int error;
+
+    // A afinidade vai nos atributos para que o worker já comece na sua CPU, sem migrar depois de criado.
+    if (cpu != CPU_NOT_PINNED && cpu < CPU_SETSIZE) {
+        pthread_attr_t attributes;
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        pthread_attr_init(&attributes);
+        pthread_attr_setaffinity_np(&attributes, sizeof(cpu_set_t), &cpus);
+        error = pthread_create(threadID, &attributes, poolWorker, task);
+        pthread_attr_destroy(&attributes);
+        // A fixação é uma otimização: se a CPU não estiver disponível (cpuset restrito), o worker continua livre.
+        if (error == EINVAL) {
+            task->pool->threads[task->index].cpu = CPU_NOT_PINNED;
+            error = pthread_create(threadID, NULL, poolWorker, task);
+        }
+    }
+    else {
+        task->pool->threads[task->index].cpu = CPU_NOT_PINNED;
+        error = pthread_create(threadID, NULL, poolWorker, task);
+    }
+    if (error != 0) {
+        errno = error;
+        return FALSE;
+    }
+    return TRUE;
+}//createThread()
+
+/* Laço de um worker do pool: espera um trabalho, executa-o com o seu índice e slot de resultado e avisa quando termina,
+   até que o pool seja destruído.
+*/
+void* poolWorker(void *task) {
+    const ThreadTask *current = (const ThreadTask *)task;
+    ThreadPool *pool = current->pool;
+    unsigned long long generation = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->shutdown && pool->generation == generation) {
+            pthread_cond_wait(&pool->start, &pool->mutex);
+        }
+        if (pool->shutdown) {
+            break;
+        }
+        generation = pool->generation;
+        PoolJob job = pool->job;
+        void *argument = pool->argument;
+        pthread_mutex_unlock(&pool->mutex);
+
+        job(argument, current->index, &pool->slots[current->index].result);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->pending == 0) {
+            pthread_cond_broadcast(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}//poolWorker()
+
+/* Cria um pool com 'numberOfWorkers' workers persistentes e os seus slots (fila e resultado) pré-alocados em um único vetor
+   alinhado à linha de cache. O worker i é fixado na CPU cpus[i]; com 'cpus' NULL, os workers ficam livres.
+   Retorna o pool ou NULL, com errno indicando a causa, se a alocação ou a criação das threads falhar; nesse caso, os
+   workers já criados são encerrados.
+*/
+ThreadPool* createThreadPool(unsigned int numberOfWorkers, const int *cpus) {
+    ThreadPool *pool = (ThreadPool *)calloc(1, sizeof(ThreadPool));
+    if (pool == NULL) {
+        return NULL;
+    }
+    pool->numberOfWorkers = numberOfWorkers;
+    pool->threads = (Thread *)calloc(numberOfWorkers, sizeof(Thread));
+    pool->tasks = (ThreadTask *)calloc(numberOfWorkers, sizeof(ThreadTask));
+    pool->slots = (WorkerSlot *)aligned_alloc(CACHE_LINE_SIZE, numberOfWorkers * sizeof(WorkerSlot));
+    pool->completions = pool->threads != NULL && pool->tasks != NULL && pool->slots != NULL ? createCompletionQueue() : NULL;
+    if (pool->completions == NULL) {
+        int error = errno;
+        free(pool->slots);
+        free(pool->tasks);
+        free(pool->threads);
+        free(pool);
+        errno = error;
+        return NULL;
+    }
+    memset(pool->slots, 0, numberOfWorkers * sizeof(WorkerSlot));
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (unsigned int i = 0; i < numberOfWorkers; i++) {
+        pthread_mutex_init(&pool->slots[i].queue.mutex, NULL);
+        pool->tasks[i].pool = pool;
+        pool->tasks[i].index = i;
+        pool->threads[i].cpu = cpus != NULL ? cpus[i] : CPU_NOT_PINNED;
+        if (!createThread(&pool->tasks[i], &pool->threads[i].threadID)) {
+            // Encerra apenas os workers já criados.
+            int error = errno;
+            pthread_mutex_destroy(&pool->slots[i].queue.mutex);
+            pool->numberOfWorkers = i;
+            destroyThreadPool(pool);
+            errno = error;
+            return NULL;
+        }
+    }
+    return pool;
+}//createThreadPool()
+
+/* Submete o trabalho 'job' com o argumento 'argument' a todos os workers do pool, esperando antes o término do trabalho anterior. */
+void threadPoolSubmit(ThreadPool *pool, PoolJob job, void *argument) {
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    }
+    pool->job = job;
+    pool->argument = argument;
+    pool->pending = pool->numberOfWorkers;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+}//threadPoolSubmit()
+
+/* Espera até que todos os workers do pool terminem o trabalho submetido. */
+void threadPoolWait(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}//threadPoolWait()
+
+/* Encerra os workers do pool, espera o seu término e libera os seus recursos. */
+void destroyThreadPool(ThreadPool *pool) {
+    threadPoolWait(pool);
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutdown = TRUE;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (unsigned int i = 0; i < pool->numberOfWorkers; i++) {
+        pthread_join(pool->threads[i].threadID, NULL);
+        pthread_mutex_destroy(&pool->slots[i].queue.mutex);
+    }
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool->slots);
+    free(pool->tasks);
+    free(pool->threads);
+    destroyCompletionQueue(pool->completions);
+    free(pool);
+}//destroyThreadPool()
+
+/* Converte a lista de CPUs 'text' (por exemplo, 0-3,8,10-11) em até 'maximum' CPUs em 'cpus'.
+   Retorna o número de CPUs da lista ou 0 se a lista é inválida.
+*/
+unsigned int parseCpuList(const char *text, int *cpus, unsigned int maximum) {
+    unsigned int count = 0;
+    const char *current = text;
+    while (*current != NULL_CHAR && *current != NEW_LINE) {
+        char *end;
+        errno = 0;
+        long first = strtol(current, &end, 10);
+        long last = first;
+        if (end == current || errno != 0 || first < 0 || first >= CPU_SETSIZE) {
+            return 0;
+        }
+        if (*end == CPU_RANGE_SEPARATOR) {
+            current = end + 1;
+            last = strtol(current, &end, 10);
+            if (end == current || errno != 0 || last < first || last >= CPU_SETSIZE) {
+                return 0;
+            }
+        }
+        for (long cpu = first; cpu <= last; cpu++) {
+            if (count == maximum) {
+                return 0;
+            }
+            cpus[count++] = (int)cpu;
+        }
+        if (*end == CPU_LIST_SEPARATOR) {
+            end++;
+        }
+        else if (*end != NULL_CHAR && *end != NEW_LINE) {
+            return 0;
+        }
+        current = end;
+    }
+    return count;
+}//parseCpuList()
+
+/* Lê o inteiro do arquivo do sysfs 'format' da CPU 'cpu', ou retorna 'fallback' se o arquivo não existe. */
+static int readSysfsInt(const char *format, int cpu, int fallback) {
+    char path[STRING_DEFAULT_SIZE];
+    snprintf(path, sizeof(path), format, cpu);
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return fallback;
+    }
+    int value;
+    if (fscanf(file, "%d", &value) != 1) {
+        value = fallback;
+    }
+    fclose(file);
+    return value;
+}//readSysfsInt()
+
+/* Preenche 'cpus' (com espaço para CPU_SETSIZE entradas) com o nó NUMA, o pacote, o núcleo e a ordem SMT de cada CPU
+   que o processo pode usar, lidos do sysfs. Sem informação de topologia, cada CPU é um núcleo do nó e do pacote 0.
+   Retorna o número de CPUs.
+*/
+unsigned int detectTopology(CpuInfo *cpus) {
+    cpu_set_t allowed;
+    unsigned int count = 0;
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0) {
+        CPU_ZERO(&allowed);
+        for (unsigned int cpu = 0; cpu < detectNumberOfThreads(); cpu++) {
+            CPU_SET(cpu, &allowed);
+        }
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &allowed)) {
+            continue;
+        }
+        CpuInfo *info = &cpus[count++];
+        info->cpu = cpu;
+        info->node = 0;
+        info->package = readSysfsInt(SYSFS_CPU_PACKAGE, cpu, 0);
+        info->core = readSysfsInt(SYSFS_CPU_CORE, cpu, cpu);
+        // As irmãs de SMT têm o mesmo pacote e núcleo; a ordem entre elas segue o número da CPU.
+        info->smt = 0;
+        for (unsigned int i = 0; i + 1 < count; i++) {
+            if (cpus[i].package == info->package && cpus[i].core == info->core) {
+                info->smt++;
+            }
+        }
+    }
+
+    int nodeCpus[CPU_SETSIZE];
+    for (int node = 0; node < MAXIMUM_NUMA_NODES; node++) {
+        char path[STRING_DEFAULT_SIZE], list[STRING_DEFAULT_SIZE * 8];
+        snprintf(path, sizeof(path), SYSFS_NODE_CPULIST, node);
+        FILE *file = fopen(path, "r");
+        if (file == NULL) {
+            continue;
+        }
+        unsigned int size = fgets(list, sizeof(list), file) != NULL ? parseCpuList(list, nodeCpus, CPU_SETSIZE) : 0;
+        fclose(file);
+        for (unsigned int i = 0; i < size; i++) {
+            for (unsigned int j = 0; j < count; j++) {
+                if (cpus[j].cpu == nodeCpus[i]) {
+                    cpus[j].node = node;
+                }
+            }
+        }
+    }
+    return count;
+}//detectTopology()
+
+/* Compara lexicograficamente as chaves 'first' e 'second' de 'count' inteiros. */
+static int compareKeys(const int *first, const int *second, unsigned int count) {
+    for (unsigned int i = 0; i < count; i++) {
+        if (first[i] != second[i]) {
+            return first[i] < second[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}//compareKeys()
+
+/* Ordem compact: nó, pacote, núcleo e irmã de SMT, de modo que threads vizinhas compartilham caches. */
+static int compareCompact(const void *first, const void *second) {
+    const CpuInfo *a = (const CpuInfo *)first, *b = (const CpuInfo *)second;
+    int keyA[] = {a->node, a->package, a->core, a->smt, a->cpu};
+    int keyB[] = {b->node, b->package, b->core, b->smt, b->cpu};
+    return compareKeys(keyA, keyB, sizeof(keyA) / sizeof(keyA[0]));
+}//compareCompact()
+
+/* Ordem scatter: irmã de SMT, núcleo e nó/pacote, de modo que threads vizinhas ficam em núcleos e pacotes diferentes. */
+static int compareScatter(const void *first, const void *second) {
+    const CpuInfo *a = (const CpuInfo *)first, *b = (const CpuInfo *)second;
+    int keyA[] = {a->smt, a->core, a->node, a->package, a->cpu};
+    int keyB[] = {b->smt, b->core, b->node, b->package, b->cpu};
+    return compareKeys(keyA, keyB, sizeof(keyA) / sizeof(keyA[0]));
+}//compareScatter()
+
+/* Calcula as CPUs das config->numberOfThreads threads do processo 'process' (de 0 a numberOfProcesses - 1)
+   segundo a política config->affinity. Na política compact, scatter e list, os processos ocupam posições consecutivas
+   da ordem das CPUs; na política numa, o processo fica no nó (process % nós).
+   Retorna um vetor alocado com a CPU de cada thread, que deve ser liberado, ou NULL na política AFFINITY_NONE ou se
+   faltar memória (com errno ENOMEM).
+*/
+int* createPlacement(const Config *config, unsigned int numberOfProcesses, unsigned int process) {
+    if (config->affinity == AFFINITY_NONE) {
+        return NULL;
+    }
+    unsigned int numberOfThreads = config->numberOfThreads;
+    int *placement = (int *)malloc(numberOfThreads * sizeof(int));
+    if (placement == NULL) {
+        return NULL;
+    }
+    unsigned long long first = (unsigned long long)(process % numberOfProcesses) * numberOfThreads;
+    if (config->affinity == AFFINITY_LIST) {
+        for (unsigned int i = 0; i < numberOfThreads; i++) {
+            placement[i] = config->affinityList[(first + i) % config->affinityListSize];
+        }
+        return placement;
+    }
+
+    CpuInfo *cpus = (CpuInfo *)malloc(CPU_SETSIZE * sizeof(CpuInfo));
+    if (cpus == NULL) {
+        free(placement);
+        return NULL;
+    }
+    unsigned int count = detectTopology(cpus);
+    qsort(cpus, count, sizeof(CpuInfo), config->affinity == AFFINITY_SCATTER ? compareScatter : compareCompact);
+
+    CpuInfo *candidates = cpus;
+    if (config->affinity == AFFINITY_NUMA) {
+        // Os nós aparecem em ordem crescente na ordem compact; o processo usa apenas as CPUs do seu nó.
+        unsigned int numberOfNodes = 0, start = 0;
+        for (unsigned int i = 0; i < count; i++) {
+            if (i == 0 || cpus[i].node != cpus[i - 1].node) {
+                numberOfNodes++;
+            }
+        }
+        unsigned int node = process % numberOfNodes;
+        for (unsigned int seen = 0; start < count; start++) {
+            if (start > 0 && cpus[start].node != cpus[start - 1].node) {
+                seen++;
+            }
+            if (seen == node) {
+                break;
+            }
+        }
+        unsigned int end = start;
+        while (end < count && cpus[end].node == cpus[start].node) {
+            end++;
+        }
+        candidates = &cpus[start];
+        count = end - start;
+        first = 0;
+    }
+    for (unsigned int i = 0; i < numberOfThreads; i++) {
+        placement[i] = candidates[(first + i) % count].cpu;
+    }
+    free(cpus);
+    return placement;
+}//createPlacement()
+
+/* Restringe o processo atual às CPUs 'cpus' de 'count' threads e, na política numa, a todas as CPUs do nó dessas threads,
+   para que a thread principal e as alocações do processo fiquem junto das suas threads. A falha é ignorada.
+*/
+void bindProcess(const Config *config, const int *cpus, unsigned int count) {
+    if (cpus == NULL) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned int i = 0; i < count; i++) {
+        if (cpus[i] >= 0 && cpus[i] < CPU_SETSIZE) {
+            CPU_SET(cpus[i], &set);
+        }
+    }
+    if (config->affinity == AFFINITY_NUMA) {
+        CpuInfo *topology = (CpuInfo *)malloc(CPU_SETSIZE * sizeof(CpuInfo));
+        if (topology != NULL) {
+            unsigned int size = detectTopology(topology);
+            int node = -1;
+            for (unsigned int i = 0; i < size; i++) {
+                if (topology[i].cpu == cpus[0]) {
+                    node = topology[i].node;
+                }
+            }
+            for (unsigned int i = 0; i < size; i++) {
+                if (topology[i].node == node) {
+                    CPU_SET(topology[i].cpu, &set);
+                }
+            }
+            free(topology);
+        }
+    }
+    sched_setaffinity(0, sizeof(cpu_set_t), &set);
+}//bindProcess()
+
+/* Retorna o nome da política de afinidade 'policy'. */
+const char* affinityName(AffinityPolicy policy) {
+    static const char *names[NUMBER_OF_AFFINITIES] = AFFINITY_NAMES;
+    return policy < NUMBER_OF_AFFINITIES ? names[policy] : names[AFFINITY_NONE];
+}//affinityName()
+
+/* Divide 'numberOfTerms' termos em 'numberOfParts' intervalos contíguos e preenche 'range' com o intervalo de índice 'index'.
+   Os primeiros (numberOfTerms % numberOfParts) intervalos recebem um termo a mais, de modo que todos os termos são cobertos.
+*/
+void partitionTerms(unsigned long long numberOfTerms, unsigned int numberOfParts, unsigned int index, TermRange *range) {
+    unsigned long long base = numberOfTerms / numberOfParts;
+    unsigned long long remainder = numberOfTerms % numberOfParts;
+    range->start = index * base + (index < remainder ? index : remainder);
+    range->count = base + (index < remainder ? 1 : 0);
+}//partitionTerms()
+
+/* A função 'fillThreadTidAndTime' é responsável por preencher uma estrutura de thread 'Thread' com o ID da thread (TID) e o tempo de execução,
+   obtidos a partir da estrutura 'ThreadResult'.
+
+   Parâmetros:
+   - threadResult: A estrutura 'ThreadResult' que contém o TID e o tempo de execução.
+   - thread: Ponteiro para a estrutura 'Thread' a ser preenchida.
+*/
+void fillThreadTidAndTime(ThreadResult threadResult, Thread* thread){
+    thread->tid = threadResult.thread.tid;
+    thread->time = threadResult.thread.time;
+    thread->cpuTime = threadResult.thread.cpuTime;
+    thread->terms = threadResult.thread.terms;
+    thread->chunks = threadResult.thread.chunks;
+    thread->steals = threadResult.thread.steals;
+    thread->lastCpu = threadResult.thread.lastCpu;
+    thread->voluntarySwitches = threadResult.thread.voluntarySwitches;
+    thread->involuntarySwitches = threadResult.thread.involuntarySwitches;
+    thread->migrations = threadResult.thread.migrations;
+    thread->cycles = threadResult.thread.cycles;
+    thread->instructions = threadResult.thread.instructions;
+    thread->hardwareCounters = threadResult.thread.hardwareCounters;
+    thread->started = threadResult.thread.started;
+    thread->finished = threadResult.thread.finished;
+}//fillThreadTidAndTime()
+
+
+/* Retorna o número de chunks de config->chunkSize termos que cobrem os config->numberOfTerms termos. */
+unsigned long long countChunks(const Config *config) {
+    return (config->numberOfTerms + config->chunkSize - 1) / config->chunkSize;
+}//countChunks()
+
+/* Pede o cancelamento de todos os cálculos em andamento no processo; cada um para antes do próximo chunk e reporta
+   o que já somou. Pode ser chamada de um tratador de sinal.
+*/
+void cancelCalculation() {
+    __atomic_store_n(&cancelRequested, TRUE, __ATOMIC_RELAXED);
+}//cancelCalculation()
+
+/* Tratador do SIGINT: cancela o cálculo com cancelCalculation() e restaura a ação padrão, de modo que um segundo
+   SIGINT encerra o programa.
+*/
+void handleInterrupt(int signalNumber) {
+    (void)signalNumber;
+    cancelCalculation();
+    signal(SIGINT, SIG_DFL);
+}//handleInterrupt()
+
+/* Tratador do SIGINT nos processos filhos: apenas cancela o cálculo com cancelCalculation(). O sinal pode chegar duas vezes,
+   do terminal e repassado pelo pai, e o segundo não pode encerrar o filho antes de ele publicar o que somou.
+*/
+void handleChildInterrupt(int signalNumber) {
+    (void)signalNumber;
+    cancelCalculation();
+}//handleChildInterrupt()
+
+/* Callback de progresso da opção --progress: escreve o progresso do processo filho cujo número está em 'context'.
+   Retorna TRUE (nunca cancela o cálculo).
+*/
+int printProgress(const Progress *progress, void *context) {
+    double percent = progress->totalTerms > 0 ? 100.0 * progress->terms / progress->totalTerms : 100.0;
+    String line;
+    formatReport(line, STRING_DEFAULT_SIZE, PROGRESS_LINE, *(const int *)context, progress->chunks, progress->totalChunks,
+                 progress->terms, progress->totalTerms, percent, progress->elapsed);
+    printf("%s%c", line, NEW_LINE);
+    fflush(stdout);
+    return TRUE;
+}//printProgress()
+
+/* Retorna o instante atual do DURATION_CLOCK em segundos. */
+double monotonicSeconds() {
+    struct timespec now;
+    clock_gettime(DURATION_CLOCK, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}//monotonicSeconds()
+
+/* Soma os termos dos chunks [chunks.start, chunks.start + chunks.count) da série config->series submetendo sumPartial
+   a todos os workers do pool 'pool' e reduz, com a estratégia config->summation, a soma de cada chunk na ordem em que os
+   workers a publicam na fila de conclusões, sem esperar pelo mais lento. Enquanto espera, chama config->progress a cada
+   PROGRESS_INTERVAL segundos e cancela o cálculo quando o callback retorna FALSE, quando config->deadlineAt passa ou
+   quando cancelCalculation() é chamada ou *config->cancel é TRUE; os workers param antes do próximo chunk. Se 'progress' não for NULL, recebe
+   os termos e chunks reduzidos, o motivo do cancelamento e o prefixo contíguo de chunks reduzidos desde chunks.start, o único
+   que forma uma soma parcial da série quando o cálculo é cancelado. Se config->chunkSums não for NULL, a soma de cada chunk
+   reduzido também é gravada nele, na posição do chunk.
+   Retorna a soma dos chunks reduzidos com a sua correção.
+*/
+CompensatedSum sumSeries(const Config *config, ThreadPool *pool, TermRange chunks, Progress *progress) {
+    unsigned int numberOfThreads = pool->numberOfWorkers;
+    WorkerSlot *slots = pool->slots;
+    Scheduler scheduler = {
+        .slots = slots,
+        .numberOfWorkers = numberOfThreads,
+        .numberOfTerms = config->numberOfTerms,
+        .chunkSize = config->chunkSize,
+        .kernel = selectSeriesKernel(config),
+        .summation = config->summation,
+        .fullKernel = selectSpecializedKernel(config, config->chunkSize),
+        .partialKernel = selectSpecializedKernel(config, 0),
+        .completions = pool->completions,
+        .cancelled = FALSE,
+        .checkpoint = config->checkpoint,
+        .cache = config->cache,
+        .hardwareCounters = config->hardwareCounters,
+        .stream = config->stream
+    };
+
+    // Cada fila começa com uma fatia contígua dos chunks; o roubo de trabalho corrige o desequilíbrio depois.
+    for (unsigned int i = 0; i < numberOfThreads; i++) {
+        TermRange slice;
+        partitionTerms(chunks.count, numberOfThreads, i, &slice);
+        slots[i].queue.top = chunks.start + slice.start;
+        slots[i].queue.bottom = chunks.start + slice.start + slice.count;
+    }
+    Progress current = {0};
+    current.totalChunks = chunks.count;
+    unsigned long long last = (chunks.start + chunks.count) * config->chunkSize;
+    current.totalTerms = chunks.count == 0 ? 0 : (last < config->numberOfTerms ? last : config->numberOfTerms) - chunks.start * config->chunkSize;
+    double started = monotonicSeconds(), reported = started;
+    threadPoolSubmit(pool, sumPartial, &scheduler);
+
+    // Agregador: reduz cada chunk assim que um worker o conclui, até que todos os workers avisem que terminaram.
+    Accumulator accumulator;
+    accumulatorInit(&accumulator, config->summation);
+    CompletionPrefix prefix;
+    initCompletionPrefix(&prefix, chunks.start, config->summation);
+    unsigned int finished = 0;
+    while (finished < numberOfThreads) {
+        Completion completion;
+        if (popCompletion(pool->completions, &completion)) {
+            if (completion.chunk == COMPLETION_WORKER_DONE) {
+                finished++;
+            }
+            else {
+                accumulatorAdd(&accumulator, completion.sum);
+                addCompletionPrefix(&prefix, &completion);
+                if (config->chunkSums != NULL) {
+                    config->chunkSums[completion.chunk] = completion.sum;
+                }
+                current.terms += completion.terms;
+                current.chunks++;
+            }
+            continue;
+        }
+
+        double now = monotonicSeconds();
+        current.elapsed = now - started;
+        if (current.cancelled == CANCEL_NONE) {
+            if (__atomic_load_n(&cancelRequested, __ATOMIC_RELAXED) || (config->cancel != NULL && __atomic_load_n(config->cancel, __ATOMIC_RELAXED))) {
+                current.cancelled = CANCEL_REQUEST;
+            }
+            else if (config->deadlineAt > 0.0 && now >= config->deadlineAt) {
+                current.cancelled = CANCEL_DEADLINE;
+            }
+            else if (config->progress != NULL && now - reported >= PROGRESS_INTERVAL) {
+                current.sum = accumulatorResult(&accumulator);
+                reported = now;
+                if (!config->progress(&current, config->progressContext)) {
+                    current.cancelled = CANCEL_REQUEST;
+                }
+            }
+            if (current.cancelled != CANCEL_NONE) {
+                __atomic_store_n(&scheduler.cancelled, TRUE, __ATOMIC_RELAXED);
+            }
+        }
+        // Acorda com a próxima conclusão, ou a tempo de verificar o prazo, o cancelamento e o progresso.
+        double timeout = COMPLETION_WAIT_INTERVAL;
+        if (config->deadlineAt > 0.0 && current.cancelled == CANCEL_NONE && config->deadlineAt - now < timeout) {
+            timeout = config->deadlineAt - now;
+        }
+        waitCompletion(pool->completions, timeout);
+    }
+    threadPoolWait(pool);
+
+    current.sum = accumulatorResult(&accumulator);
+    current.prefix = accumulatorResult(&prefix.accumulator);
+    current.prefixTerms = prefix.terms;
+    freeCompletionPrefix(&prefix);
+    current.elapsed = monotonicSeconds() - started;
+    if (progress != NULL) {
+        *progress = current;
+    }
+    return current.sum;
+}//sumSeries()
+
+/* Aplica a aceleração 'mode' à soma 'series' dos primeiros 'numberOfTerms' termos da série de Leibniz.
+   - ACCELERATION_TAIL soma a correção assintótica da cauda, pi - 4 S(N) ~ (-1)^N 2 sum(E(2m) / (2N)^(2m+1)),
+     onde E(2m) são os números de Euler, parando quando os termos assintóticos deixam de diminuir.
+   - ACCELERATION_EULER reconstrói as últimas ACCELERATION_DEPTH somas parciais e as combina com médias repetidas
+     (transformação de Euler na forma de Van Wijngaarden).
+   Retorna a estimativa de pi.
+*/
+double accelerateSeries(CompensatedSum series, unsigned long long numberOfTerms, AccelerationMode mode) {
+    if (mode == ACCELERATION_TAIL) {
+        static const double eulerNumbers[] = EULER_NUMBERS;
+        const unsigned int count = sizeof(eulerNumbers) / sizeof(eulerNumbers[0]);
+        double n = 2.0 * numberOfTerms;
+        double power = n, correction = 0.0, previous = INFINITY;
+        for (unsigned int m = 0; m < count; m++) {
+            double term = eulerNumbers[m] / power;
+            if (fabs(term) >= previous) {
+                break;
+            }
+            correction += term;
+            previous = fabs(term);
+            power *= n * n;
+        }
+        correction *= (numberOfTerms % 2 == 0) ? 2.0 : -2.0;
+        return (series.sum + series.compensation) * 4.0 + correction;
+    }
+    if (mode == ACCELERATION_EULER) {
+        // partial[j] = S(N - depth + j); as médias são lineares, então a correção da soma é somada só no fim.
+        double partial[ACCELERATION_DEPTH + 1];
+        unsigned int depth = numberOfTerms < ACCELERATION_DEPTH ? (unsigned int)numberOfTerms : ACCELERATION_DEPTH;
+        partial[depth] = series.sum;
+        for (int j = (int)depth - 1; j >= 0; j--) {
+            unsigned long long k = numberOfTerms - depth + j;
+            double term = 1.0 / (2.0 * k + 1);
+            partial[j] = partial[j + 1] - (k % 2 == 0 ? term : -term);
+        }
+        for (unsigned int round = 0; round < depth; round++) {
+            for (unsigned int j = 0; j < depth - round; j++) {
+                partial[j] = (partial[j] + partial[j + 1]) * 0.5;
+            }
+        }
+        return (partial[0] + series.compensation) * 4.0;
+    }
+    return (series.sum + series.compensation) * 4.0;
+}//accelerateSeries()
+
+/* Retorna o nome do modo de aceleração 'mode' (por exemplo, "tail"). */
+const char* accelerationName(AccelerationMode mode) {
+    static const char *names[NUMBER_OF_ACCELERATIONS] = ACCELERATION_NAMES;
+    return mode < NUMBER_OF_ACCELERATIONS ? names[mode] : names[ACCELERATION_NONE];
+}//accelerationName()
+
+/* Mede, para cada estratégia de soma, o tempo, a vazão em termos por segundo e o erro de arredondamento
+   em relação à soma double-double, usando os termos, threads e kernel de 'config'. Escreve a tabela na saída padrão.
+*/
+void benchmarkSummation(const Config *config) {
+    int *placement = createPlacement(config, 1, 0);
+    if (placement == NULL && config->affinity != AFFINITY_NONE) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    ThreadPool *pool = createThreadPool(config->numberOfThreads, placement);
+    if (pool == NULL) {
+        perror(ERROR_THREAD_POOL);
+        exit(EXIT_FAILURE);
+    }
+    Config modeConfig = *config;
+    const Series *series = getSeries(config->series);
+    struct timespec startTime, endTime;
+    TermRange chunks = {0, countChunks(config)};
+
+    // A referência é a soma double-double termo a termo do kernel escalar, livre dos blocos ingênuos dos kernels vetoriais.
+    modeConfig.kernel = KERNEL_SCALAR;
+    modeConfig.summation = SUMMATION_DOUBLE_DOUBLE;
+    CompensatedSum reference = sumSeries(&modeConfig, pool, chunks, NULL);
+
+    // Aquecimento: a primeira execução com o kernel escolhido não é medida.
+    modeConfig.kernel = config->kernel;
+    modeConfig.summation = SUMMATION_NAIVE;
+    sumSeries(&modeConfig, pool, chunks, NULL);
+
+    printf(BENCHMARK_SUMMATION_TITLE, config->numberOfTerms, config->numberOfThreads, kernelName(config->kernel));
+    printf(BENCHMARK_SUMMATION_HEADER, BENCHMARK_SUMMATION_COLUMNS);
+    for (SummationMode mode = 0; mode < NUMBER_OF_SUMMATIONS; mode++) {
+        modeConfig.summation = mode;
+        clock_gettime(DURATION_CLOCK, &startTime);
+        CompensatedSum sum = sumSeries(&modeConfig, pool, chunks, NULL);
+        clock_gettime(DURATION_CLOCK, &endTime);
+
+        double duration = calculateDuration(startTime, endTime);
+        double pi = series->toPi(sum.sum + sum.compensation);
+        double error = fabs(pi - series->toPi(reference.sum + reference.compensation));
+        printf(BENCHMARK_SUMMATION_ROW, summationName(mode), duration,
+               duration > 0.0 ? config->numberOfTerms / duration : 0.0, pi, error);
+    }
+    destroyThreadPool(pool);
+    free(placement);
+}//benchmarkSummation()
+
+/* Trabalho do benchmark de layout: soma a fatia de termos de Leibniz do worker 'worker' gravando a soma no local
+   determinado pelo layout do argumento 'argument' (um LayoutBenchmark); o resultado fica em 'result'.
 */
-int createReport(const Report *report) {
-    if (report == NULL) {
-        return FALSE;
+void layoutWorker(void *argument, unsigned int worker, ThreadResult *result) {
+    const LayoutBenchmark *benchmark = (const LayoutBenchmark *)argument;
+    TermRange range;
+    partitionTerms(benchmark->numberOfTerms, benchmark->numberOfWorkers, worker, &range);
+    unsigned long long end = range.start + range.count;
+
+    if (benchmark->mode == LAYOUT_REGISTER) {
+        result->sumPartional = leibnizScalar(range.start, range.count);
+        return;
     }
-    else if (report->processReport1.identification[0] == NULL_CHAR || report->processReport2.identification[0] == NULL_CHAR) {
-        return FALSE;
+    // O acesso volátil força uma gravação por termo, como no acumulador escrito direto no resultado.
+    volatile double *sum = benchmark->mode == LAYOUT_PACKED ? &benchmark->packed[worker] : &result->sumPartional;
+    *sum = 0.0;
+    for (unsigned long long i = range.start; i < end; i++) {
+        double term = 1.0 / (2.0 * i + 1);
+        if (i % 2 == 0) {
+            *sum += term;
+        }
+        else {
+            *sum -= term;
+        }
     }
+    if (benchmark->mode == LAYOUT_PACKED) {
+        result->sumPartional = *sum;
+    }
+}//layoutWorker()
 
-    printf("%s%s%s", EMPTY_LINE, report->programName, EMPTY_LINE);
-    printf("%s%c", report->message1, NEW_LINE);
-    printf("%s%c", report->message2, NEW_LINE);
+/* Mede o tempo, a vazão e o speedup em relação a uma thread de cada layout de resultados por worker, com 1, 2, 4, ...
+   até config->numberOfThreads threads e config->numberOfTerms termos. Escreve a tabela na saída padrão.
+*/
+void benchmarkLayout(const Config *config) {
+    volatile double *packed = (volatile double *)calloc(config->numberOfThreads, sizeof(double));
+    if (packed == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    double single[NUMBER_OF_LAYOUTS] = {0.0};
+    int *placement = createPlacement(config, 1, 0);
+    if (placement == NULL && config->affinity != AFFINITY_NONE) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    struct timespec startTime, endTime;
 
-    printf("%c%s%s", NEW_LINE, report->processReport1.identification, EMPTY_LINE);
-    printf("%c%s%s", TAB, report->processReport1.numberOfThreads, EMPTY_LINE);
-    printf("%c%s%c", TAB, report->processReport1.start, NEW_LINE);
-    printf("%c%s%c", TAB, report->processReport1.end, NEW_LINE);
-    printf("%c%s%s", TAB, report->processReport1.duration, EMPTY_LINE);
-    printf("%c%s%s", TAB, report->processReport1.pi, EMPTY_LINE);
+    printf(BENCHMARK_LAYOUT_TITLE, config->numberOfTerms, config->numberOfThreads);
+    printf(BENCHMARK_LAYOUT_HEADER, BENCHMARK_LAYOUT_COLUMNS);
+    for (unsigned int workers = 1; ; workers = workers * 2 < config->numberOfThreads ? workers * 2 : config->numberOfThreads) {
+        ThreadPool *pool = createThreadPool(workers, placement);
+        if (pool == NULL) {
+            perror(ERROR_THREAD_POOL);
+            exit(EXIT_FAILURE);
+        }
+        LayoutBenchmark benchmark = {
+            .numberOfTerms = config->numberOfTerms,
+            .numberOfWorkers = workers,
+            .packed = packed
+        };
+        for (LayoutMode mode = 0; mode < NUMBER_OF_LAYOUTS; mode++) {
+            benchmark.mode = mode;
+            clock_gettime(DURATION_CLOCK, &startTime);
+            threadPoolSubmit(pool, layoutWorker, &benchmark);
+            threadPoolWait(pool);
+            clock_gettime(DURATION_CLOCK, &endTime);
 
-    printf("%s%s", report->processReport2.identification, EMPTY_LINE);
-    printf("%c%s%s", TAB, report->processReport2.numberOfThreads, EMPTY_LINE);
-    printf("%c%s%c", TAB, report->processReport2.start, NEW_LINE);
-    printf("%c%s%c", TAB, report->processReport2.end, NEW_LINE);
-    printf("%c%s%s", TAB, report->processReport2.duration, EMPTY_LINE);
-    printf("%c%s%s", TAB, report->processReport2.pi, EMPTY_LINE);
+            double duration = calculateDuration(startTime, endTime);
+            if (workers == 1) {
+                single[mode] = duration;
+            }
+            printf(BENCHMARK_LAYOUT_ROW, workers, layoutName(mode), duration,
+                   duration > 0.0 ? config->numberOfTerms / duration : 0.0,
+                   duration > 0.0 ? single[mode] / duration : 0.0);
+        }
+        destroyThreadPool(pool);
+        if (workers == config->numberOfThreads) {
+            break;
+        }
+    }
+    free(placement);
+    free((void *)packed);
+}//benchmarkLayout()
 
-    return TRUE;
-}//createReport();
+/* Retorna o nome do layout 'mode'. */
+const char* layoutName(LayoutMode mode) {
+    static const char *names[NUMBER_OF_LAYOUTS] = LAYOUT_NAMES;
+    return mode < NUMBER_OF_LAYOUTS ? names[mode] : names[LAYOUT_PACKED];
+}//layoutName()
 
-/* Cria o arquivo texto no diretório atual usando o nome do arquivo, a descrição e os dados do vetor do tipo Threads.
- * Retorna TRUE se o arquivo foi criado com sucesso ou FALSE se ocorreu algum erro.
- */
-int createFile(const FileName fileName, String description, const Threads threads) {
-    
-    FILE *arquivo;
-    arquivo = fopen(fileName, FILE_OPENING_OPTION);
+/* Soma a fatia 'chunks' da série config->series submetendo a soma parcial a todos os workers do pool 'pool'
+   e copia a identificação e os tempos das threads para 'threads'. Se 'progress' não for NULL, recebe o progresso final
+   de sumSeries (termos reduzidos e motivo do cancelamento).
+   Retorna a soma parcial da fatia com a sua correção.
+*/
+CompensatedSum calculationOfNumberPi(const Config *config, ThreadPool *pool, TermRange chunks, Thread *threads, Progress *progress){
+    unsigned int numberOfThreads = pool->numberOfWorkers;
+    CompensatedSum series = sumSeries(config, pool, chunks, progress);
+    for (unsigned int i = 0; i < numberOfThreads; i++) {
+        fillThreadTidAndTime(pool->slots[i].result, &pool->threads[i]);
+        threads[i] = pool->threads[i];
+    }
+    return series;
+}//calculationOfNumberPi();
 
-    if (arquivo == NULL) {
-        perror(ERROR_FILE);
+/* Calcula pi a partir da soma 'series' dos config->numberOfTerms termos, aplicando a aceleração config->acceleration
+   (apenas Leibniz).
+   Retorna as estimativas com e sem aceleração e o número de termos avaliados.
+*/
+PiResult seriesResult(const Config *config, CompensatedSum series) {
+    PiResult result;
+    result.rawPi = getSeries(config->series)->toPi(series.sum + series.compensation);
+    result.pi = config->series == SERIES_LEIBNIZ
+        ? accelerateSeries(series, config->numberOfTerms, config->acceleration)
+        : result.rawPi;
+    result.terms = config->numberOfTerms;
+    return result;
+}//seriesResult()
+
+/* Cria e mapeia o segmento de memória compartilhada dos resultados de 'numberOfProcesses' processos com 'numberOfThreads'
+   threads cada. O nome é removido logo após o mapeamento, de modo que o segmento desaparece com o último processo.
+   Em caso de falha, imprime uma mensagem de erro e encerra o programa.
+*/
+SharedResults* createSharedResults(unsigned int numberOfProcesses, unsigned int numberOfThreads) {
+    size_t threadBlockSize = numberOfThreads * sizeof(Thread);
+    threadBlockSize = (threadBlockSize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+    size_t size = sizeof(SharedResults) + numberOfProcesses * (sizeof(SharedProcess) + threadBlockSize);
+
+    String name;
+    snprintf(name, STRING_DEFAULT_SIZE, SHARED_MEMORY_NAME, getpid());
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, SHARED_MEMORY_MODE);
+    if (fd < 0) {
+        perror(ERROR_SHARED_MEMORY);
+        exit(EXIT_FAILURE);
+    }
+    SharedResults *shared = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0) {
+        shared = (SharedResults *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    shm_unlink(name);
+    close(fd);
+    if (shared == MAP_FAILED) {
+        perror(ERROR_SHARED_MEMORY);
+        exit(EXIT_FAILURE);
+    }
+    // O segmento começa zerado: nenhum processo publicou.
+    shared->numberOfProcesses = numberOfProcesses;
+    shared->numberOfThreads = numberOfThreads;
+    shared->threadBlockSize = threadBlockSize;
+    shared->size = size;
+    return shared;
+}//createSharedResults()
+
+/* Desfaz o mapeamento do segmento 'shared'. */
+void destroySharedResults(SharedResults *shared) {
+    munmap(shared, shared->size);
+}//destroySharedResults()
+
+/* Retorna o resultado do processo de índice 'index' (0 para pi1) no segmento 'shared'. */
+SharedProcess* sharedProcess(SharedResults *shared, unsigned int index) {
+    return (SharedProcess *)(shared + 1) + index;
+}//sharedProcess()
+
+/* Retorna as threads do processo de índice 'index' (0 para pi1) no segmento 'shared'. */
+Thread* sharedThreads(SharedResults *shared, unsigned int index) {
+    char *threads = (char *)sharedProcess(shared, shared->numberOfProcesses);
+    return (Thread *)(threads + index * shared->threadBlockSize);
+}//sharedThreads()
+
+/* Publica o resultado do processo de índice 'index': marca-o como publicado, incrementa o contador de processos concluídos
+   e acorda o pai que espera no futex desse contador. O resultado deve estar completo antes da chamada.
+*/
+void publishResult(SharedResults *shared, unsigned int index) {
+    __atomic_store_n(&sharedProcess(shared, index)->published, TRUE, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&shared->completed, 1, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &shared->completed, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}//publishResult()
+
+/* Espera no futex do contador de processos concluídos enquanto ele vale 'completed', por até 'interval' milissegundos.
+   Retorna FALSE se o tempo acabou sem mudança ou TRUE caso contrário.
+*/
+int waitForResults(SharedResults *shared, unsigned int completed, unsigned int interval) {
+    struct timespec timeout = {interval / 1000, (interval % 1000) * 1000000L};
+    // O segmento é compartilhado entre processos, por isso o futex não pode ser FUTEX_PRIVATE.
+    if (syscall(SYS_futex, &shared->completed, FUTEX_WAIT, completed, &timeout, NULL, 0) != 0 && errno == ETIMEDOUT) {
         return FALSE;
     }
+    return TRUE;
+}//waitForResults()
 
-    fprintf(arquivo, SHOW_FILE_NAME, fileName, NEW_LINE);
-    fprintf(arquivo, SHOW_FILE_DESCRIPTION, description, EMPTY_LINE);
+/* Reduz, com a estratégia config->summation e na ordem de chegada, as somas parciais publicadas em 'shared' pelos processos
+   'children', acumulando cada uma assim que é publicada, e espera o término de todos os filhos. A soma total fica em 'total'.
+   Se o cálculo do pai é cancelado (SIGINT), repassa o SIGINT aos filhos que ainda não publicaram.
+   Retorna TRUE se todos os filhos publicaram o seu resultado ou FALSE se algum terminou sem publicar ou falhou.
+*/
+int collectResults(SharedResults *shared, const pid_t *children, const Config *config, CompensatedSum *total) {
+    unsigned int numberOfProcesses = shared->numberOfProcesses, reduced = 0;
+    int *collected = (int *)calloc(numberOfProcesses, sizeof(int));
+    int *exited = (int *)calloc(numberOfProcesses, sizeof(int));
+    if (collected == NULL || exited == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    Accumulator accumulator;
+    accumulatorInit(&accumulator, config->summation);
+    int success = TRUE, forwarded = FALSE, status;
 
-    double totalTimeOfThreads = 0.0;
-    String formattedString;
-    for (int i = 0; i < NUMBER_OF_THREADS; i++){
-        sprintf(formattedString, SHOW_TID, threads[i].tid, threads[i].time, NEW_LINE);
-        replace(formattedString, DOT, COMMA);
-        fprintf(arquivo, "%s", formattedString);
-        totalTimeOfThreads += threads[i].time;
+    while (success && reduced < numberOfProcesses) {
+        // O pedido de cancelamento vive na memória de cada processo: um SIGINT enviado só ao pai é repassado aos filhos,
+        // que somam os chunks.
+        if (!forwarded && __atomic_load_n(&cancelRequested, __ATOMIC_RELAXED)) {
+            for (unsigned int i = 0; i < numberOfProcesses; i++) {
+                if (!collected[i] && !exited[i]) {
+                    kill(children[i], SIGINT);
+                }
+            }
+            forwarded = TRUE;
+        }
+        unsigned int completed = __atomic_load_n(&shared->completed, __ATOMIC_ACQUIRE);
+        for (unsigned int i = 0; i < numberOfProcesses; i++) {
+            SharedProcess *result = sharedProcess(shared, i);
+            if (!collected[i] && __atomic_load_n(&result->published, __ATOMIC_ACQUIRE)) {
+                accumulatorAdd(&accumulator, result->sum);
+                collected[i] = TRUE;
+                reduced++;
+            }
+        }
+        if (config->checkpoint != NULL) {
+            syncCheckpoint(config->checkpoint);
+        }
+        if (config->stream != NULL) {
+            advanceStream(config->stream, config, FALSE);
+        }
+        unsigned int interval = config->stream != NULL ? STREAM_POLL_INTERVAL_MS : RESULT_POLL_INTERVAL_MS;
+        if (reduced == numberOfProcesses || waitForResults(shared, completed, interval)) {
+            continue;
+        }
+        // Sem novidades no intervalo: um filho que terminou sem publicar nunca acordará o pai.
+        for (unsigned int i = 0; i < numberOfProcesses; i++) {
+            if (!collected[i] && !exited[i] && waitpid(children[i], &status, WNOHANG) == children[i]) {
+                exited[i] = TRUE;
+                if (!__atomic_load_n(&sharedProcess(shared, i)->published, __ATOMIC_ACQUIRE)) {
+                    fprintf(stderr, ERROR_CHILD, PROCESS_ONE + i);
+                    success = FALSE;
+                }
+            }
+        }
+    }
+    for (unsigned int i = 0; i < numberOfProcesses; i++) {
+        if (!exited[i] && (waitpid(children[i], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)) {
+            success = FALSE;
+        }
     }
-    sprintf(formattedString, SHOW_TOTAL_TIME_THREAD, NEW_LINE, totalTimeOfThreads, NEW_LINE);    
-    replace(formattedString, DOT, COMMA);
-    fprintf(arquivo, "%s", formattedString);
-    fclose(arquivo);
+    *total = accumulatorResult(&accumulator);
+    free(exited);
+    free(collected);
+    return success;
+}//collectResults()
 
-    return TRUE;
-}//createFile();
+/* Cria o estado compartilhado do modo de convergência incremental para os chunks de 'config'.
+   Em caso de falha, imprime uma mensagem de erro e encerra o programa.
+*/
+Stream* createStream(const Config *config) {
+    unsigned long long numberOfChunks = countChunks(config);
+    size_t size = sizeof(Stream) + numberOfChunks * sizeof(StreamChunk);
+    Stream *stream = (Stream *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (stream == MAP_FAILED) {
+        perror(ERROR_SHARED_MEMORY);
+        exit(EXIT_FAILURE);
+    }
+    // O mapeamento anônimo começa zerado: nenhum chunk publicado.
+    stream->numberOfChunks = numberOfChunks;
+    stream->size = size;
+    accumulatorInit(&stream->accumulator, config->summation);
+    stream->bound = getSeries(config->series)->errorBound(0);
+    clock_gettime(DURATION_CLOCK, &stream->lastReport);
+    return stream;
+}//createStream()
 
-/* Realiza a soma parcial de n (n é definido por PARTIAL_NUMBER_OF_TERMS) termos da série de Leibniz
-   começando em x, por exemplo, como PARTIAL_NUMBER_OF_TERMS é 125.000.000, então se x é:
+/* Desfaz o mapeamento do estado 'stream'. */
+void destroyStream(Stream *stream) {
+    munmap(stream, stream->size);
+}//destroyStream()
+
+/* Retira de 'stream' o próximo chunk, em ordem crescente, e o armazena em 'chunk'.
+   Retorna FALSE se os chunks acabaram ou se as casas pedidas já estão garantidas, ou TRUE caso contrário.
+*/
+int takeStreamChunk(Stream *stream, unsigned long long *chunk) {
+    if (__atomic_load_n(&stream->stop, __ATOMIC_RELAXED)) {
+        return FALSE;
+    }
+    *chunk = __atomic_fetch_add(&stream->next, 1, __ATOMIC_RELAXED);
+    return *chunk < stream->numberOfChunks;
+}//takeStreamChunk()
+
+/* Publica em 'stream' a soma 'sum' do chunk 'chunk'. */
+void publishStreamChunk(Stream *stream, unsigned long long chunk, CompensatedSum sum) {
+    stream->chunks[chunk].sum = sum;
+    __atomic_store_n(&stream->chunks[chunk].done, TRUE, __ATOMIC_RELEASE);
+}//publishStreamChunk()
+
+/* Retorna os termos cobertos pelo prefixo já reduzido de 'stream'. */
+unsigned long long streamTerms(const Stream *stream, const Config *config) {
+    unsigned long long terms = stream->prefix * config->chunkSize;
+    return terms < config->numberOfTerms ? terms : config->numberOfTerms;
+}//streamTerms()
+
+/* Reduz os chunks publicados que estendem o prefixo contíguo de 'stream', escreve a estimativa parcial com o limitante
+   do erro (no máximo uma a cada STREAM_REPORT_INTERVAL segundos, ou sempre que o prefixo mudou se 'force') e, quando o limitante garante
+   config->digits casas, pede aos workers que parem.
+   Retorna TRUE se as casas pedidas estão garantidas ou FALSE caso contrário.
+*/
+int advanceStream(Stream *stream, const Config *config, int force) {
+    unsigned long long prefix = stream->prefix;
+    while (stream->prefix < stream->numberOfChunks && __atomic_load_n(&stream->chunks[stream->prefix].done, __ATOMIC_ACQUIRE)) {
+        accumulatorAdd(&stream->accumulator, stream->chunks[stream->prefix].sum);
+        stream->prefix++;
+    }
+    if (stream->prefix == prefix && !force) {
+        return __atomic_load_n(&stream->stop, __ATOMIC_RELAXED);
+    }
+    unsigned long long terms = streamTerms(stream, config);
+    stream->bound = getSeries(config->series)->errorBound(terms) + streamRoundingError(config->series, terms);
+    // As casas estão garantidas quando os extremos do intervalo [pi - limitante, pi + limitante] são exibidos iguais.
+    CompensatedSum sum = accumulatorResult(&stream->accumulator);
+    double estimate = getSeries(config->series)->toPi(sum.sum + sum.compensation);
+    String low, high;
+    snprintf(low, STRING_DEFAULT_SIZE, "%.*lf", (int)config->digits, estimate - stream->bound);
+    snprintf(high, STRING_DEFAULT_SIZE, "%.*lf", (int)config->digits, estimate + stream->bound);
+    int reached = strcmp(low, high) == 0;
+    int first = reached && !__atomic_load_n(&stream->stop, __ATOMIC_RELAXED);
+    if (reached) {
+        __atomic_store_n(&stream->stop, TRUE, __ATOMIC_RELAXED);
+    }
 
-             0 -> calcula a soma parcial de 0 até 124.999.999;
-   125.000.000 -> calcula a soma parcial de 125.000.000 até 249.999.999;
-   250.000.000 -> calcula a soma parcial de 250.000.000 até 374.999.999; 
-       
-   e assim por diante. 
+    struct timespec now;
+    clock_gettime(DURATION_CLOCK, &now);
+    if (stream->prefix != stream->reported && (force || first || calculateDuration(stream->lastReport, now) >= STREAM_REPORT_INTERVAL)) {
+        String progress;
+        formatReport(progress, STRING_DEFAULT_SIZE, STREAM_PROGRESS, terms, (int)config->digits, estimate, stream->bound);
+        printf("%s%c", progress, NEW_LINE);
+        fflush(stdout);
+        stream->lastReport = now;
+        stream->reported = stream->prefix;
+    }
+    return reached;
+}//advanceStream()
 
-   O resultado dessa soma parcial deve ser um valor do tipo double a ser retornado 
-   por esta função para o processo que criou a thread.
+/* Retorna a margem do arredondamento após 'terms' termos da série 'series' somados com uma estratégia compensada:
+   STREAM_ROUNDING_ERROR mais o erro das somas sem compensação por que passa cada termo (um bloco de SUMMATION_BLOCK termos
+   dos kernels vetoriais e os níveis da soma par a par) sobre a soma dos |termos|, que cresce com N na série de Leibniz.
 */
-void* sumPartial(void *terms) {    
-    struct timeval startTime, endTime;
-    gettimeofday(&startTime, NULL);
+double streamRoundingError(SeriesType series, unsigned long long terms) {
+    double additions = (double)(terms < SUMMATION_BLOCK ? terms : SUMMATION_BLOCK) + (double)(terms < PAIRWISE_LEVELS ? terms : PAIRWISE_LEVELS);
+    return STREAM_ROUNDING_ERROR + additions * DBL_EPSILON * getSeries(series)->absoluteSum(terms);
+}//streamRoundingError()
 
-    ThreadResult* threadResult = (ThreadResult*)malloc(sizeof(ThreadResult));
-    threadResult->sumPartional = 0.0;
-    unsigned int *current = (unsigned int *)terms;
-    for (unsigned int i = *current; i < *current + PARTIAL_NUMBER_OF_TERMS; i++) {
-        double term = 1.0 / (2.0 * i + 1);
-        if (i % 2 == 0) {
-            threadResult->sumPartional += term;
-        } 
+/* Retorna o menor número de termos da série 'series' cujo limitante do erro, com a margem de streamRoundingError(),
+   fica abaixo de meia unidade da casa decimal 'digits', ou 0 se a margem o impede.
+*/
+unsigned long long termsForBound(SeriesType series, unsigned int digits) {
+    double tolerance = 0.5 * pow(10.0, -(double)digits);
+    double (*errorBound)(unsigned long long) = getSeries(series)->errorBound;
+    // Busca binária sobre o limitante com a margem, que decresce com o número de termos até muito além do alcance do double;
+    // a busca desiste quando a margem sozinha já passa da tolerância.
+    unsigned long long low = 1, high = 1;
+    while (errorBound(high) + streamRoundingError(series, high) > tolerance) {
+        if (streamRoundingError(series, high) >= tolerance || high > ULLONG_MAX / 4) {
+            return 0;
+        }
+        low = high + 1;
+        high *= 2;
+    }
+    while (low < high) {
+        unsigned long long middle = low + (high - low) / 2;
+        if (errorBound(middle) + streamRoundingError(series, middle) > tolerance) {
+            low = middle + 1;
+        }
         else {
-            threadResult->sumPartional -= term;
+            high = middle;
         }
     }
-    
-    gettimeofday(&endTime, NULL);
-    threadResult->thread.tid = syscall(SYS_gettid); 
-    threadResult->thread.time = calculateDuration(startTime, endTime);
-    
-    // Liberando a região de memoria do argumento.
-    free(terms);
-   
-    pthread_exit(threadResult);
-}//sumPartial()
+    return high;
+}//termsForBound()
+
+/* Retorna o número de CPUs online, que é o número padrão de threads de cada processo filho. */
+unsigned int detectNumberOfThreads() {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online < 1) {
+        return 1;
+    }
+    return online > MAXIMUM_NUMBER_OF_THREADS ? MAXIMUM_NUMBER_OF_THREADS : (unsigned int)online;
+}//detectNumberOfThreads()
 
-/* Cria uma thread para fazer a soma parcial de n termos da série de Leibniz. 
-   Esta função deve usar a função sumPartial para definir qual a função a ser executada por cada uma das x threads 
-   do programa, onde x é igual a NUMBER_OF_THREADS. 
-   Retorna a identificação da thread.
+/* Converte 'text' em um inteiro positivo menor ou igual a 'maximum'.
+   Retorna TRUE se a conversão foi bem sucedida ou FALSE caso contrário.
 */
-pthread_t createThread(unsigned int *terms) {
-    pthread_t threadID; 
-    unsigned int* sequenceNumber = (unsigned int *) malloc (sizeof(unsigned int));
-    if (sequenceNumber == NULL) {
-        perror(ERROR_MALLOC);
-        exit(EXIT_FAILURE); 
+static int parsePositive(const char *text, unsigned long long maximum, unsigned long long *value) {
+    if (text == NULL || *text == NULL_CHAR || *text == '-') {
+        return FALSE;
     }
-    *sequenceNumber = (*terms) * PARTIAL_NUMBER_OF_TERMS;
-    pthread_create(&threadID, NULL, sumPartial, sequenceNumber);
-    return threadID;
-}//createThread()
+    char *end;
+    errno = 0;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (errno != 0 || *end != NULL_CHAR || parsed == 0 || parsed > maximum) {
+        return FALSE;
+    }
+    *value = parsed;
+    return TRUE;
+}//parsePositive()
 
-/* A função 'fillThreadTidAndTime' é responsável por preencher uma estrutura de thread 'Thread' com o ID da thread (TID) e o tempo de execução,
-   obtidos a partir da estrutura 'ThreadResult'.
+/* Procura 'text' entre os 'count' nomes de 'names'.
+   Retorna o índice do nome encontrado ou -1 se 'text' não é nenhum deles.
+*/
+static int parseName(const char *text, const char *const names[], int count) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(text, names[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}//parseName()
 
-   Parâmetros:
-   - threadResult: A estrutura 'ThreadResult' que contém o TID e o tempo de execução.
-   - thread: Ponteiro para a estrutura 'Thread' a ser preenchida.
+/* Preenche 'config' a partir das variáveis de ambiente (PI_THREADS, PI_TERMS, ...) e da linha de comando,
+   que tem precedência sobre as variáveis de ambiente. Sem número de termos explícito, usa os termos necessários
+   para config->digits casas decimais na série escolhida (2.000.000.000 na série de Leibniz com 9 casas).
+   Retorna TRUE se a configuração é válida ou FALSE caso contrário.
 */
-void fillThreadTidAndTime(ThreadResult threadResult, Thread* thread){
-    thread->tid = threadResult.thread.tid;
-    thread->time = threadResult.thread.time;
-}//fillThreadTidAndTime()
+int parseConfig(int argc, char *argv[], Config *config) {
+    static const struct option options[] = {
+        {OPTION_PROCESSES, required_argument, NULL, 'p'},
+        {OPTION_THREADS, required_argument, NULL, 't'},
+        {OPTION_TERMS, required_argument, NULL, 'n'},
+        {OPTION_KERNEL, required_argument, NULL, 'k'},
+        {OPTION_CHUNK, required_argument, NULL, 'c'},
+        {OPTION_SUMMATION, required_argument, NULL, 's'},
+        {OPTION_ACCELERATION, required_argument, NULL, 'a'},
+        {OPTION_SERIES, required_argument, NULL, 'A'},
+        {OPTION_DIGITS, required_argument, NULL, 'd'},
+        {OPTION_PRECISION, required_argument, NULL, 'P'},
+        {OPTION_OUTPUT, required_argument, NULL, 'o'},
+        {OPTION_AFFINITY, required_argument, NULL, 'C'},
+        {OPTION_BENCHMARK_SUMMATION, no_argument, NULL, OPTION_BENCHMARK_SUMMATION_CODE},
+        {OPTION_BENCHMARK_LAYOUT, no_argument, NULL, OPTION_BENCHMARK_LAYOUT_CODE},
+        {OPTION_BENCHMARK, no_argument, NULL, OPTION_BENCHMARK_CODE},
+        {OPTION_REPETITIONS, required_argument, NULL, OPTION_REPETITIONS_CODE},
+        {OPTION_WARMUP, required_argument, NULL, OPTION_WARMUP_CODE},
+        {OPTION_COORDINATOR, required_argument, NULL, OPTION_COORDINATOR_CODE},
+        {OPTION_WORKER, required_argument, NULL, OPTION_WORKER_CODE},
+        {OPTION_CHECKPOINT, required_argument, NULL, OPTION_CHECKPOINT_CODE},
+        {OPTION_RESUME, no_argument, NULL, OPTION_RESUME_CODE},
+        {OPTION_STREAM, no_argument, NULL, OPTION_STREAM_CODE},
+        {OPTION_CACHE, required_argument, NULL, OPTION_CACHE_CODE},
+        {OPTION_PERF, no_argument, NULL, OPTION_PERF_CODE},
+        {OPTION_METRICS, required_argument, NULL, OPTION_METRICS_CODE},
+        {OPTION_REPORT, required_argument, NULL, OPTION_REPORT_CODE},
+        {OPTION_REPORT_FORMAT, required_argument, NULL, OPTION_REPORT_FORMAT_CODE},
+        {OPTION_DEADLINE, required_argument, NULL, OPTION_DEADLINE_CODE},
+        {OPTION_PROGRESS, no_argument, NULL, OPTION_PROGRESS_CODE},
+        {OPTION_DAEMON, required_argument, NULL, OPTION_DAEMON_CODE},
+        {OPTION_HELP, no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    const char *processesText = getenv(ENV_PROCESSES);
+    const char *threadsText = getenv(ENV_THREADS);
+    const char *termsText = getenv(ENV_TERMS);
+    const char *kernelText = getenv(ENV_KERNEL);
+    const char *chunkText = getenv(ENV_CHUNK);
+    const char *summationText = getenv(ENV_SUMMATION);
+    const char *accelerationText = getenv(ENV_ACCELERATION);
+    const char *seriesText = getenv(ENV_SERIES);
+    const char *digitsText = getenv(ENV_DIGITS);
+    const char *precisionText = getenv(ENV_PRECISION);
+    const char *affinityText = getenv(ENV_AFFINITY);
+    config->benchmarkSummation = FALSE;
+    config->benchmarkLayout = FALSE;
+    config->benchmark = FALSE;
+    const char *repetitionsText = NULL;
+    const char *warmupText = NULL;
+    config->outputFile = DEFAULT_OUTPUT_FILE;
+    config->coordinatorAddress = NULL;
+    config->checkpointFile = getenv(ENV_CHECKPOINT);
+    config->resume = FALSE;
+    config->checkpoint = NULL;
+    config->cacheDirectory = getenv(ENV_CACHE);
+    config->cache = NULL;
+    config->hardwareCounters = FALSE;
+    config->metricsFile = getenv(ENV_METRICS);
+    config->reportFile = getenv(ENV_REPORT);
+    config->reportFormat = REPORT_JSON;
+    const char *reportFormatText = getenv(ENV_REPORT_FORMAT);
+    config->streaming = FALSE;
+    config->stream = NULL;
+    const char *deadlineText = getenv(ENV_DEADLINE);
+    config->deadlineAt = 0.0;
+    config->progress = NULL;
+    config->progressContext = NULL;
+    config->cancel = NULL;
+    config->chunkSums = NULL;
+    config->daemonSocket = NULL;
+    const char *portText = NULL;
+    int option;
 
+    while ((option = getopt_long(argc, argv, SHORT_OPTIONS, options, NULL)) != -1) {
+        switch (option) {
+            case 'p':
+                processesText = optarg;
+                break;
+            case 't':
+                threadsText = optarg;
+                break;
+            case 'n':
+                termsText = optarg;
+                break;
+            case 'k':
+                kernelText = optarg;
+                break;
+            case 'c':
+                chunkText = optarg;
+                break;
+            case 's':
+                summationText = optarg;
+                break;
+            case 'a':
+                accelerationText = optarg;
+                break;
+            case 'A':
+                seriesText = optarg;
+                break;
+            case 'd':
+                digitsText = optarg;
+                break;
+            case 'P':
+                precisionText = optarg;
+                break;
+            case 'o':
+                config->outputFile = optarg;
+                break;
+            case 'C':
+                affinityText = optarg;
+                break;
+            case OPTION_BENCHMARK_SUMMATION_CODE:
+                config->benchmarkSummation = TRUE;
+                break;
+            case OPTION_BENCHMARK_LAYOUT_CODE:
+                config->benchmarkLayout = TRUE;
+                break;
+            case OPTION_BENCHMARK_CODE:
+                config->benchmark = TRUE;
+                break;
+            case OPTION_REPETITIONS_CODE:
+                repetitionsText = optarg;
+                break;
+            case OPTION_WARMUP_CODE:
+                warmupText = optarg;
+                break;
+            case OPTION_COORDINATOR_CODE:
+                portText = optarg;
+                break;
+            case OPTION_WORKER_CODE:
+                config->coordinatorAddress = optarg;
+                break;
+            case OPTION_CHECKPOINT_CODE:
+                config->checkpointFile = optarg;
+                break;
+            case OPTION_RESUME_CODE:
+                config->resume = TRUE;
+                break;
+            case OPTION_STREAM_CODE:
+                config->streaming = TRUE;
+                break;
+            case OPTION_CACHE_CODE:
+                config->cacheDirectory = optarg;
+                break;
+            case OPTION_PERF_CODE:
+                config->hardwareCounters = TRUE;
+                break;
+            case OPTION_METRICS_CODE:
+                config->metricsFile = optarg;
+                break;
+            case OPTION_REPORT_CODE:
+                config->reportFile = optarg;
+                break;
+            case OPTION_REPORT_FORMAT_CODE:
+                reportFormatText = optarg;
+                break;
+            case OPTION_DEADLINE_CODE:
+                deadlineText = optarg;
+                break;
+            case OPTION_PROGRESS_CODE:
+                config->progress = printProgress;
+                break;
+            case OPTION_DAEMON_CODE:
+                config->daemonSocket = optarg;
+                break;
+            default:
+                return FALSE;
+        }
+    }
+    if (optind < argc) {
+        return FALSE;
+    }
 
-/* Calcula o número pi com n (n é definido por DECIMAL_PLACES) casas decimais usando o número máximo de
-   termos da série de Leibniz, que é definido por MAXIMUM_NUMBER_OF_TERMS. Esta função deve criar x threads
-   usando a função createThread, onde x é igual a NUMBER_OF_THREADS. 
-*/
-double calculationOfNumberPi(unsigned int terms){
-    Threads threads;
-    void *result;
-    ThreadResult threadResult;
-    double pi = 0.0;
-
-    for (unsigned int sequenceNumber = 0; sequenceNumber < NUMBER_OF_THREADS; sequenceNumber++) {
-        threads[sequenceNumber].threadID = createThread(&sequenceNumber);
-    }
-    for (unsigned int i = 0; i < NUMBER_OF_THREADS; i++) {
-        pthread_join(threads[i].threadID, &result);
-        threadResult = *(ThreadResult*)result;
-        pi += threadResult.sumPartional;
-        fillThreadTidAndTime(threadResult, &threads[i]);
-        free(result);
-    }
-    
-    FileName fileName;
-    snprintf(fileName, STRING_DEFAULT_SIZE, FILE_NAME_PROCESS, terms);
-    String description;
-    snprintf(description, STRING_DEFAULT_SIZE, FILE_DESCRIPTION, terms); 
-    createFile(fileName, description, threads);
-    return pi * 4.0;
-}//calculationOfNumberPi();
+    unsigned long long value;
+    config->numberOfThreads = detectNumberOfThreads();
+    if (threadsText != NULL) {
+        if (!parsePositive(threadsText, MAXIMUM_NUMBER_OF_THREADS, &value)) {
+            fprintf(stderr, ERROR_INVALID_THREADS, threadsText);
+            return FALSE;
+        }
+        config->numberOfThreads = (unsigned int)value;
+    }
+    config->numberOfProcesses = NUMBER_OF_PROCESS;
+    if (processesText != NULL) {
+        if (!parsePositive(processesText, MAXIMUM_NUMBER_OF_PROCESSES, &value)) {
+            fprintf(stderr, ERROR_INVALID_PROCESSES, processesText);
+            return FALSE;
+        }
+        config->numberOfProcesses = (unsigned int)value;
+    }
+    config->deadline = 0.0;
+    if (deadlineText != NULL) {
+        char *end;
+        errno = 0;
+        config->deadline = strtod(deadlineText, &end);
+        if (errno != 0 || end == deadlineText || *end != NULL_CHAR || !(config->deadline > 0.0)) {
+            fprintf(stderr, ERROR_INVALID_DEADLINE, deadlineText);
+            return FALSE;
+        }
+    }
+    config->repetitions = BENCHMARK_REPETITIONS;
+    if (repetitionsText != NULL) {
+        if (!parsePositive(repetitionsText, MAXIMUM_BENCHMARK_REPETITIONS, &value)) {
+            fprintf(stderr, ERROR_INVALID_REPETITIONS, repetitionsText);
+            return FALSE;
+        }
+        config->repetitions = (unsigned int)value;
+    }
+    // O aquecimento pode ser desligado com 0.
+    config->warmup = BENCHMARK_WARMUP;
+    if (warmupText != NULL) {
+        if (strcmp(warmupText, "0") != 0 && !parsePositive(warmupText, MAXIMUM_BENCHMARK_REPETITIONS, &value)) {
+            fprintf(stderr, ERROR_INVALID_REPETITIONS, warmupText);
+            return FALSE;
+        }
+        config->warmup = strcmp(warmupText, "0") == 0 ? 0 : (unsigned int)value;
+    }
+    config->digits = DECIMAL_PLACES;
+    if (digitsText != NULL) {
+        if (!parsePositive(digitsText, MAXIMUM_DOUBLE_DIGITS, &value)) {
+            fprintf(stderr, ERROR_INVALID_DIGITS, digitsText);
+            return FALSE;
+        }
+        config->digits = (unsigned int)value;
+    }
+    config->precision = 0;
+    if (precisionText != NULL) {
+        if (!parsePositive(precisionText, MAXIMUM_PRECISION, &value)) {
+            fprintf(stderr, ERROR_INVALID_PRECISION, precisionText);
+            return FALSE;
+        }
+        config->precision = value;
+    }
+    config->coordinatorPort = 0;
+    if (portText != NULL) {
+        if (!parsePositive(portText, CLUSTER_MAXIMUM_PORT, &value)) {
+            fprintf(stderr, ERROR_INVALID_PORT, portText);
+            return FALSE;
+        }
+        config->coordinatorPort = (unsigned int)value;
+    }
+    config->affinity = AFFINITY_COMPACT;
+    config->affinityList = NULL;
+    config->affinityListSize = 0;
+    if (affinityText != NULL) {
+        static const char *const affinityNames[NUMBER_OF_AFFINITIES] = AFFINITY_NAMES;
+        int affinity = parseName(affinityText, affinityNames, NUMBER_OF_AFFINITIES);
+        if (isdigit((unsigned char)affinityText[0])) {
+            config->affinityList = (int *)malloc(CPU_SETSIZE * sizeof(int));
+            if (config->affinityList == NULL) {
+                perror(ERROR_MALLOC);
+                exit(EXIT_FAILURE);
+            }
+            config->affinityListSize = parseCpuList(affinityText, config->affinityList, CPU_SETSIZE);
+            affinity = config->affinityListSize > 0 ? AFFINITY_LIST : -1;
+        }
+        if (affinity < 0 || (affinity == AFFINITY_LIST && config->affinityListSize == 0)) {
+            fprintf(stderr, ERROR_INVALID_AFFINITY, affinityText);
+            return FALSE;
+        }
+        config->affinity = (AffinityPolicy)affinity;
+    }
+    config->series = SERIES_LEIBNIZ;
+    if (seriesText != NULL) {
+        static const char *const seriesNames[NUMBER_OF_SERIES] = SERIES_NAMES;
+        int series = parseName(seriesText, seriesNames, NUMBER_OF_SERIES);
+        if (series < 0) {
+            fprintf(stderr, ERROR_INVALID_SERIES, seriesText);
+            return FALSE;
+        }
+        config->series = series == SERIES_AUTO ? cheapestSeries(config->digits) : (SeriesType)series;
+    }
+    // No modo incremental, o limite padrão de termos deixa o limitante do erro abaixo de meia unidade da casa seguinte
+    // às pedidas, o que basta para garantir o arredondamento exceto quando pi está muito perto da fronteira; se a margem
+    // de arredondamento o impede, vale o limite da própria casa pedida. Sem nenhum dos dois, as casas nunca seriam
+    // garantidas e o cálculo só gastaria os termos de termsForDigits: a configuração é recusada, exceto com -n.
+    config->numberOfTerms = 0;
+    if (config->streaming) {
+        config->numberOfTerms = termsForBound(config->series, config->digits + 1);
+        if (config->numberOfTerms == 0) {
+            config->numberOfTerms = termsForBound(config->series, config->digits);
+        }
+        if (config->numberOfTerms == 0 && termsText == NULL) {
+            fprintf(stderr, ERROR_STREAM_DIGITS, config->digits, seriesName(config->series));
+            return FALSE;
+        }
+    }
+    if (config->numberOfTerms == 0) {
+        config->numberOfTerms = getSeries(config->series)->termsForDigits(config->digits);
+    }
+    if (termsText != NULL) {
+        if (!parsePositive(termsText, ULLONG_MAX / 2, &value)) {
+            fprintf(stderr, ERROR_INVALID_TERMS, termsText);
+            return FALSE;
+        }
+        config->numberOfTerms = value;
+    }
+    config->chunkSize = DEFAULT_CHUNK_SIZE;
+    if (chunkText != NULL) {
+        if (!parsePositive(chunkText, ULLONG_MAX / 2, &value)) {
+            fprintf(stderr, ERROR_INVALID_CHUNK, chunkText);
+            return FALSE;
+        }
+        config->chunkSize = value;
+    }
+    config->kernel = KERNEL_AUTO;
+    if (kernelText != NULL) {
+        static const char *const kernelNames[NUMBER_OF_KERNELS] = KERNEL_NAMES;
+        int kernel = parseName(kernelText, kernelNames, NUMBER_OF_KERNELS);
+        if (kernel < 0) {
+            fprintf(stderr, ERROR_INVALID_KERNEL, kernelText);
+            return FALSE;
+        }
+        config->kernel = (KernelType)kernel;
+    }
+    // A soma ingênua não tem um limitante útil do erro: o modo incremental usa Kahan-Neumaier por padrão.
+    config->summation = config->streaming ? SUMMATION_NEUMAIER : SUMMATION_NAIVE;
+    if (summationText != NULL) {
+        static const char *const summationNames[NUMBER_OF_SUMMATIONS] = SUMMATION_NAMES;
+        int summation = parseName(summationText, summationNames, NUMBER_OF_SUMMATIONS);
+        if (summation < 0) {
+            fprintf(stderr, ERROR_INVALID_SUMMATION, summationText);
+            return FALSE;
+        }
+        config->summation = (SummationMode)summation;
+    }
+    if (reportFormatText != NULL) {
+        static const char *const reportFormatNames[NUMBER_OF_REPORT_FORMATS] = REPORT_FORMAT_NAMES;
+        int format = parseName(reportFormatText, reportFormatNames, NUMBER_OF_REPORT_FORMATS);
+        if (format < 0) {
+            fprintf(stderr, ERROR_INVALID_REPORT_FORMAT, reportFormatText);
+            return FALSE;
+        }
+        config->reportFormat = (ReportFormat)format;
+    }
+    config->acceleration = ACCELERATION_NONE;
+    if (accelerationText != NULL) {
+        static const char *const accelerationNames[NUMBER_OF_ACCELERATIONS] = ACCELERATION_NAMES;
+        int acceleration = parseName(accelerationText, accelerationNames, NUMBER_OF_ACCELERATIONS);
+        if (acceleration < 0) {
+            fprintf(stderr, ERROR_INVALID_ACCELERATION, accelerationText);
+            return FALSE;
+        }
+        config->acceleration = (AccelerationMode)acceleration;
+    }
+    if (config->streaming && config->summation == SUMMATION_NAIVE) {
+        fprintf(stderr, ERROR_STREAM_SUMMATION);
+        return FALSE;
+    }
+    if (config->streaming && config->acceleration != ACCELERATION_NONE) {
+        fprintf(stderr, ERROR_STREAM_ACCELERATION);
+        return FALSE;
+    }
+    if (config->acceleration != ACCELERATION_NONE && config->series != SERIES_LEIBNIZ) {
+        fprintf(stderr, ERROR_ACCELERATION_SERIES);
+        return FALSE;
+    }
+    if (selectKernel(&config->kernel) == NULL) {
+        fprintf(stderr, ERROR_UNSUPPORTED_KERNEL, kernelName(config->kernel));
+        return FALSE;
+    }
+    // Os kernels vetoriais só existem para a série de Leibniz.
+    if (config->series != SERIES_LEIBNIZ) {
+        config->kernel = KERNEL_SCALAR;
+    }
+    // Não há sentido em criar mais threads do que termos.
+    if (config->numberOfThreads > config->numberOfTerms) {
+        config->numberOfThreads = (unsigned int)config->numberOfTerms;
+    }
+    // Nem mais processos do que chunks: cada processo recebe ao menos um chunk inteiro.
+    if (config->numberOfProcesses > countChunks(config)) {
+        config->numberOfProcesses = (unsigned int)countChunks(config);
+    }
+    return TRUE;
+}//parseConfig()
 
 /* A função 'fillProcessReportSun' é responsável por preencher uma estrutura 'ProcessReport' com informações específicas
-   sobre a execução de um processo filho, incluindo seu número, tempo de início, tempo de término, duração e valor de π calculado.
+   sobre a execução de um processo filho, incluindo seu número, tempo de início, tempo de término, duração, termos e soma parcial.
 
    Parâmetros:
    - processReport: Ponteiro para a estrutura 'ProcessReport' a ser preenchida.
-   - numberProcess: Número do processo (PROCESS_ONE ou PROCESS_TWO).
-   - startTimeStr: String formatada representando o tempo de início.
-   - endTimeStr: String formatada representando o tempo de término.
-   - duration: Tempo de execução em segundos.
-   - pi: Valor de π.
-*/
-void fillProcessReportSun(ProcessReport* processReport, int numberProcess, char* startTimeStr, char* endTimeStr, double duration, double pi){
-    snprintf(processReport->identification, STRING_DEFAULT_SIZE, PROCESS_REPORT_IDENTIFICATION, numberProcess, getpid());
-    sprintf(processReport->numberOfThreads, PROCESS_REPORT_NUMBER_OF_THREADS, NUMBER_OF_THREADS);
+   - numberProcess: Número do processo (PROCESS_ONE, PROCESS_ONE + 1, ...).
+   - result: Resultado numérico publicado pelo processo no segmento compartilhado.
+*/
+void fillProcessReportSun(ProcessReport* processReport, int numberProcess, const SharedProcess *result){
+    char startTimeStr[9];
+    char endTimeStr[9];
+    struct tm startTm, endTm;
+    time_t startTimeSeconds = result->start.tv_sec;
+    time_t endTimeSeconds = result->end.tv_sec;
+    gmtime_r(&startTimeSeconds, &startTm);
+    gmtime_r(&endTimeSeconds, &endTm);
+
+    strftime(startTimeStr, sizeof(startTimeStr), TIME_FORMAT, &startTm);
+    strftime(endTimeStr, sizeof(endTimeStr), TIME_FORMAT, &endTm);
+
+    TermRange terms = result->terms;
+    snprintf(processReport->identification, STRING_DEFAULT_SIZE, PROCESS_REPORT_IDENTIFICATION, numberProcess, result->pid);
+    snprintf(processReport->numberOfThreads, STRING_DEFAULT_SIZE, PROCESS_REPORT_NUMBER_OF_THREADS, result->numberOfThreads);
     snprintf(processReport->start, STRING_DEFAULT_SIZE, PROCESS_REPORT_START, startTimeStr);
     snprintf(processReport->end, STRING_DEFAULT_SIZE, PROCESS_REPORT_END, endTimeStr);
-    snprintf(processReport->duration, STRING_DEFAULT_SIZE, PROCESS_REPORT_DURATION, duration);
-    snprintf(processReport->pi, STRING_DEFAULT_SIZE, PROCESS_REPORT_PI, pi);
+    formatReport(processReport->duration, STRING_DEFAULT_SIZE, PROCESS_REPORT_DURATION, result->duration);
+    snprintf(processReport->terms, STRING_DEFAULT_SIZE, PROCESS_REPORT_SLICE, terms.start,
+             terms.count > 0 ? terms.start + terms.count - 1 : terms.start, terms.count);
+    formatReport(processReport->partialSum, STRING_DEFAULT_SIZE, PROCESS_REPORT_PARTIAL_SUM, result->sum.sum + result->sum.compensation);
 }//fillProcessReportSun()
 
-/* A função 'calculateDuration' calcula a diferença de tempo entre duas estruturas 'struct timeval' e retorna a duração em segundos, incluindo a parte decimal representando milissegundos.
+/* Preenche o resultado combinado de 'report' com a duração total 'duration' medida pelo pai e as estimativas 'result'
+   com config->digits casas decimais.
+*/
+void fillReportTotal(Report* report, double duration, PiResult result, const Config *config){
+    formatReport(report->duration, STRING_DEFAULT_SIZE, PROCESS_REPORT_DURATION, duration);
+    formatReport(report->pi, STRING_DEFAULT_SIZE, PROCESS_REPORT_PI, (int)config->digits, result.pi);
+    snprintf(report->terms, STRING_DEFAULT_SIZE, PROCESS_REPORT_TERMS, result.terms);
+    report->rawPi[0] = NULL_CHAR;
+    report->bound[0] = NULL_CHAR;
+    report->cancelled[0] = NULL_CHAR;
+    if (config->acceleration != ACCELERATION_NONE) {
+        formatReport(report->rawPi, STRING_DEFAULT_SIZE, PROCESS_REPORT_RAW_PI, (int)config->digits, result.rawPi);
+    }
+}//fillReportTotal()
+
+/* A função 'calculateDuration' calcula a diferença de tempo entre duas estruturas 'struct timespec' lidas do mesmo relógio (DURATION_CLOCK
+   ou o de CPU da thread) e retorna a duração em segundos, incluindo a parte decimal com resolução de nanossegundos.
 
    Parâmetros:
-   - startTime: Estrutura 'struct timeval' representando o tempo de início.
-   - endTime: Estrutura 'struct timeval' representando o tempo de término.
+   - startTime: Estrutura 'struct timespec' representando o tempo de início.
+   - endTime: Estrutura 'struct timespec' representando o tempo de término.
 */
-double calculateDuration(struct timeval startTime, struct timeval endTime){
+double calculateDuration(struct timespec startTime, struct timespec endTime){
     double seconds = (double)(endTime.tv_sec - startTime.tv_sec);
-    double milliseconds = (double)(endTime.tv_usec - startTime.tv_usec) / 1000.0;
-    return  seconds + (milliseconds / 1000.0);
+    double nanoseconds = (double)(endTime.tv_nsec - startTime.tv_nsec);
+    return seconds + nanoseconds / 1e9;
 }//calculateDuration()
 
 /* A função 'processChild' é responsável por realizar tarefas específicas em um processo filho, identificado pelo parâmetro 'numberProcess'.
-   Ela realiza o cálculo do valor de π e preenche um relatório de processo.
+   Ela soma a sua fatia de chunks da série e publica o resultado numérico no segmento compartilhado.
 
    Parâmetros:
-   - numberProcess: Um valor que identifica o processo (PROCESS_ONE ou PROCESS_TWO).
-   - pipe_fd: Um array de inteiros que representa o pipe para comunicação.
-   - report: Ponteiro para a estrutura 'Report' que armazena informações do processo.
-
-   A função calcula o valor de π usando 'calculationOfNumberPi' e mede o tempo de execução.
-   Em seguida, preenche um relatório de processo 'ProcessReport' com os resultados e as informações de tempo.
+   - numberProcess: Um valor que identifica o processo (PROCESS_ONE, PROCESS_ONE + 1, ...).
+   - shared: Segmento de memória compartilhada dos resultados, herdado do pai.
+   - config: Configuração de execução (número de processos, de termos e de threads).
 
+   A fatia do processo são os chunks partitionTerms(countChunks(config), config->numberOfProcesses, numberProcess - PROCESS_ONE).
+   A função soma a fatia usando 'calculationOfNumberPi', que grava as threads diretamente no segmento, e mede o tempo de execução.
+   Em seguida, publica o resultado com 'publishResult' e encerra o processo.
 */
-void processChild(int numberProcess, int pipe_fd[2], Report* report) {
-    ProcessReport processReport;
-    struct timeval startTime, endTime;
-    gettimeofday(&startTime, NULL);
-
-    double pi = calculationOfNumberPi(numberProcess);
-
-    gettimeofday(&endTime, NULL);
-
-    double duration = calculateDuration(startTime, endTime);
+void processChild(int numberProcess, SharedResults *shared, const Config *config) {
+    signal(SIGINT, handleChildInterrupt);
+    unsigned int index = numberProcess - PROCESS_ONE;
+    SharedProcess *result = sharedProcess(shared, index);
+    int *placement = createPlacement(config, config->numberOfProcesses, index);
+    if (placement == NULL && config->affinity != AFFINITY_NONE) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    bindProcess(config, placement, config->numberOfThreads);
+    ThreadPool *pool = createThreadPool(config->numberOfThreads, placement);
+    if (pool == NULL) {
+        perror(ERROR_THREAD_POOL);
+        exit(EXIT_FAILURE);
+    }
 
-    char startTimeStr[9];
-    char endTimeStr[9];
-    struct tm startTm, endTm;
-    time_t startTimeSeconds = startTime.tv_sec;
-    time_t endTimeSeconds = endTime.tv_sec;
-    gmtime_r(&startTimeSeconds, &startTm);
-    gmtime_r(&endTimeSeconds, &endTm);
+    // As fatias seguem os limites dos chunks, de modo que cada chunk é somado inteiro por um único processo.
+    TermRange chunks;
+    partitionTerms(countChunks(config), config->numberOfProcesses, index, &chunks);
+    result->terms.start = chunks.start * config->chunkSize;
+    result->terms.count = chunks.count == 0 ? 0 : (chunks.start + chunks.count) * config->chunkSize - result->terms.start;
+    if (result->terms.start + result->terms.count > config->numberOfTerms) {
+        result->terms.count = config->numberOfTerms - result->terms.start;
+    }
 
-    strftime(startTimeStr,STRING_DEFAULT_SIZE, TIME_FORMAT, &startTm);
-    strftime(endTimeStr, STRING_DEFAULT_SIZE, TIME_FORMAT, &endTm);
-
-    fillProcessReportSun(&processReport, numberProcess, startTimeStr, endTimeStr, duration, pi);
-
-    if (numberProcess == PROCESS_ONE) {
-        // Processo filho 1 (pi1)
-        close(pipe_fd[PIPE_READ]); 
-        write(pipe_fd[PIPE_WRITER], &processReport, sizeof(ProcessReport));
-        close(pipe_fd[PIPE_WRITER]);
-        exit(EXIT_SUCCESS);
-
-    } 
-    else if (numberProcess == PROCESS_TWO) {
-        // Processo filho 2 (pi2)
-        close(pipe_fd[PIPE_WRITER]); 
-        read(pipe_fd[PIPE_READ], &report->processReport1, sizeof(ProcessReport));
-        close(pipe_fd[PIPE_READ]);
-        report->processReport2 = processReport;
-        replaceDotForComma(report);
-        createReport(report);
-        exit(EXIT_SUCCESS);
+    // O relógio de parede só marca o início e o fim exibidos; a duração vem do relógio monotônico.
+    struct timespec startTime, endTime;
+    gettimeofday(&result->start, NULL);
+    clock_gettime(DURATION_CLOCK, &startTime);
+    // O callback de progresso identifica o processo pelo seu número.
+    Config childConfig = *config;
+    if (childConfig.progress != NULL) {
+        childConfig.progressContext = &numberProcess;
     }
+    Progress progress;
+    result->sum = calculationOfNumberPi(&childConfig, pool, chunks, sharedThreads(shared, index), &progress);
+    result->completedTerms = progress.terms;
+    result->prefix = progress.prefix;
+    result->prefixTerms = progress.prefixTerms;
+    result->cancelled = progress.cancelled;
+    clock_gettime(DURATION_CLOCK, &endTime);
+    gettimeofday(&result->end, NULL);
+    result->duration = calculateDuration(startTime, endTime);
+
+    destroyThreadPool(pool);
+    free(placement);
+    result->pid = getpid();
+    result->numberOfThreads = config->numberOfThreads;
+    publishResult(shared, index);
+    exit(EXIT_SUCCESS);
 }//processChild()
 
 /* A função 'createProcess' é responsável por criar um novo processo filho utilizando a função 'fork'.
@@ -277,118 +2580,244 @@ pid_t createProcess() {
 	return pid;
 }//createProcess()
 
-/* A função 'createPipe' é responsável por criar um pipe (tubo de comunicação) utilizando a função 'pipe'.
-   O pipe permite a comunicação entre processos, fornecendo um meio de transferência de dados entre eles.
-
-   Parâmetros:
-   - pipe_fd: Array de inteiros de tamanho 2 para armazenar os descritores de arquivo do pipe.
-
-   A função utiliza a função 'pipe' para criar o pipe e atribui os descritores de arquivo resultantes ao array 'pipe_fd'.
-   Em caso de falha na criação do pipe, a função imprime uma mensagem de erro e encerra o programa com falha.
-*/
-int createPipe(int pipe_fd[2]) {
-    if (pipe(pipe_fd) == -1) {
-        perror(ERROR_PIPE);
-        exit(EXIT_FAILURE);
-    }
-    return TRUE;
-}//createPipe()
-
-/* A função 'replaceDotForComma' substitui todas as ocorrências do caractere ponto '.' pelo caractere vírgula ',' 
-   em várias partes da estrutura 'Report' que contém informações sobre processos.
-
-   Parâmetros:
-   - report: Um ponteiro para a estrutura 'Report' que contém informações a serem processadas.
-
-   A função utiliza a função 'replace' para realizar a substituição do ponto '.' pelo caractere vírgula ',' 
-   nas strings de duração e PI em duas 'ProcessReport' dentro da estrutura 'Report'.
-*/
-void replaceDotForComma(Report* report){
-    replace(report->processReport1.duration, DOT, COMMA);
-    replace(report->processReport1.pi, DOT, COMMA);
-    replace(report->processReport2.duration, DOT, COMMA);
-    replace(report->processReport2.pi, DOT, COMMA);
-}
-
-
-/* A função 'replace' substitui todas as ocorrências do caractere 'replaced' pelo caractere 'replacer' em uma string.
-
-   Parâmetros:
-   - string: A string na qual as substituições serão feitas.
-   - replaced: O caractere que será substituído por 'replacer'.
-   - replacer: O caractere que substituirá 'replaced'.
-
-   A função itera através da string e, para cada caractere igual a 'replaced', substitui-o por 'replacer'.
-*/
-void replace(String string, char replaced, char replacer){
-    for(unsigned i = 0; string[i] != NULL_CHAR; i++){
-        if(string[i] == replaced){
-            string[i] = replacer;
-        }
-    }
-}//replace()
-
 /* A função 'fillReportProcessFather' é responsável por preencher a estrutura 'Report' com informações específicas,
-   como o nome do programa, mensagens e o PID do processo atual.
+   como o nome do programa, mensagens, o PID do processo atual e a configuração comum a todos os processos filhos.
 
    Parâmetros:
    - report: Ponteiro para a estrutura 'Report' a ser preenchida.
+   - config: Configuração de execução (processos, threads, série, kernel, soma e aceleração).
 
    Essa função é utilizada para inicializar a estrutura 'Report' com informações relevantes antes de usá-la em outras partes do programa.
 */
-void fillReportProcessFather(Report* report){
+void fillReportProcessFather(Report* report, const Config *config){
     snprintf(report->programName, STRING_DEFAULT_SIZE, REPORT_PROGRAM_NAME);
-    snprintf(report->message1, STRING_DEFAULT_SIZE, REPORT_MESSAGE1);
+    snprintf(report->message1, STRING_DEFAULT_SIZE, REPORT_MESSAGE1, config->numberOfProcesses, config->numberOfProcesses, config->numberOfThreads);
     snprintf(report->message2, STRING_DEFAULT_SIZE, REPORT_MESSAGE2, getpid());
+    snprintf(report->total, STRING_DEFAULT_SIZE, REPORT_TOTAL, config->numberOfProcesses);
+    snprintf(report->series, STRING_DEFAULT_SIZE, PROCESS_REPORT_SERIES, seriesName(config->series));
+    snprintf(report->kernel, STRING_DEFAULT_SIZE, PROCESS_REPORT_KERNEL, kernelName(config->kernel));
+    snprintf(report->summation, STRING_DEFAULT_SIZE, PROCESS_REPORT_SUMMATION, summationName(config->summation));
+    snprintf(report->acceleration, STRING_DEFAULT_SIZE, PROCESS_REPORT_ACCELERATION, accelerationName(config->acceleration));
+    report->numberOfProcesses = config->numberOfProcesses;
 }//fillReportProcessFather()
 
-/* A função 'process' é responsável por coordenar a execução de múltiplos processos e a criação de um pipe para comunicação entre eles.
-   Ela segue a lógica de criação de dois processos filho.
+/* A função 'process' é responsável por coordenar a execução dos config->numberOfProcesses processos filhos.
 
    - Cria uma estrutura 'Report' para armazenar informações.
    - Chama 'fillReportProcessFather' para preencher a estrutura 'Report'.
-   - Cria um pipe usando 'createPipe' para permitir a comunicação entre os processos filhos.
-   - Cria dois processos filhos usando 'createProcess'.
-   - No primeiro filho, fecha o descritor de leitura do pipe e executa 'processChild' com a identificação 'PROCESS_ONE' e a estrutura 'Report'.
-   - No segundo filho, fecha o descritor de escrita do pipe e executa 'processChild' com a identificação 'PROCESS_TWO' e a estrutura 'Report'.
-   - No processo pai, fecha ambos os descritores do pipe e sai com EXIT_SUCCESS.
+   - Cria o segmento de memória compartilhada dos resultados com 'createSharedResults'.
+   - Cria cada processo filho com 'createProcess'; o filho executa 'processChild' com a sua identificação
+     (PROCESS_ONE, PROCESS_ONE + 1, ...) e publica o seu resultado no segmento.
+   - O pai reduz as somas parciais à medida que são publicadas com 'collectResults', grava o arquivo de tempos
+     de cada processo e escreve o relatório com 'createReport'.
+   Retorna TRUE se todos os filhos enviaram o seu resultado ou FALSE caso contrário.
 */
-void process() {
+int process(const Config *config) {
+    unsigned int numberOfProcesses = config->numberOfProcesses;
     Report report;
+    fillReportProcessFather(&report, config);
 
-    fillReportProcessFather(&report);
-
-    int pipe_fd[2]; 
-    createPipe(pipe_fd);
+    report.processReports = (ProcessReport *)calloc(numberOfProcesses, sizeof(ProcessReport));
+    pid_t *children = (pid_t *)calloc(numberOfProcesses, sizeof(pid_t));
+    if (report.processReports == NULL || children == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    SharedResults *shared = createSharedResults(numberOfProcesses, config->numberOfThreads);
 
-    pid_t process1 = createProcess();
-    pid_t process2 = createProcess();
+    struct timespec startTime, endTime;
+    struct timeval runStart, runEnd;
+    gettimeofday(&runStart, NULL);
+    clock_gettime(DURATION_CLOCK, &startTime);
 
-    if (process1 == 0 && process2 != 0) {
-        close(pipe_fd[PIPE_READ]); 
-        processChild(PROCESS_ONE, pipe_fd, &report); 
-    }
-    else if (process2 == 0 && process1 != 0) {
-        close(pipe_fd[PIPE_WRITER]); 
-        processChild(PROCESS_TWO, pipe_fd, &report); 
+    // O que o pai já escreveu não pode ficar no buffer herdado pelos filhos, ou seria escrito de novo por cada um.
+    fflush(stdout);
+    // Apenas o pai cria processos, de modo que não há netos.
+    for (unsigned int i = 0; i < numberOfProcesses; i++) {
+        pid_t pid = createProcess();
+        if (pid == 0) {
+            processChild(PROCESS_ONE + i, shared, config);
+        }
+        children[i] = pid;
     }
-    else {
-        close(pipe_fd[PIPE_READ]);
-        close(pipe_fd[PIPE_WRITER]);
-        exit(EXIT_SUCCESS);
+    CompensatedSum total;
+    int success = collectResults(shared, children, config, &total);
+    clock_gettime(DURATION_CLOCK, &endTime);
+    gettimeofday(&runEnd, NULL);
+
+    if (success) {
+        double duration = calculateDuration(startTime, endTime);
+        PiResult result;
+        int reached = FALSE;
+        CancelReason cancelled = CANCEL_NONE;
+        unsigned long long completedTerms = 0;
+        for (unsigned int i = 0; i < numberOfProcesses; i++) {
+            completedTerms += sharedProcess(shared, i)->completedTerms;
+            if (cancelled == CANCEL_NONE) {
+                cancelled = sharedProcess(shared, i)->cancelled;
+            }
+        }
+        if (config->stream == NULL && cancelled == CANCEL_NONE) {
+            result = seriesResult(config, total);
+        }
+        else if (config->stream == NULL) {
+            // Um filho cancelado reduziu só parte da sua fatia, fora de ordem: só o prefixo contíguo da série é uma soma
+            // parcial, e a aceleração usa os seus termos. Ele junta os prefixos das fatias até a primeira incompleta.
+            Accumulator prefix;
+            accumulatorInit(&prefix, config->summation);
+            Config prefixConfig = *config;
+            prefixConfig.numberOfTerms = 0;
+            for (unsigned int i = 0; i < numberOfProcesses; i++) {
+                const SharedProcess *child = sharedProcess(shared, i);
+                accumulatorAdd(&prefix, child->prefix);
+                prefixConfig.numberOfTerms += child->prefixTerms;
+                if (child->prefixTerms < child->terms.count) {
+                    break;
+                }
+            }
+            result = seriesResult(&prefixConfig, accumulatorResult(&prefix));
+        }
+        else {
+            // O resultado é o prefixo contíguo: os chunks somados depois dele não têm limitante e são descartados.
+            reached = advanceStream(config->stream, config, TRUE);
+            Config prefixConfig = *config;
+            prefixConfig.numberOfTerms = streamTerms(config->stream, config);
+            result = seriesResult(&prefixConfig, accumulatorResult(&config->stream->accumulator));
+        }
+        long long run = runIdentifier(runStart);
+        Writer *structured = config->reportFile != NULL ? openWriter(config->reportFile, config->reportFormat, CSV_HEADER) : NULL;
+        if (structured != NULL) {
+            writeRunRecord(structured, run, config, numberOfProcesses, numberOfProcesses * config->numberOfThreads, result, runStart, runEnd, duration, config->stream, reached);
+        }
+        Writer *metrics = config->metricsFile != NULL ? createMetricsFile(config->metricsFile) : NULL;
+        for (unsigned int i = 0; i < numberOfProcesses; i++) {
+            int numberProcess = PROCESS_ONE + i;
+            fillProcessReportSun(&report.processReports[i], numberProcess, sharedProcess(shared, i));
+
+            FileName fileName;
+            snprintf(fileName, sizeof(FileName), FILE_NAME_PROCESS, numberProcess);
+            String description;
+            snprintf(description, STRING_DEFAULT_SIZE, FILE_DESCRIPTION, config->numberOfThreads, numberProcess, affinityName(config->affinity));
+            createFile(fileName, description, sharedThreads(shared, i), config->numberOfThreads);
+            if (metrics != NULL) {
+                writeMetrics(metrics, numberProcess, sharedThreads(shared, i), config->numberOfThreads);
+            }
+
+            // No modo incremental, os termos de cada processo são os que as suas threads somaram.
+            const SharedProcess *child = sharedProcess(shared, i);
+            unsigned long long terms = child->terms.count;
+            if (config->stream != NULL) {
+                terms = 0;
+                for (unsigned int j = 0; j < config->numberOfThreads; j++) {
+                    terms += sharedThreads(shared, i)[j].terms;
+                }
+                snprintf(report.processReports[i].terms, STRING_DEFAULT_SIZE, STREAM_REPORT_TERMS, terms);
+            }
+            else if (child->cancelled != CANCEL_NONE) {
+                terms = child->completedTerms;
+                snprintf(report.processReports[i].terms, STRING_DEFAULT_SIZE, PROCESS_REPORT_CANCELLED_TERMS, terms, child->terms.count);
+            }
+            if (structured != NULL) {
+                writeProcessRecord(structured, run, numberProcess, child->pid, child->numberOfThreads, child->start, child->end,
+                                   child->duration, terms, child->sum.sum + child->sum.compensation);
+                writeThreadRecords(structured, run, numberProcess, sharedThreads(shared, i), config->numberOfThreads);
+            }
+        }
+        if (metrics != NULL) {
+            closeWriter(metrics);
+        }
+        if (structured != NULL) {
+            closeWriter(structured);
+        }
+        fillReportTotal(&report, duration, result, config);
+        if (config->stream != NULL) {
+            formatReport(report.bound, STRING_DEFAULT_SIZE, reached ? REPORT_BOUND : REPORT_BOUND_NOT_REACHED, config->stream->bound, config->digits);
+        }
+        if (cancelled != CANCEL_NONE) {
+            static const char *reasons[NUMBER_OF_CANCEL_REASONS] = CANCEL_REASON_NAMES;
+            snprintf(report.cancelled, STRING_DEFAULT_SIZE, REPORT_CANCELLED, reasons[cancelled], completedTerms, config->numberOfTerms, result.terms);
+        }
+        createReport(&report);
     }
+    destroySharedResults(shared);
+    free(children);
+    free(report.processReports);
+    return success;
 }//process()
 
 /*
- * Esta função inicia o programa.
- * Retorna EXIT_SUCCESS.
+ * Esta função inicia o programa com os argumentos da linha de comando.
+ * Retorna EXIT_SUCCESS ou EXIT_FAILURE se os argumentos são inválidos.
  */
-int pi(){
+int pi(int argc, char *argv[]){
+    Config config;
+    if (!parseConfig(argc, argv, &config)) {
+        fprintf(stderr, USAGE, argv[0]);
+        return EXIT_FAILURE;
+    }
     setlocale(LC_ALL, LOCALE);
-    process();
-    return  EXIT_SUCCESS;
-}//pi()
-
-int main(){
-    return pi();
-}//main()
\ No newline at end of file
+    if (config.benchmarkSummation) {
+        benchmarkSummation(&config);
+        return EXIT_SUCCESS;
+    }
+    if (config.benchmark) {
+        return benchmarkSuite(&config) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (config.benchmarkLayout) {
+        benchmarkLayout(&config);
+        return EXIT_SUCCESS;
+    }
+    if (config.precision > 0) {
+        return bigPi(&config) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (config.coordinatorAddress != NULL) {
+        return clusterWorker(&config) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (config.coordinatorPort > 0) {
+        return clusterCoordinator(&config) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (config.daemonSocket != NULL) {
+        return serveDaemon(&config) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    // O checkpoint é mapeado antes dos fork(), de modo que todos os filhos gravam no mesmo mapeamento.
+    if (config.checkpointFile != NULL) {
+        config.checkpoint = openCheckpoint(&config);
+        if (config.checkpoint == NULL) {
+            return EXIT_FAILURE;
+        }
+        if (config.resume) {
+            printf(CHECKPOINT_RESUMED, config.checkpointFile, checkpointCompleted(config.checkpoint), countChunks(&config));
+        }
+    }
+    // O cache também é mapeado antes dos fork(); os chunks que ele já tem não são somados de novo.
+    if (config.cacheDirectory != NULL) {
+        config.cache = openChunkCache(&config);
+        if (config.cache == NULL) {
+            if (config.checkpoint != NULL) {
+                closeCheckpoint(config.checkpoint);
+            }
+            return EXIT_FAILURE;
+        }
+        printf(CACHE_HITS, config.cache->fileName, cacheHits(config.cache, countChunks(&config)), countChunks(&config));
+    }
+    if (config.streaming) {
+        config.stream = createStream(&config);
+    }
+    // O prazo vale para o cálculo inteiro: o instante é fixado antes dos fork() no relógio monotônico, comum aos filhos.
+    if (config.deadline > 0.0) {
+        config.deadlineAt = monotonicSeconds() + config.deadline;
+    }
+    // O primeiro SIGINT cancela o cálculo e reporta o que já foi somado; o segundo encerra o programa.
+    signal(SIGINT, handleInterrupt);
+    int success = process(&config);
+    if (config.stream != NULL) {
+        destroyStream(config.stream);
+    }
+    if (config.cache != NULL) {
+        closeChunkCache(config.cache);
+    }
+    if (config.checkpoint != NULL) {
+        closeCheckpoint(config.checkpoint);
+    }
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}//pi()
\ No newline at end of file
@@ -1,39 +1,161 @@
 #pragma once
 
 #include <pthread.h> // Requerido pela API Pthreads (POSIX Threads).
+#include <sys/time.h> // Requerido pelos instantes dos processos (struct timeval).
+#include <sys/types.h> // Requerido pelos identificadores de processos e threads (pid_t).
 
 // Constantes lógicas.
 #define TRUE 1
 #define FALSE 0
 
-// Acesso ao pipe
-#define PIPE_READ 0
-#define PIPE_WRITER 1
-
-// Identificadores de processos 
+// Identificador do primeiro processo filho (pi1); os seguintes são numerados em sequência.
 #define PROCESS_ONE 1
-#define PROCESS_TWO 2
 
-// Número de processos
+// Número padrão de processos filhos.
 #define NUMBER_OF_PROCESS 2
 
+// Número máximo de processos filhos.
+#define MAXIMUM_NUMBER_OF_PROCESSES 256
+
+// Nome do segmento de memória compartilhada dos resultados (com o PID do pai); é removido logo após o mapeamento.
+#define SHARED_MEMORY_NAME "/pi-%d"
+#define SHARED_MEMORY_MODE 0600
+
+// Intervalo máximo de espera no futex antes de verificar se algum filho terminou sem publicar (em milissegundos).
+#define RESULT_POLL_INTERVAL_MS 100
+
+// Intervalo máximo de espera no futex no modo de convergência incremental, em que o pai também reduz o prefixo (em milissegundos).
+#define STREAM_POLL_INTERVAL_MS 5
+
+// Intervalo mínimo entre duas estimativas parciais escritas pelo modo de convergência incremental (em segundos).
+#define STREAM_REPORT_INTERVAL 0.5
+
+// Intervalo mínimo entre duas chamadas do callback de progresso de sumSeries (em segundos).
+#define PROGRESS_INTERVAL 1.0
+
+// Espera máxima do agregador de sumSeries por uma conclusão antes de verificar o prazo e o cancelamento (em segundos).
+#define COMPLETION_WAIT_INTERVAL 0.1
+
+// Margem do arredondamento em double acrescentada ao limitante do erro do modo incremental, em múltiplos de DBL_EPSILON pi.
+// Cobre a conversão da soma em pi; o erro acumulado pela soma dos termos é a margem de streamRoundingError().
+#define STREAM_ROUNDING_ULPS 4
+#define STREAM_ROUNDING_ERROR (STREAM_ROUNDING_ULPS * DBL_EPSILON * M_PI)
+
 // Tamanho do nome do arquivo.
 #define FILE_NAME_SIZE 10
 
-// Número de threads do processo filho.
-#define NUMBER_OF_THREADS 16
+// Número máximo de threads de um processo filho.
+#define MAXIMUM_NUMBER_OF_THREADS 4096
+
+// Tamanho da linha de cache, usado para separar os dados de cada worker.
+#define CACHE_LINE_SIZE 64
 
 // Tamanho padrão de string.
 #define STRING_DEFAULT_SIZE 128
 
+// Tamanho da linha de uma thread no arquivo pi%d.txt.
+#define THREAD_LINE_SIZE 320
+
+// Buffers pré-alocados dos relatórios em texto: o arquivo pi%d.txt com T threads e o relatório da tela com P processos.
+// Um texto maior ainda é escrito por inteiro, em mais de um write().
+#define FILE_TEXT_SIZE(T) (((size_t)(T) + 4) * THREAD_LINE_SIZE)
+#define REPORT_TEXT_SIZE(P) (((size_t)(P) * 8 + 16) * STRING_DEFAULT_SIZE)
+
+// Relógio das durações: monotônico, com resolução de nanossegundos e imune aos ajustes do NTP.
+// No Linux é lido pelo vDSO a partir do TSC, sem chamada de sistema.
+#define DURATION_CLOCK CLOCK_MONOTONIC
+
 // Número de casas decimais do número pi.
 #define DECIMAL_PLACES 9
 
-// Número máximo de termos da série de Leibniz.
-#define MAXIMUM_NUMBER_OF_TERMS 2000000000
+// Número máximo de casas decimais garantidas em double: pi ~ 3,14 deixa um ulp de 4,4e-16, e o arredondamento da soma
+// de qualquer série já afeta a 15ª casa (a série de Machin dá 3,141592653589794 em vez de ...793).
+#define MAXIMUM_DOUBLE_DIGITS 14
 
-// Número parcial de termos da série de Leibniz.
-#define PARTIAL_NUMBER_OF_TERMS 125000000 
+// Número padrão de termos da série de Leibniz.
+#define MAXIMUM_NUMBER_OF_TERMS 2000000000ULL
+
+// Número máximo de casas decimais do modo de precisão arbitrária.
+#define MAXIMUM_PRECISION 100000000000ULL
+
+// Arquivo padrão dos dígitos do modo de precisão arbitrária.
+#define DEFAULT_OUTPUT_FILE "pi_digits.txt"
+
+// Número padrão de termos de cada chunk distribuído pelo escalonador de roubo de trabalho.
+#define DEFAULT_CHUNK_SIZE 1000000ULL
+
+// Variáveis de ambiente que configuram a execução (a linha de comando tem precedência).
+#define ENV_THREADS "PI_THREADS"
+#define ENV_TERMS "PI_TERMS"
+#define ENV_KERNEL "PI_KERNEL"
+#define ENV_CHUNK "PI_CHUNK"
+#define ENV_SUMMATION "PI_SUMMATION"
+#define ENV_ACCELERATION "PI_ACCELERATION"
+#define ENV_SERIES "PI_SERIES"
+#define ENV_DIGITS "PI_DIGITS"
+#define ENV_PRECISION "PI_PRECISION"
+#define ENV_AFFINITY "PI_AFFINITY"
+#define ENV_PROCESSES "PI_PROCESSES"
+#define ENV_CHECKPOINT "PI_CHECKPOINT"
+#define ENV_CACHE "PI_CACHE"
+#define ENV_METRICS "PI_METRICS"
+#define ENV_REPORT "PI_REPORT"
+#define ENV_REPORT_FORMAT "PI_REPORT_FORMAT"
+#define ENV_DEADLINE "PI_DEADLINE"
+
+// Opções de linha de comando.
+#define SHORT_OPTIONS "p:t:n:k:c:s:a:A:d:P:o:C:h"
+#define OPTION_PROCESSES "processes"
+#define OPTION_THREADS "threads"
+#define OPTION_TERMS "terms"
+#define OPTION_KERNEL "kernel"
+#define OPTION_CHUNK "chunk"
+#define OPTION_SUMMATION "summation"
+#define OPTION_ACCELERATION "acceleration"
+#define OPTION_SERIES "algorithm"
+#define OPTION_DIGITS "digits"
+#define OPTION_PRECISION "precision"
+#define OPTION_OUTPUT "output"
+#define OPTION_AFFINITY "affinity"
+#define OPTION_BENCHMARK_SUMMATION "benchmark-summation"
+#define OPTION_BENCHMARK_LAYOUT "benchmark-layout"
+#define OPTION_BENCHMARK "benchmark"
+#define OPTION_REPETITIONS "repetitions"
+#define OPTION_WARMUP "warmup"
+#define OPTION_COORDINATOR "coordinator"
+#define OPTION_WORKER "worker"
+#define OPTION_CHECKPOINT "checkpoint"
+#define OPTION_RESUME "resume"
+#define OPTION_STREAM "stream"
+#define OPTION_CACHE "cache"
+#define OPTION_PERF "perf"
+#define OPTION_METRICS "metrics"
+#define OPTION_REPORT "report"
+#define OPTION_REPORT_FORMAT "report-format"
+#define OPTION_DEADLINE "deadline"
+#define OPTION_PROGRESS "progress"
+#define OPTION_DAEMON "daemon"
+
+// Códigos das opções que só têm a forma longa.
+#define OPTION_BENCHMARK_SUMMATION_CODE 256
+#define OPTION_BENCHMARK_LAYOUT_CODE 257
+#define OPTION_COORDINATOR_CODE 258
+#define OPTION_WORKER_CODE 259
+#define OPTION_CHECKPOINT_CODE 260
+#define OPTION_RESUME_CODE 261
+#define OPTION_STREAM_CODE 262
+#define OPTION_CACHE_CODE 263
+#define OPTION_PERF_CODE 264
+#define OPTION_METRICS_CODE 265
+#define OPTION_REPORT_CODE 266
+#define OPTION_REPORT_FORMAT_CODE 267
+#define OPTION_BENCHMARK_CODE 268
+#define OPTION_REPETITIONS_CODE 269
+#define OPTION_WARMUP_CODE 270
+#define OPTION_DEADLINE_CODE 271
+#define OPTION_PROGRESS_CODE 272
+#define OPTION_DAEMON_CODE 273
+#define OPTION_HELP "help"
 
 // Região 
 #define LOCALE "pt_BR.utf8"
@@ -53,33 +175,203 @@
 
 // Constantes definidas para preencher a estrutura report do processo pai. 
 #define REPORT_PROGRAM_NAME "Cálculo do Número π"
-#define REPORT_MESSAGE1 "Criando os processos filhos pi1 e pi2..."
+#define REPORT_MESSAGE1 "Criando %u processos filhos (pi1 a pi%u) com %u threads cada..."
 #define REPORT_MESSAGE2 "Processo pai (PID %d) finalizou sua execução."
+#define REPORT_TOTAL "- Resultado combinado dos %u processos filhos"
 
 // Constantes definidas para preencher a estrutura PocessReport dos processos filhos. 
 #define PROCESS_REPORT_IDENTIFICATION  "- Processo Filho: pi%d (PID %d)"
-#define PROCESS_REPORT_NUMBER_OF_THREADS "Nº de threads: %d"
+#define PROCESS_REPORT_NUMBER_OF_THREADS "Nº de threads: %u"
 #define PROCESS_REPORT_START "Início: %s" 
 #define PROCESS_REPORT_END "Fim: %s"
 #define PROCESS_REPORT_DURATION "Duração: %.2lf s"
-#define PROCESS_REPORT_PI "Pi = %.9lf"
+#define PROCESS_REPORT_SLICE "Termos: %llu a %llu (%llu termos)"
+#define PROCESS_REPORT_PARTIAL_SUM "Soma parcial = %.17lf"
+#define PROCESS_REPORT_PI "Pi = %.*lf"
+#define PROCESS_REPORT_SERIES "Série: %s"
+#define PROCESS_REPORT_KERNEL "Kernel: %s"
+#define PROCESS_REPORT_SUMMATION "Soma: %s"
+#define PROCESS_REPORT_ACCELERATION "Aceleração: %s"
+#define PROCESS_REPORT_TERMS "Termos avaliados: %llu"
+#define PROCESS_REPORT_RAW_PI "Pi sem aceleração = %.*lf"
+
+// Formatações do modo de convergência incremental.
+#define STREAM_PROGRESS "Termos: %llu\tPi = %.*lf ± %.1e"
+#define STREAM_REPORT_TERMS "Termos: %llu (chunks em ordem crescente)"
+#define REPORT_BOUND "Erro máximo = %.1e (%u casas garantidas)"
+#define PROGRESS_LINE "Processo pi%d: %llu de %llu chunks, %llu de %llu termos (%.1lf%%) em %.1lf s"
+#define PROCESS_REPORT_CANCELLED_TERMS "Termos: %llu de %llu somados (cálculo interrompido)"
+#define REPORT_CANCELLED "Interrompido (%s): %llu de %llu termos somados, %llu contíguos na estimativa"
+#define CANCEL_REASON_NAMES { "", "prazo esgotado", "pedido de cancelamento" }
+#define REPORT_BOUND_NOT_REACHED "Erro máximo = %.1e (%u casas não garantidas: os termos acabaram antes)"
+
+// Nomes dos kernels da soma parcial, na ordem de KernelType.
+#define KERNEL_NAMES { "auto", "scalar", "sse2", "avx2", "avx512", "newton" }
+
+// Número de acumuladores independentes usados pelos kernels vetoriais.
+#define KERNEL_ACCUMULATORS 4
+
+// Iterações de Newton do kernel newton: cada uma dobra os bits corretos do recíproco aproximado, que parte de
+// 14 bits com rcp14 (AVX-512) e de 11 bits com rcp_ps em precisão simples (AVX2), até os 53 bits do double.
+#define NEWTON_ITERATIONS_AVX512 2
+#define NEWTON_ITERATIONS_AVX2 3
+
+// Pares de termos desdobrados por acumulador e acumuladores independentes dos kernels escalares especializados.
+#define SPECIALIZED_UNROLL 2
+#define SPECIALIZED_ACCUMULATORS 4
+
+// Comprimentos de chunk com kernels especializados de tamanho fixo (pares, para que todo chunk comece num termo par).
+#define SPECIALIZED_LENGTH_LARGE DEFAULT_CHUNK_SIZE
+#define SPECIALIZED_LENGTH_SMALL 65536ULL
+
+// Nomes das estratégias de soma, na ordem de SummationMode.
+#define SUMMATION_NAMES { "naive", "neumaier", "pairwise", "double-double" }
+
+// Nomes aceitos pela opção --report-format, na ordem de ReportFormat.
+#define REPORT_FORMAT_NAMES { "json", "csv" }
+
+// Termos somados ingenuamente por um kernel vetorial antes de cada passo compensado ou par a par.
+#define SUMMATION_BLOCK 1024
+
+// Níveis da soma par a par em cascata (suficiente para 2^64 parcelas).
+#define PAIRWISE_LEVELS 64
+
+// Nomes das séries, na ordem de SeriesType.
+#define SERIES_NAMES { "auto", "leibniz", "machin", "bbp", "chudnovsky" }
+
+// Constantes da série de Chudnovsky.
+#define CHUDNOVSKY_A 13591409.0
+#define CHUDNOVSKY_B 545140134.0
+#define CHUDNOVSKY_C 640320.0
+
+// Nomes dos modos de aceleração da série, na ordem de AccelerationMode.
+#define ACCELERATION_NAMES { "none", "tail", "euler" }
+
+// Nomes das políticas de afinidade, na ordem de AffinityPolicy. Um valor que começa com um dígito é uma lista de CPUs.
+#define AFFINITY_NAMES { "none", "compact", "scatter", "numa", "list" }
+
+// Arquivos do sysfs com a topologia das CPUs e dos nós NUMA.
+#define SYSFS_CPU_PACKAGE "/sys/devices/system/cpu/cpu%d/topology/physical_package_id"
+#define SYSFS_CPU_CORE "/sys/devices/system/cpu/cpu%d/topology/core_id"
+#define SYSFS_NODE_CPULIST "/sys/devices/system/node/node%d/cpulist"
+
+// Maior identificador de nó NUMA examinado no sysfs.
+#define MAXIMUM_NUMA_NODES 64
+
+// CPU de uma thread que não foi fixada pela política de afinidade.
+#define CPU_NOT_PINNED -1
+
+// Separadores da lista de CPUs (por exemplo, 0-3,8,10-11).
+#define CPU_LIST_SEPARATOR ','
+#define CPU_RANGE_SEPARATOR '-'
+
+// Somas parciais finais combinadas pela transformação de Euler (médias repetidas de Van Wijngaarden).
+#define ACCELERATION_DEPTH 24
+
+// Números de Euler E0, E2, E4, ... usados na correção assintótica da cauda da série de Leibniz.
+#define EULER_NUMBERS { 1.0, -1.0, 5.0, -61.0, 1385.0, -50521.0, 2702765.0, -199360981.0 }
+
+// Formatações do benchmark das estratégias de soma.
+#define BENCHMARK_SUMMATION_TITLE "Custo das estratégias de soma (%llu termos, %u threads, kernel %s)\n\n"
+#define BENCHMARK_SUMMATION_HEADER "%-14s %10s %16s %14s %18s\n"
+#define BENCHMARK_SUMMATION_ROW "%-14s %10.3lf %16.4e %14.12lf %18.3e\n"
+#define BENCHMARK_SUMMATION_COLUMNS "Soma", "Tempo (s)", "Termos/s", "Pi", "Erro vs. dd"
+
+// Nomes dos layouts dos resultados por worker medidos pelo benchmark de layout, na ordem de LayoutMode.
+#define LAYOUT_NAMES { "packed", "padded", "register" }
+
+// Formatações do benchmark de layout dos resultados por worker.
+#define BENCHMARK_LAYOUT_TITLE "Escalabilidade dos layouts dos resultados por worker (%llu termos, de 1 a %u threads)\n\n"
+#define BENCHMARK_LAYOUT_HEADER "%-8s %-10s %10s %16s %10s\n"
+#define BENCHMARK_LAYOUT_ROW "%-8u %-10s %10.3lf %16.4e %10.2lf\n"
+#define BENCHMARK_LAYOUT_COLUMNS "Threads", "Layout", "Tempo (s)", "Termos/s", "Speedup"
 
 // Mensagens de erros.
-#define ERROR_PIPE "Erro ao criar o pipe"
+#define ERROR_SHARED_MEMORY "Erro ao criar a memória compartilhada dos resultados"
 #define ERROR_PROCESS "ERRO: o processo filho não foi criado."
+#define ERROR_CHILD "ERRO: o processo filho pi%d terminou sem publicar o seu resultado.\n"
+#define ERROR_INVALID_PROCESSES "Número de processos inválido: %s\n"
 #define ERROR_FILE "Não foi possível abrir o arquivo."
 #define ERROR_MALLOC "Erro na alocação de memória"
+#define ERROR_THREAD "Erro ao criar a thread"
+#define ERROR_THREAD_POOL "Erro ao criar o pool de threads"
+#define ERROR_INVALID_TERMS "Número de termos inválido: %s\n"
+#define ERROR_INVALID_THREADS "Número de threads inválido: %s\n"
+#define ERROR_INVALID_KERNEL "Kernel inválido: %s\n"
+#define ERROR_INVALID_CHUNK "Tamanho de chunk inválido: %s\n"
+#define ERROR_UNSUPPORTED_KERNEL "Kernel não suportado por esta CPU: %s\n"
+#define ERROR_INVALID_SUMMATION "Estratégia de soma inválida: %s\n"
+#define ERROR_INVALID_ACCELERATION "Modo de aceleração inválido: %s\n"
+#define ERROR_INVALID_SERIES "Série inválida: %s\n"
+#define ERROR_INVALID_DIGITS "Número de casas decimais inválido: %s\n"
+#define ERROR_ACCELERATION_SERIES "A aceleração só se aplica à série de Leibniz.\n"
+#define ERROR_INVALID_AFFINITY "Política de afinidade inválida: %s\n"
+#define ERROR_INVALID_PRECISION "Número de casas decimais de precisão arbitrária inválido: %s\n"
+#define ERROR_INVALID_PORT "Porta do coordenador inválida: %s\n"
+#define ERROR_INVALID_REPORT_FORMAT "Formato de relatório inválido: %s\n"
+#define ERROR_INVALID_REPETITIONS "Número de repetições inválido: %s\n"
+#define ERROR_INVALID_DEADLINE "Prazo inválido: %s\n"
+#define ERROR_STREAM_SUMMATION "O modo de convergência incremental exige uma soma compensada (neumaier, pairwise ou double-double): o erro da soma ingênua cresce com o número de termos.\n"
+#define ERROR_STREAM_DIGITS "O modo de convergência incremental não garante %u casas na série %s: a margem de arredondamento passa da tolerância. Use menos casas, outra série ou -n.\n"
+#define ERROR_STREAM_ACCELERATION "O modo de convergência incremental não aceita aceleração: o limitante do erro vale só para a série.\n"
+
+// Mensagem de uso do programa.
+#define USAGE \
+   "Uso: %s [-p|--processes P] [-t|--threads N] [-n|--terms N] [-k|--kernel K] [-c|--chunk N]\n" \
+   "          [-s|--summation S] [-a|--acceleration A] [-A|--algorithm S] [-d|--digits D]\n" \
+   "          [-C|--affinity P] [-P|--precision D] [-o|--output ARQUIVO] [--benchmark-summation] [--benchmark-layout]\n" \
+   "          [--coordinator PORTA | --worker HOST:PORTA | --daemon SOCKET] [--checkpoint ARQUIVO [--resume]] [--stream]\n" \
+   "          [--cache DIRETORIO] [--perf] [--metrics ARQUIVO] [--report ARQUIVO [--report-format F]]\n" \
+   "          [--benchmark [--repetitions R] [--warmup W]] [--deadline S] [--progress]\n" \
+   "  -p, --processes P  número de processos filhos; cada um soma uma fatia disjunta dos termos (padrão: 2, ou $" ENV_PROCESSES ")\n" \
+   "  -t, --threads N  número de threads de cada processo filho (padrão: CPUs online, ou $" ENV_THREADS ")\n" \
+   "  -n, --terms N    número total de termos da série (padrão: os necessários para D casas, 2000000000 em Leibniz, ou $" ENV_TERMS ")\n" \
+   "  -k, --kernel K   kernel da soma parcial: auto, scalar, sse2, avx2, avx512 ou newton (padrão: auto, ou $" ENV_KERNEL ")\n" \
+   "  -c, --chunk N    termos por chunk do escalonador de roubo de trabalho (padrão: 1000000, ou $" ENV_CHUNK ")\n" \
+   "  -s, --summation S  estratégia de soma: naive, neumaier, pairwise ou double-double (padrão: naive, ou neumaier com --stream, ou $" ENV_SUMMATION ")\n" \
+   "  -a, --acceleration A  aceleração da série: none, tail ou euler (padrão: none, ou $" ENV_ACCELERATION ")\n" \
+   "  -A, --algorithm S  série: leibniz, machin, bbp, chudnovsky ou auto (a mais barata para D casas) (padrão: leibniz, ou $" ENV_SERIES ")\n" \
+   "  -d, --digits D   casas decimais exibidas, de 1 a 14; sem -n, define os termos necessários (padrão: 9, ou $" ENV_DIGITS ")\n" \
+   "  -P, --precision D  calcula D casas decimais com precisão arbitrária (GMP, Chudnovsky) (padrão: desligado, ou $" ENV_PRECISION ")\n" \
+   "  -C, --affinity P  afinidade das threads e dos processos: none, compact, scatter, numa ou uma lista de CPUs como 0-3,8 (padrão: compact, ou $" ENV_AFFINITY ")\n" \
+   "  -o, --output ARQUIVO  arquivo dos dígitos do modo de precisão arbitrária (padrão: " DEFAULT_OUTPUT_FILE ")\n" \
+   "  --benchmark-summation  mede o custo e a precisão de cada estratégia de soma e encerra\n" \
+   "  --coordinator PORTA  distribui os termos em lotes aos workers que se conectarem à PORTA TCP e combina os resultados\n" \
+   "  --worker HOST:PORTA  soma, com as threads deste nó, os lotes entregues pelo coordenador em HOST:PORTA\n" \
+   "  --checkpoint ARQUIVO  grava a soma de cada chunk concluído em ARQUIVO, sincronizado com o disco a cada 10 s (padrão: desligado, ou $" ENV_CHECKPOINT ")\n" \
+   "  --resume         reaproveita os chunks já somados no checkpoint em vez de sobrescrevê-lo\n" \
+   "  --cache DIRETORIO  reaproveita as somas dos chunks completos gravadas em DIRETORIO por execuções anteriores e grava as novas (padrão: desligado, ou $" ENV_CACHE ")\n" \
+   "  --perf           lê os contadores de ciclos, instruções e migrações de cada thread com perf_event_open\n" \
+   "  --metrics ARQUIVO  exporta em CSV as métricas de cada thread: tempos de parede e de CPU, vazão, trocas de contexto e contadores (padrão: desligado, ou $" ENV_METRICS ")\n" \
+   "  --report ARQUIVO  grava também o relatório estruturado, com um registro da execução, de cada processo e de cada thread (padrão: desligado, ou $" ENV_REPORT ")\n" \
+   "  --report-format F  formato do relatório estruturado: json (um objeto por linha) ou csv (padrão: json, ou $" ENV_REPORT_FORMAT ")\n" \
+   "  --deadline S     cancela o cálculo S segundos após o início e reporta a soma dos chunks concluídos (padrão: sem prazo, ou $" ENV_DEADLINE ")\n" \
+   "  --progress       escreve o progresso de cada processo filho (chunks e termos somados) a cada segundo\n" \
+   "  --daemon SOCKET  atende pedidos \"TERMOS [SERIE]\" em um socket Unix com um pool aquecido, agrupa os pedidos simultâneos\n" \
+   "                   e reaproveita os chunks já somados; responde uma linha JSON por pedido com a estimativa e a latência\n" \
+   "  --stream         escreve estimativas parciais com o limitante do erro e para assim que as D casas estão garantidas\n" \
+   "  --benchmark      executa a bateria de benchmarks: threads de 1 a N, kernels e acelerações, somas e termos, com mediana, p95,\n" \
+   "                   termos/s por núcleo, eficiência paralela e erro de cada caso, e encerra\n" \
+   "  --repetitions R  repetições medidas de cada caso da bateria (padrão: 5)\n" \
+   "  --warmup W       repetições de aquecimento, não medidas, de cada caso da bateria (padrão: 1)\n" \
+   "  --benchmark-layout  mede a escalabilidade, de 1 a N threads, dos resultados por worker com e sem slots alinhados e encerra\n" \
+   "  -h, --help       exibe esta mensagem\n"
 
 // Opção de abertura do arquivo.
 #define FILE_OPENING_OPTION "w"
 
 // Formatações de escrita em arquivo para o createFile.
 #define FILE_NAME_PROCESS "pi%d.txt"
-#define FILE_DESCRIPTION "Tempo em segundos das 16 threads do processo filho pi%d."
+#define FILE_DESCRIPTION "Tempo em segundos das %u threads do processo filho pi%d (afinidade %s)."
 #define SHOW_FILE_NAME "Arquivo: %s%c"
 #define SHOW_FILE_DESCRIPTION "Descrição: %s%s"
-#define SHOW_TID "TID %d: %.2lf%c"
-#define SHOW_TOTAL_TIME_THREAD "%cTotal: %.2lf s%c"
+#define SHOW_TID "TID %d (CPU %s): %.6lf s, CPU %.6lf s, %.3e termos/s (%llu termos, %u chunks, %u roubos, %llu/%llu trocas de contexto, %llu migrações"
+#define SHOW_TID_IPC ", %.2lf IPC"
+#define SHOW_TID_END ")%c"
+#define SHOW_CPU "%d"
+#define CPU_TEXT_SIZE 32
+#define SHOW_CPU_NOT_PINNED "livre, terminou na %d"
+#define SHOW_TOTAL_TIME_THREAD "%cTotal: %.6lf s%c"
 
 // Define uma string de tamanho padrão T, onde T é igual STRING_DEFAULT_SIZE.
 typedef char String[STRING_DEFAULT_SIZE];
@@ -95,8 +387,9 @@ typedef struct {
       numberOfThreads, // Nº de threads: 16
       start, // Início: 10:45:12
       end, // Fim: 10:45:21
-      duration, // Duração: 9,59 s
-      pi; // Pi = 3,141592653   
+      duration, // Duração: 4,81 s
+      terms, // Termos: 0 a 999999999 (1000000000 termos)
+      partialSum; // Soma parcial = 0,78539816364
 } ProcessReport;
 
 // Estrutura do relatório a ser gerado pelo programa.
@@ -104,93 +397,727 @@ typedef struct {
    // Os comentários abaixo são apenas exemplos de valores a serem armazenados nos campos desta estrutura.
    String 
       programName, // Cálculo do Número π
-      message1, // Criando os processos filhos pi1 e pi2...
-      message2; // Processo pai (PID 6923) finalizou sua execução.
-      
-   ProcessReport processReport1, processReport2;     
+      message1, // Criando 2 processos filhos (pi1 a pi2) com 16 threads cada...
+      message2, // Processo pai (PID 6923) finalizou sua execução.
+      total, // - Resultado combinado dos 2 processos filhos
+      series, // Série: leibniz
+      kernel, // Kernel: avx2
+      summation, // Soma: neumaier
+      acceleration, // Aceleração: tail
+      duration, // Duração: 4,83 s
+      pi, // Pi = 3,141592653
+      rawPi, // Pi sem aceleração = 3,141592154 (vazio sem aceleração)
+      bound, // Erro máximo = 5,0e-08 (7 casas garantidas) (vazio fora do modo de convergência incremental)
+      cancelled, // Cálculo interrompido (prazo esgotado): 1000000 de 2000000000 termos somados; ... (vazio sem cancelamento)
+      terms; // Termos avaliados: 2000000000
+
+   unsigned int numberOfProcesses;
+   ProcessReport *processReports; // Relatório de cada processo filho, na ordem pi1, pi2, ...
 } Report;
 
-// Representa a identificação da thread e o seu tempo de execução em segundos.
+// Representa a identificação da thread, o seu tempo de execução em segundos e o trabalho que ela realizou.
 typedef struct  {
    pthread_t threadID; // Identificação da thread obtida com pthread_create.
    pid_t tid;          // Identificação da thread obtida com gettid.
-   double time; 
+   double time;              // Tempo de parede da thread (DURATION_CLOCK), em segundos.
+   double cpuTime;           // Tempo de CPU consumido pela thread, em segundos.
+   unsigned long long terms; // Termos somados pela thread.
+   unsigned int chunks;      // Chunks processados pela thread.
+   unsigned int steals;      // Roubos de trabalho bem sucedidos realizados pela thread.
+   int cpu;                  // CPU atribuída pela política de afinidade (CPU_NOT_PINNED se a thread está livre).
+   int lastCpu;              // CPU em que a thread terminou o último trabalho.
+   unsigned long long voluntarySwitches;   // Trocas de contexto voluntárias (getrusage).
+   unsigned long long involuntarySwitches; // Trocas de contexto involuntárias, por preempção.
+   unsigned long long migrations;          // Migrações entre CPUs (contadas pelo núcleo com --perf, ou observadas entre chunks).
+   unsigned long long cycles, instructions; // Contadores de hardware, válidos se hardwareCounters.
+   int hardwareCounters;                   // TRUE se cycles e instructions foram lidos com perf_event_open.
+   double started, finished;               // Instantes de início e fim do trabalho, em segundos desde a época.
 } Thread;
 
 // Representa o resultado obtido por sumPartional
 typedef struct {
    Thread thread;
    double sumPartional;
+   double compensation; // Correção da soma compensada (0 na soma ingênua).
 } ThreadResult;
 
-// Relação de threads do processo filho.
-typedef Thread Threads[NUMBER_OF_THREADS]; 
+// Formatos do relatório estruturado.
+typedef enum {
+   REPORT_JSON,             // Um objeto JSON por linha (JSON Lines).
+   REPORT_CSV,              // Uma tabela CSV com cabeçalho.
+   NUMBER_OF_REPORT_FORMATS
+} ReportFormat;
+
+// Estratégias de soma usadas pelos kernels e pela redução final.
+typedef enum {
+   SUMMATION_NAIVE,         // Soma direta em double.
+   SUMMATION_NEUMAIER,      // Soma compensada de Kahan-Neumaier.
+   SUMMATION_PAIRWISE,      // Soma par a par em cascata.
+   SUMMATION_DOUBLE_DOUBLE, // Soma em aritmética double-double (TwoSum).
+   NUMBER_OF_SUMMATIONS
+} SummationMode;
+
+// Soma com correção: o valor é sum + compensation, com compensation muito menor do que sum.
+typedef struct {
+   double sum, compensation;
+} CompensatedSum;
+
+// Modos de aceleração aplicados à soma da série de Leibniz.
+typedef enum {
+   ACCELERATION_NONE,  // A soma parcial da série, sem correção.
+   ACCELERATION_TAIL,  // Correção assintótica da cauda com os números de Euler.
+   ACCELERATION_EULER, // Transformação de Euler (médias repetidas das últimas somas parciais).
+   NUMBER_OF_ACCELERATIONS
+} AccelerationMode;
+
+// Resultado de um cálculo de pi.
+typedef struct {
+   double pi;                // Estimativa reportada (acelerada, se houver aceleração).
+   double rawPi;             // Estimativa da série sem aceleração.
+   unsigned long long terms; // Termos efetivamente avaliados.
+} PiResult;
+
+// Motivos do cancelamento de um cálculo.
+typedef enum {
+   CANCEL_NONE,     // O cálculo somou todos os chunks.
+   CANCEL_DEADLINE, // O prazo config->deadline se esgotou.
+   CANCEL_REQUEST,  // cancelCalculation() foi chamada (por exemplo, pelo SIGINT).
+   NUMBER_OF_CANCEL_REASONS
+} CancelReason;
+
+// Progresso de um cálculo de sumSeries, passado ao callback de progresso e devolvido ao final.
+typedef struct {
+   unsigned long long terms, totalTerms;   // Termos dos chunks já reduzidos e da fatia inteira.
+   unsigned long long chunks, totalChunks; // Chunks já reduzidos e da fatia inteira.
+   CompensatedSum sum;                     // Soma dos chunks já reduzidos, na ordem em que foram concluídos.
+   CompensatedSum prefix;                  // Soma do prefixo contíguo de chunks reduzidos desde o início da fatia (só ao final).
+   unsigned long long prefixTerms;         // Termos desse prefixo (só ao final; igual a 'terms' se o cálculo não foi cancelado).
+   double elapsed;                         // Segundos desde a submissão (DURATION_CLOCK).
+   CancelReason cancelled;                 // Motivo do cancelamento, ou CANCEL_NONE.
+} Progress;
+
+// Callback chamado pelo agregador de sumSeries a cada PROGRESS_INTERVAL segundos com o progresso do cálculo e o contexto
+// config->progressContext. Retorna FALSE para cancelar o cálculo.
+typedef int (*ProgressCallback)(const Progress *progress, void *context);
+
+// Acumulador de uma estratégia de soma.
+typedef struct {
+   SummationMode mode;
+   double sum, compensation;         // Naive, Neumaier e double-double (parte alta e parte baixa).
+   double levels[PAIRWISE_LEVELS];   // Par a par: levels[k] guarda a soma de 2^k parcelas.
+   unsigned long long count;         // Par a par: número de parcelas, usado como contador binário.
+} Accumulator;
+
+// Intervalo de termos [start, start + count) da série de Leibniz atribuído a uma thread.
+typedef struct {
+   unsigned long long start, count;
+} TermRange;
+
+// Kernels disponíveis para a soma parcial. KERNEL_AUTO escolhe o melhor suportado pela CPU.
+typedef enum {
+   KERNEL_AUTO,
+   KERNEL_SCALAR,
+   KERNEL_SSE2,
+   KERNEL_AVX2,
+   KERNEL_AVX512,
+   KERNEL_NEWTON,                  // Recíprocos por iterações de Newton, sem divisão; só é usado quando pedido.
+   NUMBER_OF_KERNELS
+} KernelType;
+
+// Função que retorna a soma dos termos [start, start + count) de uma série.
+typedef double (*SeriesKernel)(unsigned long long start, unsigned long long count);
+
+// Função que retorna a soma compensada dos termos [start, start + count) de uma série (kernels especializados).
+typedef CompensatedSum (*CompensatedKernel)(unsigned long long start, unsigned long long count);
+
+// Séries disponíveis para o cálculo de pi. SERIES_AUTO escolhe a mais barata para as casas decimais pedidas.
+typedef enum {
+   SERIES_AUTO,
+   SERIES_LEIBNIZ,    // pi = 4 sum((-1)^k / (2k + 1))
+   SERIES_MACHIN,     // pi = 16 arctan(1/5) - 4 arctan(1/239)
+   SERIES_BBP,        // pi = sum(16^-k (4/(8k+1) - 2/(8k+4) - 1/(8k+5) - 1/(8k+6)))
+   SERIES_CHUDNOVSKY, // 1/pi = 12 sum((-1)^k (6k)! (A + Bk) / ((3k)! (k!)^3 C^(3k+3/2)))
+   NUMBER_OF_SERIES
+} SeriesType;
+
+// Backend de série: o kernel que o escalonador executa sobre intervalos de termos e a conversão da soma em pi.
+typedef struct {
+   SeriesKernel kernel;                                // Kernel escalar da série.
+   double (*toPi)(double sum);                         // Converte a soma de todos os termos em pi.
+   unsigned long long (*termsForDigits)(unsigned int digits); // Termos necessários para 'digits' casas decimais.
+   double (*errorBound)(unsigned long long terms);     // Limitante de |pi - toPi(soma dos 'terms' primeiros termos)|.
+   double (*absoluteSum)(unsigned long long terms);    // Limitante da soma dos |termos| dos 'terms' primeiros, na escala de pi.
+   double costPerTerm;                                 // Custo relativo de um termo (Leibniz = 1).
+} Series;
+
+// Fila de trabalho de uma thread: chunks [top, bottom) ainda não processados.
+// A dona consome pelo início (top) e as ladras roubam a metade final (bottom).
+typedef struct {
+   pthread_mutex_t mutex;
+   unsigned long long top, bottom;
+} WorkQueue;
+
+// Dados de um worker no pool. A fila (travada também pelas ladras) e o resultado (gravado pela dona) ficam em linhas
+// de cache próprias, e os slots ficam em um único vetor alinhado, de modo que as escritas de um worker nunca invalidam
+// as linhas de outro (false sharing).
+typedef struct {
+   WorkQueue queue __attribute__((aligned(CACHE_LINE_SIZE)));
+   ThreadResult result __attribute__((aligned(CACHE_LINE_SIZE)));
+} WorkerSlot;
+
+// Políticas de fixação das threads e dos processos filhos nas CPUs.
+typedef enum {
+   AFFINITY_NONE,    // O escalonador do sistema posiciona as threads.
+   AFFINITY_COMPACT, // Threads consecutivas em CPUs vizinhas (irmãs de SMT, depois núcleos do mesmo pacote).
+   AFFINITY_SCATTER, // Threads consecutivas alternando pacotes e núcleos, irmãs de SMT por último.
+   AFFINITY_NUMA,    // Cada processo filho fica em um nó NUMA, com as suas threads nas CPUs do nó.
+   AFFINITY_LIST,    // Threads distribuídas em ordem por uma lista explícita de CPUs.
+   NUMBER_OF_AFFINITIES
+} AffinityPolicy;
+
+// Posição de uma CPU na topologia da máquina.
+typedef struct {
+   int cpu, node, package, core;
+   int smt; // Ordem da CPU entre as irmãs do mesmo núcleo.
+} CpuInfo;
+
+// Layouts dos resultados por worker comparados pelo benchmark de layout.
+typedef enum {
+   LAYOUT_PACKED,   // Somas adjacentes em um vetor compacto, gravadas a cada termo (o layout antigo).
+   LAYOUT_PADDED,   // Somas nos slots alinhados do pool, gravadas a cada termo.
+   LAYOUT_REGISTER, // Soma em registrador e uma única gravação no slot alinhado ao final (o layout de sumPartial).
+   NUMBER_OF_LAYOUTS
+} LayoutMode;
+
+// Argumento do trabalho do benchmark de layout.
+typedef struct {
+   LayoutMode mode;
+   unsigned long long numberOfTerms;
+   unsigned int numberOfWorkers;
+   volatile double *packed;        // Vetor compacto usado por LAYOUT_PACKED, uma soma por worker.
+} LayoutBenchmark;
+
+// Estado compartilhado pelas threads de um cálculo no escalonador de roubo de trabalho.
+typedef struct {
+   WorkerSlot *slots;                // A fila de cada thread está no seu slot.
+   unsigned int numberOfWorkers;
+   unsigned long long numberOfTerms; // Total de termos do cálculo.
+   unsigned long long chunkSize;     // Termos por chunk; o chunk c cobre [c * chunkSize, (c + 1) * chunkSize).
+   SeriesKernel kernel;
+   SummationMode summation;
+   CompensatedKernel fullKernel;     // Kernel especializado para os chunks de chunkSize termos (NULL sem especialização).
+   CompensatedKernel partialKernel;  // Kernel especializado para o último chunk, mais curto (NULL sem especialização).
+   struct CompletionQueue *completions; // Fila em que os workers publicam cada chunk concluído para o agregador.
+   int cancelled;                    // TRUE quando o agregador pede aos workers que parem antes do próximo chunk.
+   struct Checkpoint *checkpoint;    // Checkpoint das somas dos chunks (NULL sem checkpoint).
+   struct ChunkCache *cache;         // Cache das somas dos chunks entre execuções (NULL sem cache).
+   int hardwareCounters;             // TRUE para ler os contadores de hardware de cada thread.
+   struct Stream *stream;            // Chunks em ordem crescente do modo de convergência incremental (NULL fora do modo).
+} Scheduler;
+
+// Trabalho executado por cada worker do pool: recebe o argumento submetido, o índice do worker e o seu slot de resultado.
+typedef void (*PoolJob)(void *argument, unsigned int worker, ThreadResult *result);
+
+struct ThreadPool;
+
+// Tarefa de um worker do pool: o pool ao qual pertence e o seu índice.
+typedef struct {
+   struct ThreadPool *pool;
+   unsigned int index;
+} ThreadTask;
+
+// Pool de workers persistentes, criados uma vez e reutilizados por todos os cálculos do processo.
+// Todo trabalho submetido é executado por todos os workers; os resultados vão para slots pré-alocados.
+typedef struct ThreadPool {
+   pthread_mutex_t mutex;
+   pthread_cond_t start;           // Sinaliza aos workers um novo trabalho ou o encerramento do pool.
+   pthread_cond_t done;            // Sinaliza que todos os workers terminaram o trabalho atual.
+   unsigned int numberOfWorkers;
+   unsigned long long generation;  // Incrementado a cada trabalho submetido.
+   unsigned int pending;           // Workers que ainda executam o trabalho atual.
+   int shutdown;
+   PoolJob job;
+   void *argument;
+   Thread *threads;                // Identificação e estatísticas de cada worker.
+   ThreadTask *tasks;              // Argumento de createThread de cada worker.
+   WorkerSlot *slots;              // Fila e resultado de cada worker, alinhados à linha de cache e reutilizados entre cálculos.
+   struct CompletionQueue *completions; // Fila de conclusões dos chunks, reutilizada entre cálculos.
+} ThreadPool;
+
+// Configuração de execução obtida da linha de comando ou das variáveis de ambiente.
+typedef struct {
+   unsigned long long numberOfTerms; // Total de termos da série.
+   unsigned int numberOfThreads;     // Número de threads de cada processo filho.
+   KernelType kernel;                // Kernel da soma parcial (resolvido por selectKernel).
+   unsigned long long chunkSize;     // Termos por chunk do escalonador de roubo de trabalho.
+   SummationMode summation;          // Estratégia de soma dos kernels e da redução final.
+   AccelerationMode acceleration;    // Aceleração aplicada à soma da série.
+   SeriesType series;                // Série usada no cálculo (resolvida por parseConfig).
+   unsigned int digits;              // Casas decimais exibidas.
+   int benchmarkSummation;           // TRUE para medir as estratégias de soma em vez de calcular pi.
+   int benchmarkLayout;              // TRUE para medir os layouts dos resultados por worker em vez de calcular pi.
+   int benchmark;                    // TRUE para executar a bateria de benchmarks em vez de calcular pi.
+   unsigned int repetitions;         // Repetições medidas de cada caso da bateria.
+   unsigned int warmup;              // Repetições de aquecimento de cada caso da bateria.
+   unsigned long long precision;     // Casas decimais do modo de precisão arbitrária (0 desliga o modo).
+   const char *outputFile;           // Arquivo dos dígitos do modo de precisão arbitrária.
+   unsigned int numberOfProcesses;   // Número de processos filhos, cada um com uma fatia disjunta dos chunks.
+   AffinityPolicy affinity;          // Política de fixação das threads e dos processos filhos.
+   int *affinityList;                // CPUs da política AFFINITY_LIST.
+   unsigned int affinityListSize;
+   unsigned int coordinatorPort;     // Porta TCP do coordenador do modo distribuído (0 desliga o modo).
+   const char *coordinatorAddress;   // HOST:PORTA do coordenador quando este processo é um worker (NULL desliga o modo).
+   const char *checkpointFile;       // Arquivo de checkpoint das somas dos chunks (NULL desliga o checkpoint).
+   int resume;                       // TRUE para reaproveitar os chunks já somados em checkpointFile.
+   struct Checkpoint *checkpoint;    // Checkpoint aberto por pi() antes de criar os processos filhos (NULL sem checkpoint).
+   const char *cacheDirectory;       // Diretório do cache das somas dos chunks entre execuções (NULL desliga o cache).
+   struct ChunkCache *cache;         // Cache aberto por pi() antes de criar os processos filhos (NULL sem cache).
+   int hardwareCounters;             // TRUE para ler os contadores de hardware de cada thread com perf_event_open.
+   const char *metricsFile;          // Arquivo CSV das métricas por thread (NULL desliga a exportação).
+   const char *reportFile;           // Arquivo do relatório estruturado (NULL desliga o relatório).
+   ReportFormat reportFormat;        // Formato do relatório estruturado.
+   int streaming;                    // TRUE para o modo de convergência incremental.
+   struct Stream *stream;            // Estado do modo incremental criado por pi() antes dos processos filhos (NULL fora do modo).
+   double deadline;                  // Prazo do cálculo em segundos (0 sem prazo).
+   double deadlineAt;                // Instante do prazo no DURATION_CLOCK, fixado por pi() antes dos processos filhos (0 sem prazo).
+   ProgressCallback progress;        // Callback de progresso de sumSeries (NULL sem callback).
+   void *progressContext;            // Contexto passado ao callback de progresso.
+   int *cancel;                      // Pedido de cancelamento deste cálculo (TRUE cancela), lido por sumSeries (NULL sem pedido).
+   CompensatedSum *chunkSums;        // Se não for NULL, sumSeries grava em chunkSums[c] a soma de cada chunk c reduzido.
+   const char *daemonSocket;         // Socket Unix do modo de serviço (NULL desliga o modo).
+} Config;
+
+// Resultado numérico de um processo filho no segmento compartilhado, em linhas de cache próprias.
+typedef struct {
+   CompensatedSum sum;             // Soma parcial da fatia.
+   TermRange terms;                // Intervalo de termos somado.
+   struct timeval start, end;      // Instantes de início e fim exibidos no relatório.
+   double duration;                // Duração medida com DURATION_CLOCK, em segundos.
+   pid_t pid;
+   unsigned int numberOfThreads;
+   unsigned long long completedTerms; // Termos dos chunks efetivamente reduzidos (menos que terms.count se cancelado).
+   CompensatedSum prefix;          // Soma do prefixo contíguo de chunks reduzidos desde o início da fatia.
+   unsigned long long prefixTerms; // Termos desse prefixo (igual a terms.count se o processo não foi cancelado).
+   CancelReason cancelled;         // Motivo do cancelamento do processo, ou CANCEL_NONE.
+   int published;                  // TRUE depois que o resultado foi publicado; é escrito por último.
+} __attribute__((aligned(CACHE_LINE_SIZE))) SharedProcess;
+
+// Cabeçalho do segmento de memória compartilhada dos resultados, seguido dos 'numberOfProcesses' SharedProcess
+// e, para cada processo, de um bloco de 'threadBlockSize' bytes com os seus 'numberOfThreads' Thread.
+typedef struct {
+   unsigned int completed __attribute__((aligned(CACHE_LINE_SIZE))); // Palavra do futex: processos que já publicaram.
+   unsigned int numberOfProcesses, numberOfThreads;
+   size_t threadBlockSize;
+   size_t size;                    // Tamanho total do segmento.
+} SharedResults;
+
+// Soma de um chunk publicada no modo de convergência incremental.
+typedef struct {
+   CompensatedSum sum;
+   int done;                       // TRUE depois que a soma foi publicada; é escrito por último.
+} StreamChunk;
+
+// Estado do modo de convergência incremental, mapeado com MAP_SHARED antes dos fork(). Os workers de todos os processos
+// retiram os chunks em ordem crescente de 'next' e publicam as suas somas; o pai reduz o prefixo contíguo já publicado.
+typedef struct Stream {
+   unsigned long long next __attribute__((aligned(CACHE_LINE_SIZE))); // Próximo chunk a somar.
+   int stop __attribute__((aligned(CACHE_LINE_SIZE)));                // TRUE quando as casas pedidas estão garantidas.
+   unsigned long long numberOfChunks;
+   size_t size;                    // Tamanho do mapeamento.
+   // Campos usados apenas pelo pai.
+   unsigned long long prefix;      // Chunks iniciais já reduzidos.
+   Accumulator accumulator;        // Soma do prefixo.
+   double bound;                   // Limitante do erro da estimativa do prefixo.
+   struct timespec lastReport;     // Instante da última estimativa parcial escrita.
+   unsigned long long reported;    // Prefixo da última estimativa parcial escrita.
+   StreamChunk chunks[];
+} Stream;
 
 /* Cria o relatório do programa escrevendo na tela as informações da estrutura Report.
- * Retorna TRUE se o relatório foi escrito com sucesso ou FALSE se os dados da estrutura Report são vazios ou nulos.
+ * O texto é montado em um buffer pré-alocado e enviado em um único write(), sem intercalar com a saída de outros processos.
+ * Retorna TRUE se o relatório foi escrito com sucesso ou FALSE se os dados da estrutura Report são vazios ou nulos ou a escrita falhou.
 */
 int createReport(const Report *report);
 
-/* Cria o arquivo texto no diretório atual usando o nome do arquivo, a descrição e os dados do vetor do tipo Threads.
+/* Cria o arquivo texto no diretório atual usando o nome do arquivo, a descrição e os dados do vetor de threads
+ * com 'numberOfThreads' elementos.
  * Retorna TRUE se o arquivo foi criado com sucesso ou FALSE se ocorreu algum erro.
  */
-int createFile(const FileName fileName, String description, const Threads threads);
+int createFile(const FileName fileName, String description, const Thread *threads, unsigned int numberOfThreads);
+
+/* Cria um worker do pool descrito em 'task', fixado na CPU pool->threads[índice].cpu (livre se CPU_NOT_PINNED), e grava
+   a identificação da thread em 'threadID'. O worker executa a função poolWorker e a tarefa deve permanecer válida até o
+   término da thread.
+   Retorna TRUE se a thread foi criada ou FALSE, com errno indicando a causa, caso contrário.
+*/
+int createThread(ThreadTask *task, pthread_t *threadID);
+
+/* Laço de um worker do pool: espera um trabalho, executa-o com o seu índice e slot de resultado e avisa quando termina,
+   até que o pool seja destruído.
+*/
+void* poolWorker(void *task);
+
+/* Cria um pool com 'numberOfWorkers' workers persistentes e os seus slots (fila e resultado) pré-alocados em um único vetor
+   alinhado à linha de cache. O worker i é fixado na CPU cpus[i]; com 'cpus' NULL, os workers ficam livres.
+   Retorna o pool ou NULL, com errno indicando a causa, se a alocação ou a criação das threads falhar; nesse caso, os
+   workers já criados são encerrados.
+*/
+ThreadPool* createThreadPool(unsigned int numberOfWorkers, const int *cpus);
+
+/* Submete o trabalho 'job' com o argumento 'argument' a todos os workers do pool, esperando antes o término do trabalho anterior. */
+void threadPoolSubmit(ThreadPool *pool, PoolJob job, void *argument);
+
+/* Espera até que todos os workers do pool terminem o trabalho submetido. */
+void threadPoolWait(ThreadPool *pool);
+
+/* Encerra os workers do pool, espera o seu término e libera os seus recursos. */
+void destroyThreadPool(ThreadPool *pool);
+
+/* Converte a lista de CPUs 'text' (por exemplo, 0-3,8,10-11) em até 'maximum' CPUs em 'cpus'.
+   Retorna o número de CPUs da lista ou 0 se a lista é inválida.
+*/
+unsigned int parseCpuList(const char *text, int *cpus, unsigned int maximum);
+
+/* Preenche 'cpus' (com espaço para CPU_SETSIZE entradas) com o nó NUMA, o pacote, o núcleo e a ordem SMT de cada CPU
+   que o processo pode usar, lidos do sysfs. Sem informação de topologia, cada CPU é um núcleo do nó e do pacote 0.
+   Retorna o número de CPUs.
+*/
+unsigned int detectTopology(CpuInfo *cpus);
+
+/* Calcula as CPUs das config->numberOfThreads threads do processo 'process' (de 0 a numberOfProcesses - 1)
+   segundo a política config->affinity. Na política compact, scatter e list, os processos ocupam posições consecutivas
+   da ordem das CPUs; na política numa, o processo fica no nó (process % nós).
+   Retorna um vetor alocado com a CPU de cada thread, que deve ser liberado, ou NULL na política AFFINITY_NONE ou se
+   faltar memória (com errno ENOMEM).
+*/
+int* createPlacement(const Config *config, unsigned int numberOfProcesses, unsigned int process);
+
+/* Restringe o processo atual às CPUs 'cpus' de 'count' threads e, na política numa, a todas as CPUs do nó dessas threads,
+   para que a thread principal e as alocações do processo fiquem junto das suas threads. A falha é ignorada.
+*/
+void bindProcess(const Config *config, const int *cpus, unsigned int count);
+
+/* Retorna o nome da política de afinidade 'policy'. */
+const char* affinityName(AffinityPolicy policy);
+
+/* Realiza a soma parcial dos chunks da série de Leibniz da fila do worker 'worker' usando o kernel do escalonador 'argument' (um Scheduler).
+   A fila começa com uma fatia contígua de chunks, por exemplo, com 2.000.000.000 de termos, chunks de 1.000.000 de termos
+   e 16 threads, a thread 0 começa com os chunks 0 até 124, que cobrem os termos de 0 até 124.999.999, e assim por diante.
+   Quando a sua fila esvazia, a thread rouba a metade final da fila de outra thread até que todas estejam vazias.
+
+   O resultado dessa soma parcial é gravado em 'threadResult', o slot do worker no pool.
+*/
+void sumPartial(void *argument, unsigned int worker, ThreadResult *threadResult);
+
+/* Retira o primeiro chunk da fila 'queue' e o armazena em 'chunk'.
+   Retorna TRUE se um chunk foi retirado ou FALSE se a fila está vazia.
+*/
+int popChunk(WorkQueue *queue, unsigned long long *chunk);
+
+/* Rouba a metade final da fila de outra thread e a coloca na fila da thread 'thief', que deve estar vazia.
+   As vítimas são examinadas a partir da thread seguinte à ladra.
+   Retorna TRUE se algum trabalho foi roubado ou FALSE se todas as filas estão vazias.
+*/
+int stealChunks(Scheduler *scheduler, unsigned int thief);
+
+/* Kernel de referência: soma os termos [start, start + count) da série de Leibniz um a um. */
+double leibnizScalar(unsigned long long start, unsigned long long count);
+
+/* Kernels vetoriais: somam os termos [start, start + count) da série de Leibniz sem desvios condicionais, com
+   KERNEL_ACCUMULATORS acumuladores independentes. Cada lane soma um par de termos positivo/negativo 1/d - 1/(d + 2)
+   fundido em 2/(d (d + 2)), como os kernels escalares especializados: uma divisão a cada dois termos.
+   Os termos que não completam um vetor são somados por leibnizScalar. Disponíveis apenas em x86.
+*/
+double leibnizSse2(unsigned long long start, unsigned long long count);
+double leibnizAvx2(unsigned long long start, unsigned long long count);
+double leibnizAvx512(unsigned long long start, unsigned long long count);
+
+/* Kernels sem divisão (kernel newton): como os kernels vetoriais, mas o recíproco de cada denominador d (d + 2) vem da
+   aproximação de hardware (rcp14 em AVX-512, rcp_ps em precisão simples em AVX2) refinada por iterações de Newton com FMA,
+   r = r + r (1 - d r), trocando a divisão, de vazão baixa, por multiplicações e somas. O recíproco fica a cerca de 1 ulp
+   do exato. Os termos que não completam um vetor são somados por leibnizScalar. Disponíveis apenas em x86.
+*/
+double leibnizNewtonAvx2(unsigned long long start, unsigned long long count);
+double leibnizNewtonAvx512(unsigned long long start, unsigned long long count);
+
+/* Retorna TRUE se a CPU suporta o kernel 'kernel' ou FALSE caso contrário. */
+int kernelSupported(KernelType kernel);
+
+/* Resolve KERNEL_AUTO para o melhor kernel suportado pela CPU (verificado via CPUID) e retorna a função do kernel.
+   KERNEL_AUTO escolhe apenas entre os kernels com divisão exata; o kernel newton usa a variante AVX-512 quando a CPU a suporta.
+   Retorna NULL se o kernel pedido não é suportado pela CPU.
+*/
+SeriesKernel selectKernel(KernelType *kernel);
+
+/* Retorna o nome do kernel 'kernel' (por exemplo, "avx2"). */
+const char* kernelName(KernelType kernel);
+
+/* Kernels das séries de convergência rápida: somam os termos [start, start + count) das séries de Machin
+   (arctan), BBP e Chudnovsky em double. Os termos que ficam abaixo do menor double são descartados.
+*/
+double machinTerms(unsigned long long start, unsigned long long count);
+double bbpTerms(unsigned long long start, unsigned long long count);
+double chudnovskyTerms(unsigned long long start, unsigned long long count);
+
+/* Retorna o backend da série 'series', que não pode ser SERIES_AUTO. */
+const Series* getSeries(SeriesType series);
+
+/* Retorna a série de menor custo estimado (termos necessários x custo por termo) para 'digits' casas decimais. */
+SeriesType cheapestSeries(unsigned int digits);
+
+/* Retorna o kernel usado pelo escalonador para a série e o kernel de 'config': os kernels vetoriais para Leibniz
+   ou o kernel escalar da série nos demais casos.
+*/
+SeriesKernel selectSeriesKernel(const Config *config);
+
+/* Retorna o nome da série 'series' (por exemplo, "machin"). */
+const char* seriesName(SeriesType series);
+
+/* Kernels escalares compensados: somam os termos [start, start + count) da série de Leibniz com
+   compensação a cada termo, em Kahan-Neumaier e em double-double, respectivamente.
+*/
+CompensatedSum leibnizNeumaier(unsigned long long start, unsigned long long count);
+CompensatedSum leibnizDoubleDouble(unsigned long long start, unsigned long long count);
+
+/* Soma os termos [start, start + count) da série de Leibniz com o kernel 'kernel' e a estratégia 'mode'.
+   O kernel escalar compensa cada termo; os kernels vetoriais somam blocos de SUMMATION_BLOCK termos e
+   compensam (ou combinam par a par) as somas dos blocos.
+*/
+CompensatedSum sumTerms(SeriesKernel kernel, SummationMode mode, unsigned long long start, unsigned long long count);
+
+/* Kernels escalares especializados da série de Leibniz, gerados por DEFINE_LEIBNIZ_SPECIALIZATION com a estratégia de soma,
+   o comprimento do chunk, o desdobramento e o número de acumuladores fixos em tempo de compilação. Somam pares de termos
+   (1/d - 1/(d + 2) = 2 / (d (d + 2))) sem módulo nem desvio no laço. Os de comprimento fixo ignoram 'count', somam
+   exatamente o comprimento da especialização e exigem 'start' par.
+*/
+CompensatedSum leibnizNaiveAny(unsigned long long start, unsigned long long count);
+CompensatedSum leibnizNaiveLarge(unsigned long long start, unsigned long long count);
+CompensatedSum leibnizNaiveSmall(unsigned long long start, unsigned long long count);
+CompensatedSum leibnizNeumaierAny(unsigned long long start, unsigned long long count);
+CompensatedSum leibnizNeumaierLarge(unsigned long long start, unsigned long long count);
+CompensatedSum leibnizNeumaierSmall(unsigned long long start, unsigned long long count);
+CompensatedSum leibnizDoubleDoubleAny(unsigned long long start, unsigned long long count);
+CompensatedSum leibnizDoubleDoubleLarge(unsigned long long start, unsigned long long count);
+CompensatedSum leibnizDoubleDoubleSmall(unsigned long long start, unsigned long long count);
+
+/* Retorna o kernel especializado para a série, o kernel e a estratégia de soma de 'config' e chunks de 'length' termos
+   (0 para qualquer comprimento), ou NULL se não há especialização: só o kernel escalar da série de Leibniz com as somas
+   ingênua, Kahan-Neumaier e double-double é especializado, e só para os comprimentos SPECIALIZED_LENGTH_*.
+*/
+CompensatedKernel selectSpecializedKernel(const Config *config, unsigned long long length);
+
+/* Inicializa 'accumulator' vazio com a estratégia 'mode'. */
+void accumulatorInit(Accumulator *accumulator, SummationMode mode);
+
+/* Acrescenta 'value' (valor e correção) ao acumulador segundo a sua estratégia. */
+void accumulatorAdd(Accumulator *accumulator, CompensatedSum value);
+
+/* Retorna a soma acumulada, com a correção separada do valor principal. */
+CompensatedSum accumulatorResult(const Accumulator *accumulator);
+
+/* Retorna o nome da estratégia de soma 'mode' (por exemplo, "neumaier"). */
+const char* summationName(SummationMode mode);
+
+/* Divide 'numberOfTerms' termos em 'numberOfParts' intervalos contíguos e preenche 'range' com o intervalo de índice 'index'.
+   Os primeiros (numberOfTerms % numberOfParts) intervalos recebem um termo a mais, de modo que todos os termos são cobertos.
+*/
+void partitionTerms(unsigned long long numberOfTerms, unsigned int numberOfParts, unsigned int index, TermRange *range);
+
+/* Retorna o número de chunks de config->chunkSize termos que cobrem os config->numberOfTerms termos. */
+unsigned long long countChunks(const Config *config);
+
+/* Soma os termos dos chunks [chunks.start, chunks.start + chunks.count) da série config->series submetendo sumPartial
+   a todos os workers do pool 'pool' e reduz, com a estratégia config->summation, a soma de cada chunk na ordem em que os
+   workers a publicam na fila de conclusões, sem esperar pelo mais lento. Enquanto espera, chama config->progress a cada
+   PROGRESS_INTERVAL segundos e cancela o cálculo quando o callback retorna FALSE, quando config->deadlineAt passa ou
+   quando cancelCalculation() é chamada ou *config->cancel é TRUE; os workers param antes do próximo chunk. Se 'progress' não for NULL, recebe
+   os termos e chunks reduzidos, o motivo do cancelamento e o prefixo contíguo de chunks reduzidos desde chunks.start, o único
+   que forma uma soma parcial da série quando o cálculo é cancelado. Se config->chunkSums não for NULL, a soma de cada chunk
+   reduzido também é gravada nele, na posição do chunk.
+   Retorna a soma dos chunks reduzidos com a sua correção.
+*/
+CompensatedSum sumSeries(const Config *config, ThreadPool *pool, TermRange chunks, Progress *progress);
+
+/* Aplica a aceleração 'mode' à soma 'series' dos primeiros 'numberOfTerms' termos da série de Leibniz.
+   - ACCELERATION_TAIL soma a correção assintótica da cauda, pi - 4 S(N) ~ (-1)^N 2 sum(E(2m) / (2N)^(2m+1)),
+     onde E(2m) são os números de Euler, parando quando os termos assintóticos deixam de diminuir.
+   - ACCELERATION_EULER reconstrói as últimas ACCELERATION_DEPTH somas parciais e as combina com médias repetidas
+     (transformação de Euler na forma de Van Wijngaarden).
+   Retorna a estimativa de pi.
+*/
+double accelerateSeries(CompensatedSum series, unsigned long long numberOfTerms, AccelerationMode mode);
+
+/* Retorna o nome do modo de aceleração 'mode' (por exemplo, "tail"). */
+const char* accelerationName(AccelerationMode mode);
+
+/* Mede, para cada estratégia de soma, o tempo, a vazão em termos por segundo e o erro de arredondamento
+   em relação à soma double-double, usando os termos, threads e kernel de 'config'. Escreve a tabela na saída padrão.
+*/
+void benchmarkSummation(const Config *config);
+
+/* Trabalho do benchmark de layout: soma a fatia de termos de Leibniz do worker 'worker' gravando a soma no local
+   determinado pelo layout do argumento 'argument' (um LayoutBenchmark); o resultado fica em 'result'.
+*/
+void layoutWorker(void *argument, unsigned int worker, ThreadResult *result);
+
+/* Mede o tempo, a vazão e o speedup em relação a uma thread de cada layout de resultados por worker, com 1, 2, 4, ...
+   até config->numberOfThreads threads e config->numberOfTerms termos. Escreve a tabela na saída padrão.
+*/
+void benchmarkLayout(const Config *config);
+
+/* Retorna o nome do layout 'mode'. */
+const char* layoutName(LayoutMode mode);
+
+/* Soma a fatia 'chunks' da série config->series submetendo a soma parcial a todos os workers do pool 'pool'
+   e copia a identificação e os tempos das threads para 'threads'. Se 'progress' não for NULL, recebe o progresso final
+   de sumSeries (termos reduzidos e motivo do cancelamento).
+   Retorna a soma parcial da fatia com a sua correção.
+*/
+CompensatedSum calculationOfNumberPi(const Config *config, ThreadPool *pool, TermRange chunks, Thread *threads, Progress *progress);
+
+/* Pede o cancelamento de todos os cálculos em andamento no processo; cada um para antes do próximo chunk e reporta
+   o que já somou. Pode ser chamada de um tratador de sinal.
+*/
+void cancelCalculation();
+
+/* Tratador do SIGINT: cancela o cálculo com cancelCalculation() e restaura a ação padrão, de modo que um segundo
+   SIGINT encerra o programa.
+*/
+void handleInterrupt(int signalNumber);
+
+/* Tratador do SIGINT nos processos filhos: apenas cancela o cálculo com cancelCalculation(). O sinal pode chegar duas vezes,
+   do terminal e repassado pelo pai, e o segundo não pode encerrar o filho antes de ele publicar o que somou.
+*/
+void handleChildInterrupt(int signalNumber);
+
+/* Callback de progresso da opção --progress: escreve o progresso do processo filho cujo número está em 'context'.
+   Retorna TRUE (nunca cancela o cálculo).
+*/
+int printProgress(const Progress *progress, void *context);
+
+/* Retorna o instante atual do DURATION_CLOCK em segundos. */
+double monotonicSeconds();
+
+/* Calcula pi a partir da soma 'series' dos config->numberOfTerms termos, aplicando a aceleração config->acceleration
+   (apenas Leibniz).
+   Retorna as estimativas com e sem aceleração e o número de termos avaliados.
+*/
+PiResult seriesResult(const Config *config, CompensatedSum series);
+
+/* Cria e mapeia o segmento de memória compartilhada dos resultados de 'numberOfProcesses' processos com 'numberOfThreads'
+   threads cada. O nome é removido logo após o mapeamento, de modo que o segmento desaparece com o último processo.
+   Em caso de falha, imprime uma mensagem de erro e encerra o programa.
+*/
+SharedResults* createSharedResults(unsigned int numberOfProcesses, unsigned int numberOfThreads);
+
+/* Desfaz o mapeamento do segmento 'shared'. */
+void destroySharedResults(SharedResults *shared);
+
+/* Retorna o resultado do processo de índice 'index' (0 para pi1) no segmento 'shared'. */
+SharedProcess* sharedProcess(SharedResults *shared, unsigned int index);
+
+/* Retorna as threads do processo de índice 'index' (0 para pi1) no segmento 'shared'. */
+Thread* sharedThreads(SharedResults *shared, unsigned int index);
+
+/* Publica o resultado do processo de índice 'index': marca-o como publicado, incrementa o contador de processos concluídos
+   e acorda o pai que espera no futex desse contador. O resultado deve estar completo antes da chamada.
+*/
+void publishResult(SharedResults *shared, unsigned int index);
+
+/* Espera no futex do contador de processos concluídos enquanto ele vale 'completed', por até 'interval' milissegundos.
+   Retorna FALSE se o tempo acabou sem mudança ou TRUE caso contrário.
+*/
+int waitForResults(SharedResults *shared, unsigned int completed, unsigned int interval);
+
+/* Cria o estado compartilhado do modo de convergência incremental para os chunks de 'config'.
+   Em caso de falha, imprime uma mensagem de erro e encerra o programa.
+*/
+Stream* createStream(const Config *config);
 
-/* Cria uma thread para fazer a soma parcial de n termos da série de Leibniz. 
-   Esta função deve usar a função sumPartial para definir qual a função a ser executada por cada uma das x threads 
-   do programa, onde x é igual a NUMBER_OF_THREADS. 
-   Retorna a identificação da thread.
+/* Desfaz o mapeamento do estado 'stream'. */
+void destroyStream(Stream *stream);
+
+/* Retira de 'stream' o próximo chunk, em ordem crescente, e o armazena em 'chunk'.
+   Retorna FALSE se os chunks acabaram ou se as casas pedidas já estão garantidas, ou TRUE caso contrário.
 */
-pthread_t createThread(unsigned int *terms); 
+int takeStreamChunk(Stream *stream, unsigned long long *chunk);
+
+/* Publica em 'stream' a soma 'sum' do chunk 'chunk'. */
+void publishStreamChunk(Stream *stream, unsigned long long chunk, CompensatedSum sum);
 
-/* Realiza a soma parcial de n (n é definido por PARTIAL_NUMBER_OF_TERMS) termos da série de Leibniz
-   começando em x, por exemplo, como PARTIAL_NUMBER_OF_TERMS é 125.000.000, então se x é:
+/* Retorna os termos cobertos pelo prefixo já reduzido de 'stream'. */
+unsigned long long streamTerms(const Stream *stream, const Config *config);
 
-             0 -> calcula a soma parcial de 0 até 124.999.999;
-   125.000.000 -> calcula a soma parcial de 125.000.000 até 249.999.999;
-   250.000.000 -> calcula a soma parcial de 250.000.000 até 374.999.999; 
-       
-   e assim por diante. 
+/* Reduz os chunks publicados que estendem o prefixo contíguo de 'stream', escreve a estimativa parcial com o limitante
+   do erro (no máximo uma a cada STREAM_REPORT_INTERVAL segundos, ou sempre que o prefixo mudou se 'force') e, quando o limitante garante
+   config->digits casas, pede aos workers que parem.
+   Retorna TRUE se as casas pedidas estão garantidas ou FALSE caso contrário.
+*/
+int advanceStream(Stream *stream, const Config *config, int force);
 
-   O resultado dessa soma parcial deve ser um valor do tipo double a ser retornado 
-   por esta função para o processo que criou a thread.
+/* Retorna a margem do arredondamento após 'terms' termos da série 'series' somados com uma estratégia compensada:
+   STREAM_ROUNDING_ERROR mais o erro das somas sem compensação por que passa cada termo (um bloco de SUMMATION_BLOCK termos
+   dos kernels vetoriais e os níveis da soma par a par) sobre a soma dos |termos|, que cresce com N na série de Leibniz.
 */
-void* sumPartial(void *terms);
+double streamRoundingError(SeriesType series, unsigned long long terms);
 
-/* Calcula o número pi com n (n é definido por DECIMAL_PLACES) casas decimais usando o número máximo de
-   termos da série de Leibniz, que é definido por MAXIMUM_NUMBER_OF_TERMS. Esta função deve criar x threads
-   usando a função createThread, onde x é igual a NUMBER_OF_THREADS. 
+/* Retorna o menor número de termos da série 'series' cujo limitante do erro, com a margem de streamRoundingError(),
+   fica abaixo de meia unidade da casa decimal 'digits', ou 0 se a margem o impede.
 */
-double calculationOfNumberPi(unsigned int terms);
+unsigned long long termsForBound(SeriesType series, unsigned int digits);
+
+/* Reduz, com a estratégia config->summation e na ordem de chegada, as somas parciais publicadas em 'shared' pelos processos
+   'children', acumulando cada uma assim que é publicada, e espera o término de todos os filhos. A soma total fica em 'total'.
+   Se o cálculo do pai é cancelado (SIGINT), repassa o SIGINT aos filhos que ainda não publicaram.
+   Retorna TRUE se todos os filhos publicaram o seu resultado ou FALSE se algum terminou sem publicar ou falhou.
+*/
+int collectResults(SharedResults *shared, const pid_t *children, const Config *config, CompensatedSum *total);
+
+/* Retorna o número de CPUs online, que é o número padrão de threads de cada processo filho. */
+unsigned int detectNumberOfThreads();
+
+/* Preenche 'config' a partir das variáveis de ambiente (PI_THREADS, PI_TERMS, ...) e da linha de comando,
+   que tem precedência sobre as variáveis de ambiente. Sem número de termos explícito, usa os termos necessários
+   para config->digits casas decimais na série escolhida (2.000.000.000 na série de Leibniz com 9 casas).
+   Retorna TRUE se a configuração é válida ou FALSE caso contrário.
+*/
+int parseConfig(int argc, char *argv[], Config *config);
 
 /*
- * Esta função inicia o programa.
- * Retorna EXIT_SUCCESS.
+ * Esta função inicia o programa com os argumentos da linha de comando.
+ * Retorna EXIT_SUCCESS ou EXIT_FAILURE se os argumentos são inválidos.
+ * É, com a API de engine.h, o único símbolo exportado pela biblioteca compilada com -fvisibility=hidden.
  */
-int pi();
+__attribute__((visibility("default"))) int pi(int argc, char *argv[]);
 
-/* A função 'process' é responsável por coordenar a execução de múltiplos processos e a criação de um pipe para comunicação entre eles.
-   Ela segue a lógica de criação de dois processos filho.
+/* A função 'process' é responsável por coordenar a execução dos config->numberOfProcesses processos filhos.
 
    - Cria uma estrutura 'Report' para armazenar informações.
    - Chama 'fillReportProcessFather' para preencher a estrutura 'Report'.
-   - Cria um pipe usando 'createPipe' para permitir a comunicação entre os processos filhos.
-   - Cria dois processos filhos usando 'createProcess'.
-   - No primeiro filho, fecha o descritor de leitura do pipe e executa 'processChild' com a identificação 'PROCESS_ONE' e a estrutura 'Report'.
-   - No segundo filho, fecha o descritor de escrita do pipe e executa 'processChild' com a identificação 'PROCESS_TWO' e a estrutura 'Report'.
-   - No processo pai, fecha ambos os descritores do pipe e sai com EXIT_SUCCESS.
+   - Cria o segmento de memória compartilhada dos resultados com 'createSharedResults'.
+   - Cria cada processo filho com 'createProcess'; o filho executa 'processChild' com a sua identificação
+     (PROCESS_ONE, PROCESS_ONE + 1, ...) e publica o seu resultado no segmento.
+   - O pai reduz as somas parciais à medida que são publicadas com 'collectResults', grava o arquivo de tempos
+     de cada processo e escreve o relatório com 'createReport'.
+   Retorna TRUE se todos os filhos enviaram o seu resultado ou FALSE caso contrário.
 */
-void process();
+int process(const Config *config);
 
 /* A função 'fillReportProcessFather' é responsável por preencher a estrutura 'Report' com informações específicas,
-   como o nome do programa, mensagens e o PID do processo atual.
+   como o nome do programa, mensagens, o PID do processo atual e a configuração comum a todos os processos filhos.
 
    Parâmetros:
    - report: Ponteiro para a estrutura 'Report' a ser preenchida.
+   - config: Configuração de execução (processos, threads, série, kernel, soma e aceleração).
 
    Essa função é utilizada para inicializar a estrutura 'Report' com informações relevantes antes de usá-la em outras partes do programa.
 */
-void fillReportProcessFather(Report* report);
+void fillReportProcessFather(Report* report, const Config *config);
+
+/* Preenche o resultado combinado de 'report' com a duração total 'duration' medida pelo pai e as estimativas 'result'
+   com config->digits casas decimais.
+*/
+void fillReportTotal(Report* report, double duration, PiResult result, const Config *config);
 
 
 /* A função 'createProcess' é responsável por criar um novo processo filho utilizando a função 'fork'.
@@ -203,43 +1130,29 @@ void fillReportProcessFather(Report* report);
 pid_t createProcess();
 
 
-/* A função 'createPipe' é responsável por criar um pipe (tubo de comunicação) utilizando a função 'pipe'.
-   O pipe permite a comunicação entre processos, fornecendo um meio de transferência de dados entre eles.
-
-   Parâmetros:
-   - pipe_fd: Array de inteiros de tamanho 2 para armazenar os descritores de arquivo do pipe.
-
-   A função utiliza a função 'pipe' para criar o pipe e atribui os descritores de arquivo resultantes ao array 'pipe_fd'.
-   Em caso de falha na criação do pipe, a função imprime uma mensagem de erro e encerra o programa com falha.
-*/
-int createPipe(int pipe_fd[2]);
-
 /* A função 'processChild' é responsável por realizar tarefas específicas em um processo filho, identificado pelo parâmetro 'numberProcess'.
-   Ela realiza o cálculo do valor de π e preenche um relatório de processo.
+   Ela soma a sua fatia de chunks da série e publica o resultado numérico no segmento compartilhado.
 
    Parâmetros:
-   - numberProcess: Um valor que identifica o processo (PROCESS_ONE ou PROCESS_TWO).
-   - pipe_fd: Um array de inteiros que representa o pipe para comunicação.
-   - report: Ponteiro para a estrutura 'Report' que armazena informações do processo.
-
-   A função calcula o valor de π usando 'calculationOfNumberPi' e mede o tempo de execução.
-   Em seguida, preenche um relatório de processo 'ProcessReport' com os resultados e as informações de tempo.
+   - numberProcess: Um valor que identifica o processo (PROCESS_ONE, PROCESS_ONE + 1, ...).
+   - shared: Segmento de memória compartilhada dos resultados, herdado do pai.
+   - config: Configuração de execução (número de processos, de termos e de threads).
 
+   A fatia do processo são os chunks partitionTerms(countChunks(config), config->numberOfProcesses, numberProcess - PROCESS_ONE).
+   A função soma a fatia usando 'calculationOfNumberPi', que grava as threads diretamente no segmento, e mede o tempo de execução.
+   Em seguida, publica o resultado com 'publishResult' e encerra o processo.
 */
-void processChild(int numberProcess, int pipe_fd[2], Report* report);
+void processChild(int numberProcess, SharedResults *shared, const Config *config);
 
 /* A função 'fillProcessReportSun' é responsável por preencher uma estrutura 'ProcessReport' com informações específicas
-   sobre a execução de um processo filho, incluindo seu número, tempo de início, tempo de término, duração e valor de π calculado.
+   sobre a execução de um processo filho, incluindo seu número, tempo de início, tempo de término, duração, termos e soma parcial.
 
    Parâmetros:
    - processReport: Ponteiro para a estrutura 'ProcessReport' a ser preenchida.
-   - numberProcess: Número do processo (PROCESS_ONE ou PROCESS_TWO).
-   - startTimeStr: String formatada representando o tempo de início.
-   - endTimeStr: String formatada representando o tempo de término.
-   - duration: Tempo de execução em segundos.
-   - pi: Valor de π.
+   - numberProcess: Número do processo (PROCESS_ONE, PROCESS_ONE + 1, ...).
+   - result: Resultado numérico publicado pelo processo no segmento compartilhado.
 */
-void fillProcessReportSun(ProcessReport* processReport, int numberProcess, char* startTimeStr, char* endTimeStr, double duration, double pi);
+void fillProcessReportSun(ProcessReport* processReport, int numberProcess, const SharedProcess *result);
 
 /* A função 'fillThreadTidAndTime' é responsável por preencher uma estrutura de thread 'Thread' com o ID da thread (TID) e o tempo de execução,
    obtidos a partir da estrutura 'ThreadResult'.
@@ -250,32 +1163,11 @@ void fillProcessReportSun(ProcessReport* processReport, int numberProcess, char*
 */
 void fillThreadTidAndTime(ThreadResult threadResult, Thread* thread);
 
-/* A função 'replace' substitui todas as ocorrências do caractere 'replaced' pelo caractere 'replacer' em uma string.
-
-   Parâmetros:
-   - string: A string na qual as substituições serão feitas.
-   - replacer: O caractere que substituirá 'replaced'.
-   - replaced: O caractere que será substituído por 'replacer'.
-
-   A função itera através da string e, para cada caractere igual a 'replaced', substitui-o por 'replacer'.
-*/
-void replace(String string, char replacer, char replaced);
-
-/* A função 'replaceDotForComma' substitui todas as ocorrências do caractere ponto '.' pelo caractere vírgula ',' 
-   em várias partes da estrutura 'Report' que contém informações sobre processos.
-
-   Parâmetros:
-   - report: Um ponteiro para a estrutura 'Report' que contém informações a serem processadas.
-
-   A função utiliza a função 'replace' para realizar a substituição do ponto '.' pelo caractere vírgula ',' 
-   nas strings de duração e PI em duas 'ProcessReport' dentro da estrutura 'Report'.
-*/
-void replaceDotForComma(Report* report);
-
-/* A função 'calculateDuration' calcula a diferença de tempo entre duas estruturas 'struct timeval' e retorna a duração em segundos, incluindo a parte decimal representando milissegundos.
+/* A função 'calculateDuration' calcula a diferença de tempo entre duas estruturas 'struct timespec' lidas do mesmo relógio (DURATION_CLOCK
+   ou o de CPU da thread) e retorna a duração em segundos, incluindo a parte decimal com resolução de nanossegundos.
 
    Parâmetros:
-   - startTime: Estrutura 'struct timeval' representando o tempo de início.
-   - endTime: Estrutura 'struct timeval' representando o tempo de término.
+   - startTime: Estrutura 'struct timespec' representando o tempo de início.
+   - endTime: Estrutura 'struct timespec' representando o tempo de término.
 */
-double calculateDuration(struct timeval startTime, struct timeval endTime);
\ No newline at end of file
+double calculateDuration(struct timespec startTime, struct timespec endTime);
\ No newline at end of file
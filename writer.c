@@ -0,0 +1,452 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <math.h>
+#include <langinfo.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <wchar.h>
+#include "writer.h"
+
+// Localidade numérica dos relatórios em texto, criada uma única vez por initReportLocale().
+static pthread_once_t reportLocaleOnce = PTHREAD_ONCE_INIT;
+static locale_t reportNumeric;
+static int reportComma;  // TRUE se LOCALE não está instalada e o ponto decimal é trocado por REPORT_DECIMAL_POINT.
+
+/* Cria a localidade numérica LOCALE dos relatórios em texto ou, se ela não está instalada, a localidade WRITER_LOCALE,
+   cujos números de ponto flutuante recebem REPORT_DECIMAL_POINT na formatação.
+*/
+static void initReportLocale() {
+    reportNumeric = newlocale(LC_NUMERIC_MASK, LOCALE, (locale_t)0);
+    reportComma = FALSE;
+    if (reportNumeric == (locale_t)0) {
+        reportNumeric = newlocale(LC_NUMERIC_MASK, WRITER_LOCALE, (locale_t)0);
+        reportComma = TRUE;
+    }
+}//initReportLocale()
+
+/* Retorna a localidade numérica dos relatórios em texto, criada na primeira chamada. */
+static locale_t reportLocale() {
+    pthread_once(&reportLocaleOnce, initReportLocale);
+    return reportNumeric;
+}//reportLocale()
+
+/* Retorna o separador decimal dos relatórios em texto: o da localidade LOCALE, ou REPORT_DECIMAL_POINT se ela não está instalada. */
+char reportDecimalPoint() {
+    locale_t numeric = reportLocale();
+    return reportComma ? REPORT_DECIMAL_POINT : nl_langinfo_l(RADIXCHAR, numeric)[0];
+}//reportDecimalPoint()
+
+/* Acrescenta à especificação 'spec', com 'specLength' caracteres, o texto formatado de 'format'.
+   Retorna FALSE se a especificação não cabe em FORMAT_SPEC_SIZE bytes.
+*/
+static int appendSpec(char *spec, size_t *specLength, const char *format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    int written = vsnprintf(spec + *specLength, FORMAT_SPEC_SIZE - *specLength, format, arguments);
+    va_end(arguments);
+    if (written < 0 || (size_t)written >= FORMAT_SPEC_SIZE - *specLength) {
+        return FALSE;
+    }
+    *specLength += (size_t)written;
+    return TRUE;
+}//appendSpec()
+
+// Formata o próximo argumento de 'arguments', do tipo 'type', com a especificação 'spec' (sem '*').
+#define FORMAT_ARGUMENT(type) do { \
+        type value = va_arg(arguments, type); \
+        written = snprintf(out, room, spec, value); \
+    } while (0)
+
+/* Formata, como vsnprintf na localidade WRITER_LOCALE (já ativa na thread), o texto de 'format' em 'text', com no máximo
+   'size' bytes, e troca o ponto de cada conversão de ponto flutuante por REPORT_DECIMAL_POINT assim que ela é formatada;
+   o texto fixo e as strings não são alterados. Cada conversão é formatada separadamente, depois de consumir os seus
+   argumentos na ordem de vsnprintf: a largura e a precisão dadas por '*' entram na especificação como números.
+   A conversão %n consome o seu ponteiro, mas não o preenche.
+   Retorna o tamanho do texto completo, mesmo que ele não caiba em 'text', ou -1 se uma especificação é inválida.
+*/
+static int formatDecimalComma(char *text, size_t size, const char *format, va_list arguments) {
+    size_t length = 0;
+    int valid = TRUE;
+    while (*format != NULL_CHAR && valid) {
+        if (*format != '%' || format[1] == '%') {
+            if (length + 1 < size) {
+                text[length] = *format;
+            }
+            length++;
+            format += *format == '%' ? 2 : 1;
+            continue;
+        }
+
+        // Remonta a especificação, do '%' à conversão, com a largura e a precisão de '*' lidas dos argumentos.
+        char spec[FORMAT_SPEC_SIZE];
+        size_t specLength = 0;
+        spec[specLength++] = *format++;
+        while (*format != NULL_CHAR && strchr(FORMAT_FLAGS, *format) != NULL) {
+            // Flags repetidas não mudam a conversão; cada uma entra uma vez.
+            if (memchr(spec + 1, *format, specLength - 1) == NULL) {
+                spec[specLength++] = *format;
+            }
+            format++;
+        }
+        if (*format == '*') {
+            valid = appendSpec(spec, &specLength, "%d", va_arg(arguments, int));
+            format++;
+        }
+        else {
+            size_t digits = strspn(format, "0123456789");
+            valid = appendSpec(spec, &specLength, "%.*s", (int)digits, format);
+            format += digits;
+        }
+        if (*format == '.') {
+            format++;
+            if (*format == '*') {
+                // Uma precisão negativa vale como omitida.
+                int precision = va_arg(arguments, int);
+                valid = valid && (precision < 0 || appendSpec(spec, &specLength, ".%d", precision));
+                format++;
+            }
+            else {
+                size_t digits = strspn(format, "0123456789");
+                valid = valid && appendSpec(spec, &specLength, ".%.*s", (int)digits, format);
+                format += digits;
+            }
+        }
+        int longs = 0;
+        char modifier = NULL_CHAR;
+        while (*format != NULL_CHAR && strchr(FORMAT_MODIFIERS, *format) != NULL) {
+            if (*format == 'l') {
+                longs++;
+            }
+            else {
+                modifier = *format;
+            }
+            valid = valid && appendSpec(spec, &specLength, "%c", *format);
+            format++;
+        }
+        char conversion = *format;
+        if (conversion == NULL_CHAR || !valid || !appendSpec(spec, &specLength, "%c", conversion)) {
+            valid = FALSE;
+            break;
+        }
+        format++;
+
+        char *out = length < size ? text + length : NULL;
+        size_t room = length < size ? size - length : 0;
+        int written = 0;
+        switch (conversion) {
+            case 'd':
+            case 'i':
+                if (longs >= 2 || modifier == 'q') {
+                    FORMAT_ARGUMENT(long long);
+                }
+                else if (longs == 1) {
+                    FORMAT_ARGUMENT(long);
+                }
+                else if (modifier == 'z') {
+                    FORMAT_ARGUMENT(ssize_t);
+                }
+                else if (modifier == 'j') {
+                    FORMAT_ARGUMENT(intmax_t);
+                }
+                else if (modifier == 't') {
+                    FORMAT_ARGUMENT(ptrdiff_t);
+                }
+                else {
+                    FORMAT_ARGUMENT(int);
+                }
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                if (longs >= 2 || modifier == 'q') {
+                    FORMAT_ARGUMENT(unsigned long long);
+                }
+                else if (longs == 1) {
+                    FORMAT_ARGUMENT(unsigned long);
+                }
+                else if (modifier == 'z') {
+                    FORMAT_ARGUMENT(size_t);
+                }
+                else if (modifier == 'j') {
+                    FORMAT_ARGUMENT(uintmax_t);
+                }
+                else if (modifier == 't') {
+                    FORMAT_ARGUMENT(ptrdiff_t);
+                }
+                else {
+                    FORMAT_ARGUMENT(unsigned int);
+                }
+                break;
+            case 'c':
+                if (longs > 0) {
+                    FORMAT_ARGUMENT(wint_t);
+                }
+                else {
+                    FORMAT_ARGUMENT(int);
+                }
+                break;
+            case 's':
+                if (longs > 0) {
+                    FORMAT_ARGUMENT(const wchar_t *);
+                }
+                else {
+                    FORMAT_ARGUMENT(const char *);
+                }
+                break;
+            case 'p':
+                FORMAT_ARGUMENT(void *);
+                break;
+            case 'n':
+                (void)va_arg(arguments, void *);
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                if (modifier == 'L') {
+                    FORMAT_ARGUMENT(long double);
+                }
+                else {
+                    FORMAT_ARGUMENT(double);
+                }
+                // Na localidade WRITER_LOCALE, um número formatado tem no máximo um ponto: o decimal.
+                if (out != NULL && written > 0) {
+                    char *point = memchr(out, DOT, (size_t)written < room ? (size_t)written : room - 1);
+                    if (point != NULL) {
+                        *point = REPORT_DECIMAL_POINT;
+                    }
+                }
+                break;
+            default:
+                // Uma conversão desconhecida não tem argumento: a especificação sai como está, como em vsnprintf.
+                written = snprintf(out, room, "%s", spec);
+                break;
+        }
+        if (written > 0) {
+            length += (size_t)written;
+        }
+    }
+    if (size > 0) {
+        text[length < size ? length : size - 1] = NULL_CHAR;
+    }
+    return valid ? (int)length : -1;
+}//formatDecimalComma()
+
+#undef FORMAT_ARGUMENT
+
+/* Formata 'format' com 'arguments' em 'text', com no máximo 'size' bytes, na localidade 'numeric', trocando o ponto
+   dos números de ponto flutuante por REPORT_DECIMAL_POINT se 'decimalComma'.
+   Retorna o tamanho do texto completo, mesmo que ele não caiba em 'text'.
+*/
+static int formatNumbers(char *text, size_t size, locale_t numeric, int decimalComma, const char *format, va_list arguments) {
+    locale_t previous = uselocale(numeric);
+    int length = decimalComma ? formatDecimalComma(text, size, format, arguments) : vsnprintf(text, size, format, arguments);
+    uselocale(previous);
+    return length;
+}//formatNumbers()
+
+/* Formata, como snprintf, o texto de 'format' em 'text', com no máximo 'size' bytes, na localidade numérica dos relatórios
+   em texto, de modo que os números de ponto flutuante saem com o separador decimal de reportDecimalPoint().
+   Retorna o tamanho do texto completo, mesmo que ele não caiba em 'text'.
+*/
+int formatReport(char *text, size_t size, const char *format, ...) {
+    locale_t numeric = reportLocale();
+    va_list arguments;
+    va_start(arguments, format);
+    int length = formatNumbers(text, size, numeric, reportComma, format, arguments);
+    va_end(arguments);
+    return length;
+}//formatReport()
+
+/* Escreve os 'size' bytes de 'data' no arquivo de 'writer', marcando a falha se o write() não os aceitar. */
+static void writerOutput(Writer *writer, const char *data, size_t size) {
+    // Na saída padrão, o texto ainda no buffer do stdio sai antes, preservando a ordem das mensagens.
+    if (!writer->ownsDescriptor) {
+        fflush(stdout);
+    }
+    while (size > 0 && !writer->failed) {
+        ssize_t written = write(writer->fd, data, size);
+        if (written <= 0) {
+            perror(ERROR_WRITER);
+            writer->failed = TRUE;
+            break;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+}//writerOutput()
+
+/* Esvazia o buffer de 'writer' no arquivo. */
+static void writerFlush(Writer *writer) {
+    writerOutput(writer, writer->buffer, writer->length);
+    writer->length = 0;
+}//writerFlush()
+
+/* Cria o escritor do descritor 'fd' com um buffer de 'capacity' bytes e a localidade numérica 'numeric', que passa a ser dele;
+   se 'decimalComma', os números de ponto flutuante saem com REPORT_DECIMAL_POINT no lugar do ponto.
+   Em caso de falha de alocação, imprime uma mensagem de erro e encerra o programa.
+*/
+static Writer* createWriter(int fd, int ownsDescriptor, ReportFormat format, locale_t numeric, int decimalComma, size_t capacity) {
+    Writer *writer = (Writer *)malloc(sizeof(Writer) + capacity);
+    if (writer == NULL) {
+        perror(ERROR_MALLOC);
+        exit(EXIT_FAILURE);
+    }
+    writer->fd = fd;
+    writer->ownsDescriptor = ownsDescriptor;
+    writer->format = format;
+    writer->numeric = numeric;
+    writer->decimalComma = decimalComma;
+    writer->capacity = capacity;
+    writer->length = 0;
+    writer->failed = FALSE;
+    return writer;
+}//createWriter()
+
+/* Cria (ou trunca) o arquivo 'fileName' e retorna o seu escritor com registros no formato 'format',
+   ou NULL se ocorreu algum erro. No formato CSV, o cabeçalho 'header' (se não for NULL) é escrito primeiro.
+*/
+Writer* openWriter(const char *fileName, ReportFormat format, const char *header) {
+    int fd = open(fileName, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, WRITER_MODE);
+    if (fd < 0) {
+        perror(ERROR_WRITER);
+        return NULL;
+    }
+    Writer *writer = createWriter(fd, TRUE, format, newlocale(LC_NUMERIC_MASK, WRITER_LOCALE, (locale_t)0), FALSE, WRITER_BUFFER_SIZE);
+    if (format == REPORT_CSV && header != NULL) {
+        writerPrintf(writer, "%s", header);
+    }
+    return writer;
+}//openWriter()
+
+/* Cria (ou trunca) o arquivo 'fileName', ou usa a saída padrão se 'fileName' é NULL, e retorna o escritor de um relatório
+   em texto com um buffer de 'capacity' bytes, ou NULL se ocorreu algum erro. Um relatório que cabe no buffer é enviado em
+   um único write() no fechamento; os números de ponto flutuante saem com o separador decimal de reportDecimalPoint().
+*/
+Writer* openTextWriter(const char *fileName, size_t capacity) {
+    int fd = STDOUT_FILENO;
+    if (fileName != NULL) {
+        fd = open(fileName, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, WRITER_MODE);
+        if (fd < 0) {
+            perror(ERROR_WRITER);
+            return NULL;
+        }
+    }
+    locale_t numeric = duplocale(reportLocale());
+    return createWriter(fd, fileName != NULL, REPORT_JSON, numeric, reportComma, capacity);
+}//openTextWriter()
+
+/* Formata, como printf, o texto de 'format' no buffer de 'writer', esvaziando o buffer no arquivo quando ele enche. */
+void writerPrintf(Writer *writer, const char *format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    size_t available = writer->capacity - writer->length;
+    int length = formatNumbers(writer->buffer + writer->length, available, writer->numeric, writer->decimalComma, format, arguments);
+    va_end(arguments);
+    if (length >= 0 && (size_t)length >= available) {
+        // O texto não coube: esvazia o buffer e formata de novo no início dele, ou em um bloco próprio se nem assim couber.
+        writerFlush(writer);
+        va_start(arguments, format);
+        if ((size_t)length < writer->capacity) {
+            formatNumbers(writer->buffer, writer->capacity, writer->numeric, writer->decimalComma, format, arguments);
+        }
+        else {
+            char *text = (char *)malloc((size_t)length + 1);
+            if (text == NULL) {
+                perror(ERROR_MALLOC);
+                exit(EXIT_FAILURE);
+            }
+            formatNumbers(text, (size_t)length + 1, writer->numeric, writer->decimalComma, format, arguments);
+            writerOutput(writer, text, (size_t)length);
+            free(text);
+            length = 0;
+        }
+        va_end(arguments);
+    }
+    if (length > 0) {
+        writer->length += (size_t)length;
+    }
+}//writerPrintf()
+
+/* Esvazia o buffer de 'writer' no arquivo, fecha o arquivo (exceto a saída padrão) e libera o escritor.
+   Retorna TRUE se todo o texto foi escrito ou FALSE se ocorreu algum erro.
+*/
+int closeWriter(Writer *writer) {
+    writerFlush(writer);
+    int success = !writer->failed && (!writer->ownsDescriptor || close(writer->fd) == 0);
+    freelocale(writer->numeric);
+    free(writer);
+    return success;
+}//closeWriter()
+
+/* Retorna o instante 'time' em segundos desde a época. */
+static double epochSeconds(struct timeval time) {
+    return (double)time.tv_sec + (double)time.tv_usec / 1e6;
+}//epochSeconds()
+
+/* Retorna a vazão de 'terms' termos em 'duration' segundos (0 sem duração). */
+static double throughput(unsigned long long terms, double duration) {
+    return duration > 0.0 ? (double)terms / duration : 0.0;
+}//throughput()
+
+/* Escreve em 'writer' o registro da execução 'run' com a configuração 'config', 'numberOfProcesses' processos (ou workers) com
+   'numberOfThreads' threads ao todo, o resultado 'result', os instantes 'start' e 'end' e a duração 'duration' medida com DURATION_CLOCK.
+   No modo de convergência incremental, 'stream' traz o limitante do erro e se as casas foram garantidas ('reached'); fora dele, 'stream' é NULL.
+*/
+void writeRunRecord(Writer *writer, long long run, const Config *config, unsigned int numberOfProcesses, unsigned int numberOfThreads,
+                    PiResult result, struct timeval start, struct timeval end, double duration, const struct Stream *stream, int reached) {
+    if (writer->format == REPORT_CSV) {
+        writerPrintf(writer, CSV_RUN, run, (int)getpid(), numberOfThreads, epochSeconds(start),
+                     epochSeconds(end), duration, result.terms, throughput(result.terms, duration), result.pi, result.pi - M_PI);
+        return;
+    }
+    writerPrintf(writer, JSON_RUN, run, (int)getpid(), seriesName(config->series), kernelName(config->kernel),
+                 summationName(config->summation), accelerationName(config->acceleration), numberOfProcesses,
+                 numberOfThreads, epochSeconds(start), epochSeconds(end), duration, result.terms,
+                 throughput(result.terms, duration), result.pi, result.rawPi, result.pi - M_PI);
+    if (stream != NULL) {
+        writerPrintf(writer, JSON_BOUND, stream->bound, config->digits, reached ? JSON_TRUE : JSON_FALSE);
+    }
+    writerPrintf(writer, JSON_END);
+}//writeRunRecord()
+
+/* Escreve em 'writer' o registro do processo filho ou worker 'numberProcess' da execução 'run', com PID 'pid', 'numberOfThreads'
+   threads, os instantes 'start' e 'end', a duração 'duration', os termos 'terms' que somou e a sua soma parcial 'sum'.
+*/
+void writeProcessRecord(Writer *writer, long long run, int numberProcess, pid_t pid, unsigned int numberOfThreads,
+                        struct timeval start, struct timeval end, double duration, unsigned long long terms, double sum) {
+    writerPrintf(writer, writer->format == REPORT_CSV ? CSV_PROCESS : JSON_PROCESS, run, numberProcess, (int)pid, numberOfThreads,
+                 epochSeconds(start), epochSeconds(end), duration, terms, throughput(terms, duration), sum);
+}//writeProcessRecord()
+
+/* Escreve em 'writer' um registro por thread do vetor 'threads', com 'numberOfThreads' elementos, do processo 'numberProcess' da execução 'run'. */
+void writeThreadRecords(Writer *writer, long long run, int numberProcess, const Thread *threads, unsigned int numberOfThreads) {
+    for (unsigned int i = 0; i < numberOfThreads; i++) {
+        const Thread *thread = &threads[i];
+        if (writer->format == REPORT_CSV) {
+            writerPrintf(writer, CSV_THREAD, run, numberProcess, thread->tid, thread->started, thread->finished, thread->time,
+                         thread->cpuTime, thread->terms, throughput(thread->terms, thread->time));
+        }
+        else {
+            writerPrintf(writer, JSON_THREAD, run, numberProcess, thread->tid, thread->cpu, thread->started, thread->finished,
+                         thread->time, thread->cpuTime, thread->terms, throughput(thread->terms, thread->time), thread->chunks,
+                         thread->steals);
+        }
+    }
+}//writeThreadRecords()
+
+/* Retorna o identificador de execução derivado do instante 'start': microssegundos desde a época. */
+long long runIdentifier(struct timeval start) {
+    return (long long)start.tv_sec * 1000000LL + start.tv_usec;
+}//runIdentifier()
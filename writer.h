@@ -0,0 +1,109 @@
+#pragma once
+
+#include <locale.h>    // Requerido pela localidade numérica fixa do escritor (locale_t).
+#include <sys/time.h>  // Requerido pelos instantes dos processos (struct timeval).
+#include "pi.h"
+
+// Tamanho do buffer do escritor; o arquivo recebe um write() a cada buffer cheio e no fechamento.
+#define WRITER_BUFFER_SIZE 65536
+
+// Permissões do arquivo criado pelo escritor.
+#define WRITER_MODE 0644
+
+// Localidade dos números escritos: ponto decimal, sem separador de milhares.
+#define WRITER_LOCALE "C"
+
+// Separador decimal dos relatórios em texto quando a localidade LOCALE não está instalada.
+#define REPORT_DECIMAL_POINT COMMA
+
+// Tamanho máximo de uma especificação de conversão (por exemplo, "%-12.9lf") no formatador dos relatórios em texto.
+#define FORMAT_SPEC_SIZE 48
+
+// Partes de uma especificação de conversão entre o '%' e a conversão: flags e modificadores de tamanho.
+#define FORMAT_FLAGS "-+ #0'"
+#define FORMAT_MODIFIERS "hlLqjzt"
+
+// Registros do relatório estruturado em JSON (um objeto por linha).
+#define JSON_RUN "{\"record\":\"run\",\"run\":%lld,\"pid\":%d,\"series\":\"%s\",\"kernel\":\"%s\",\"summation\":\"%s\"," \
+                 "\"acceleration\":\"%s\",\"processes\":%u,\"threads\":%u,\"start\":%.6f,\"end\":%.6f,\"duration_s\":%.9f," \
+                 "\"terms\":%llu,\"terms_per_s\":%.6e,\"estimate\":%.17g,\"raw_estimate\":%.17g,\"error\":%.17g"
+#define JSON_BOUND ",\"bound\":%.17g,\"digits\":%u,\"guaranteed\":%s"
+#define JSON_PROCESS "{\"record\":\"process\",\"run\":%lld,\"process\":%d,\"pid\":%d,\"threads\":%u,\"start\":%.6f,\"end\":%.6f," \
+                     "\"duration_s\":%.9f,\"terms\":%llu,\"terms_per_s\":%.6e,\"sum\":%.17g}\n"
+#define JSON_THREAD "{\"record\":\"thread\",\"run\":%lld,\"process\":%d,\"tid\":%d,\"cpu\":%d,\"start\":%.6f,\"end\":%.6f," \
+                    "\"duration_s\":%.9f,\"cpu_s\":%.9f,\"terms\":%llu,\"terms_per_s\":%.6e,\"chunks\":%u,\"steals\":%u}\n"
+#define JSON_END "}\n"
+#define JSON_TRUE "true"
+#define JSON_FALSE "false"
+
+// Registros do relatório estruturado em CSV: uma tabela única, com as colunas que não se aplicam ao registro vazias.
+#define CSV_HEADER "record,run,process,pid,tid,threads,start,end,duration_s,cpu_s,terms,terms_per_s,sum,estimate,error\n"
+#define CSV_RUN "run,%lld,,%d,,%u,%.6f,%.6f,%.9f,,%llu,%.6e,,%.17g,%.17g\n"
+#define CSV_PROCESS "process,%lld,%d,%d,,%u,%.6f,%.6f,%.9f,,%llu,%.6e,%.17g,,\n"
+#define CSV_THREAD "thread,%lld,%d,,%d,,%.6f,%.6f,%.9f,%.9f,%llu,%.6e,,,\n"
+
+// Mensagens de erros.
+#define ERROR_WRITER "Erro no arquivo de relatório"
+
+// Escritor bufferizado: acumula o texto formatado e o envia ao arquivo em poucos write(), com os números na localidade
+// 'numeric': WRITER_LOCALE no relatório estruturado, independente da localidade do programa, e a localidade numérica
+// dos relatórios em texto (LOCALE, se instalada) nos relatórios em português. Sem LOCALE, os relatórios em texto usam
+// WRITER_LOCALE e trocam o ponto de cada número de ponto flutuante por REPORT_DECIMAL_POINT ('decimalComma').
+typedef struct {
+   int fd;
+   int ownsDescriptor;             // FALSE na saída padrão, que closeWriter não fecha.
+   ReportFormat format;            // Formato dos registros do relatório estruturado.
+   locale_t numeric;               // Localidade usada para formatar os números.
+   int decimalComma;               // TRUE se os números de ponto flutuante saem com REPORT_DECIMAL_POINT no lugar do ponto.
+   size_t capacity;                // Tamanho do buffer.
+   size_t length;                  // Bytes ocupados no buffer.
+   int failed;                     // TRUE depois de uma falha de escrita.
+   char buffer[];
+} Writer;
+
+/* Cria (ou trunca) o arquivo 'fileName' e retorna o seu escritor com registros no formato 'format',
+   ou NULL se ocorreu algum erro. No formato CSV, o cabeçalho 'header' (se não for NULL) é escrito primeiro.
+*/
+Writer* openWriter(const char *fileName, ReportFormat format, const char *header);
+
+/* Cria (ou trunca) o arquivo 'fileName', ou usa a saída padrão se 'fileName' é NULL, e retorna o escritor de um relatório
+   em texto com um buffer de 'capacity' bytes, ou NULL se ocorreu algum erro. Um relatório que cabe no buffer é enviado em
+   um único write() no fechamento; os números de ponto flutuante saem com o separador decimal de reportDecimalPoint().
+*/
+Writer* openTextWriter(const char *fileName, size_t capacity);
+
+/* Formata, como printf, o texto de 'format' no buffer de 'writer', esvaziando o buffer no arquivo quando ele enche. */
+void writerPrintf(Writer *writer, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+/* Esvazia o buffer de 'writer' no arquivo, fecha o arquivo (exceto a saída padrão) e libera o escritor.
+   Retorna TRUE se todo o texto foi escrito ou FALSE se ocorreu algum erro.
+*/
+int closeWriter(Writer *writer);
+
+/* Escreve em 'writer' o registro da execução 'run' com a configuração 'config', 'numberOfProcesses' processos (ou workers) com
+   'numberOfThreads' threads ao todo, o resultado 'result', os instantes 'start' e 'end' e a duração 'duration' medida com DURATION_CLOCK.
+   No modo de convergência incremental, 'stream' traz o limitante do erro e se as casas foram garantidas ('reached'); fora dele, 'stream' é NULL.
+*/
+void writeRunRecord(Writer *writer, long long run, const Config *config, unsigned int numberOfProcesses, unsigned int numberOfThreads,
+                    PiResult result, struct timeval start, struct timeval end, double duration, const struct Stream *stream, int reached);
+
+/* Escreve em 'writer' o registro do processo filho ou worker 'numberProcess' da execução 'run', com PID 'pid', 'numberOfThreads'
+   threads, os instantes 'start' e 'end', a duração 'duration', os termos 'terms' que somou e a sua soma parcial 'sum'.
+*/
+void writeProcessRecord(Writer *writer, long long run, int numberProcess, pid_t pid, unsigned int numberOfThreads,
+                        struct timeval start, struct timeval end, double duration, unsigned long long terms, double sum);
+
+/* Escreve em 'writer' um registro por thread do vetor 'threads', com 'numberOfThreads' elementos, do processo 'numberProcess' da execução 'run'. */
+void writeThreadRecords(Writer *writer, long long run, int numberProcess, const Thread *threads, unsigned int numberOfThreads);
+
+/* Retorna o separador decimal dos relatórios em texto: o da localidade LOCALE, ou REPORT_DECIMAL_POINT se ela não está instalada. */
+char reportDecimalPoint();
+
+/* Formata, como snprintf, o texto de 'format' em 'text', com no máximo 'size' bytes, na localidade numérica dos relatórios
+   em texto, de modo que os números de ponto flutuante saem com o separador decimal de reportDecimalPoint().
+   Retorna o tamanho do texto completo, mesmo que ele não caiba em 'text'.
+*/
+int formatReport(char *text, size_t size, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+/* Retorna o identificador de execução derivado do instante 'start': microssegundos desde a época. */
+long long runIdentifier(struct timeval start);